@@ -59,6 +59,68 @@
 
 stc_amx8x5_time_t stcSysTime;
 
+/**
+ ******************************************************************************
+ ** \brief Configuration bits covered by the warm boot fingerprint,
+ **        registers 0x10 (#AMX8X5_REG_CONTROL_1) .. 0x30 (#AMX8X5_REG_OCTRL)
+ **
+ ** Registers the driver rewrites at runtime are left out: calibration
+ ** (drift, temperature compensation), interrupt enables and timer
+ ** (software alarms, tickless idle, sequences).
+ **
+ ******************************************************************************/
+static const uint8_t au8FingerprintMask[AMX8X5_REG_OCTRL - AMX8X5_REG_CONTROL_1 + 1] = {
+    0xFE, // 0x10 CONTROL_1 without WRTC
+    0xFF, // 0x11 CONTROL_2
+    0xE0, // 0x12 INT_MASK CEB, IM
+    0xFF, // 0x13 SQW
+    0x00, // 0x14 CAL_XT
+    0x00, // 0x15 CAL_RC_HI
+    0x00, // 0x16 CAL_RC_LOW
+    0x77, // 0x17 SLEEP_CTRL without SLP, SLST
+    0x00, // 0x18 TIMER_CTRL
+    0x00, // 0x19 TIMER (counter)
+    0x00, // 0x1A TIMER_INITIAL
+    0xFF, // 0x1B WDT
+    0xFF, // 0x1C OSC_CONTROL
+    0xE0, // 0x1D OSC_STATUS XTCAL, LKO2
+    0x00, // 0x1E reserved
+    0x00, // 0x1F CONFIG_KEY
+    0xFF, // 0x20 TRICKLE
+    0xFF, // 0x21 BREF_CTRL
+    0x00, // 0x22 reserved
+    0x00, // 0x23 reserved
+    0x00, // 0x24 reserved
+    0x00, // 0x25 reserved
+    0x00, // 0x26 AFCTRL
+    0x80, // 0x27 BATMODE_IO
+    0xFF, // 0x28 ID0
+    0xFF, // 0x29 ID1
+    0x00, // 0x2A ID2
+    0x00, // 0x2B ID3
+    0x00, // 0x2C ID4
+    0x00, // 0x2D ID5
+    0x00, // 0x2E ID6
+    0x00, // 0x2F ASTAT
+    0xFF  // 0x30 OCTRL
+};
+
+/**
+ ******************************************************************************
+ ** \brief Days of a non leap year before the first of a month
+ **
+ ******************************************************************************/
+static const uint16_t au16DaysBeforeMonth[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+/**
+ ******************************************************************************
+ ** \brief BREF thresholds, ascending, see #en_amx8x5_bat_reference_t
+ **
+ ******************************************************************************/
+static const uint8_t au8BatteryBref[AMX8X5_BATTERY_LEVELS] = {0xF0, 0xD0, 0xB0, 0x70};
+static const uint16_t au16BatteryFallingMv[AMX8X5_BATTERY_LEVELS] = {1400, 1800, 2100, 2500};
+static const uint16_t au16BatteryRisingMv[AMX8X5_BATTERY_LEVELS] = {1600, 2200, 2500, 3000};
+
 #if AMX8X5_DEBUG == 1
 static volatile uint32_t u32DgbLevel = 0;
 static const char* astrRegNames[] = {
@@ -117,6 +179,12 @@ static const char* astrRegNames[] = {
 /* Local function prototypes ('static')                                      */
 /*****************************************************************************/
 
+static en_result_t Amx8x5_CheckId(stc_amx8x5_handle_t* pstcHandle, uint16_t u16Id);
+static uint16_t Amx8x5_ConfigFingerprint(uint8_t* pu8Config);
+static en_result_t Amx8x5_ReadConfig(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, uint8_t* pu8Config);
+static void Amx8x5_CountdownEncode(en_amx8x5_calibration_mode_t enOMODE, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin, int32_t* piTimer, uint8_t* pu8TimerCtrl);
+static en_result_t Amx8x5_SetCountdownPin(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_countdown_interrupt_pin_t enPin);
+
 #if AMX8X5_DEBUG == 1
 static void AMX8X5_DEBUG_FUNC_START(const char* name);
 static en_result_t AMX8X5_FUNC_END(en_result_t enErrCode);
@@ -588,6 +656,50 @@ en_result_t Amx8x5_WriteByte(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Register
 }
 
 
+/**
+ ******************************************************************************
+ ** \brief  Check the ID register value against the configured RTC type
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u16Id          ID1 (upper byte) and ID0 (lower byte)
+ **
+ ** \return Ok on match, ErrorInvalidMode on mismatch, Error for unknown types
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_CheckId(stc_amx8x5_handle_t* pstcHandle, uint16_t u16Id)
+{
+    switch(pstcHandle->enRtcType)
+    {
+      case AMx8x5Type0805:
+          if (u16Id == 0x0508)
+          {
+              return Ok;
+          }
+          return ErrorInvalidMode;
+      case AMx8x5Type0815:
+          if (u16Id == 0x1508)
+          {
+              return Ok;
+          }
+          return ErrorInvalidMode;
+      case AMx8x5Type1805:
+          if (u16Id == 0x0518)
+          {
+              return Ok;
+          }
+          return ErrorInvalidMode;
+      case AMx8x5Type1815:
+          if (u16Id == 0x1518)
+          {
+              return Ok;
+          }
+          return ErrorInvalidMode;
+      default:
+        return Error;
+    }
+}
+
 /**
  ******************************************************************************
  ** \brief  This function is reset the RTC
@@ -668,35 +780,74 @@ en_result_t Amx8x5_Init(stc_amx8x5_handle_t* pstcHandle)
     if (res != Ok) {
         return AMX8X5_FUNC_END(res);
     }
-    switch(pstcHandle->enRtcType)
+    return AMX8X5_FUNC_END(Amx8x5_CheckId(pstcHandle,(uint16_t)(u32Temp & 0xFFFF)));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Decode the counter registers HUNDREDTHS..WEEKDAYS into stcSysTime
+ **
+ ** Reads CONTROL_1 for the 12/24 hour mode and STATUS for the century.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pu8Buffer      8 bytes read from HUNDREDTHS
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_RegistersToTime(stc_amx8x5_handle_t* pstcHandle, uint8_t* pu8Buffer)
+{
+    uint8_t u8Temp;
+    en_result_t res;
+    
+    stcSysTime.u8Hundredth = AMX8X5_BCD_TO_DEC(pu8Buffer[0]);
+    stcSysTime.u8Second = AMX8X5_BCD_TO_DEC(pu8Buffer[1]);
+    stcSysTime.u8Minute = AMX8X5_BCD_TO_DEC(pu8Buffer[2]);
+    stcSysTime.u8Hour = pu8Buffer[3];
+    stcSysTime.u8Date = AMX8X5_BCD_TO_DEC(pu8Buffer[4]);
+    stcSysTime.u8Month = AMX8X5_BCD_TO_DEC(pu8Buffer[5]);
+    stcSysTime.u8Year = AMX8X5_BCD_TO_DEC(pu8Buffer[6]);
+    stcSysTime.u8Weekday = AMX8X5_BCD_TO_DEC(pu8Buffer[7]);
+    
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_CONTROL_1,&u8Temp);
+    if (res != Ok) 
     {
-      case AMx8x5Type0805:
-          if ((u32Temp & 0xFFFF) == 0x000508)
-          {
-              return AMX8X5_FUNC_END(Ok);
-          }
-          return AMX8X5_FUNC_END(ErrorInvalidMode);
-      case AMx8x5Type0815:
-          if ((u32Temp & 0xFFFF) == 0x001508)
-          {
-              return AMX8X5_FUNC_END(Ok);
-          }
-          return AMX8X5_FUNC_END(ErrorInvalidMode);
-      case AMx8x5Type1805:
-          if ((u32Temp & 0xFFFF) == 0x000518)
-          {
-              return AMX8X5_FUNC_END(Ok);
-          }
-          return AMX8X5_FUNC_END(ErrorInvalidMode);
-      case AMx8x5Type1815:
-          if ((u32Temp & 0xFFFF) == 0x001518)
-          {
-              return AMX8X5_FUNC_END(Ok);
-          }
-          return AMX8X5_FUNC_END(ErrorInvalidMode);
-      default:
-        return AMX8X5_FUNC_END(Error);
+        return res;
+    }
+    
+    if ((u8Temp & 0x40) == 0)
+    {
+        //
+        // 24-hour mode.
+        //
+        stcSysTime.u8Mode = 2;
+        stcSysTime.u8Hour =stcSysTime.u8Hour & 0x3F;
+    }
+    else
+    {
+        //
+        // 12-hour mode.  Get PM:AM.
+        //
+
+        stcSysTime.u8Mode = (stcSysTime.u8Hour & 0x20) ? 1 : 0;
+        stcSysTime.u8Hour &= 0x1F;
+    }
+    
+    stcSysTime.u8Hour = AMX8X5_BCD_TO_DEC(stcSysTime.u8Hour );
+
+    //
+    // Get the century bit.
+    //
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_STATUS,&u8Temp);
+    if (res != Ok) 
+    {
+        return res;
     }
+    
+    stcSysTime.u8Century = (u8Temp & AMX8X5_REG_STATUS_CB_MSK) ? 1 : 0;
+    
+    return Ok;
 }
 
 /**
@@ -721,7 +872,6 @@ en_result_t Amx8x5_Init(stc_amx8x5_handle_t* pstcHandle)
  ******************************************************************************/
 en_result_t Amx8x5_GetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t** ppstcTime)
 {
-    uint8_t u8Temp;
     en_result_t res;
     uint32_t au32Buffer[3] = {0,0,0};
     uint8_t* pu8Buffer = (uint8_t*)&au32Buffer[0];
@@ -739,54 +889,118 @@ en_result_t Amx8x5_GetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t**
         return AMX8X5_FUNC_END(res);
     }
     
-    stcSysTime.u8Hundredth = AMX8X5_BCD_TO_DEC(pu8Buffer[0]);
-    stcSysTime.u8Second = AMX8X5_BCD_TO_DEC(pu8Buffer[1]);
-    stcSysTime.u8Minute = AMX8X5_BCD_TO_DEC(pu8Buffer[2]);
-    stcSysTime.u8Hour = pu8Buffer[3];
-    stcSysTime.u8Date = AMX8X5_BCD_TO_DEC(pu8Buffer[4]);
-    stcSysTime.u8Month = AMX8X5_BCD_TO_DEC(pu8Buffer[5]);
-    stcSysTime.u8Year = AMX8X5_BCD_TO_DEC(pu8Buffer[6]);
-    stcSysTime.u8Weekday = AMX8X5_BCD_TO_DEC(pu8Buffer[7]);
+    res = Amx8x5_RegistersToTime(pstcHandle,pu8Buffer);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
     
-    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_CONTROL_1,&u8Temp);
+    if (ppstcTime != NULL) *ppstcTime = &stcSysTime;
+    
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Get the time of the RTC together with the matching host time
+ **
+ ** The counters are read in one burst starting at HUNDREDTHS, which latches
+ ** all counters for the transfer, bracketed by two pfnMicros() samples.
+ ** pstcPreciseTime->u32HostUs is the host time at which the RTC showed
+ ** exactly pstcPreciseTime->stcTime, within +/- u32UncertaintyUs.
+ **
+ ** A single read leaves the 10 ms resolution of the hundredths in the
+ ** bound. With bWaitEdge the burst is repeated until the hundredths
+ ** change, the bound then is about one burst transfer. This polls the bus for
+ ** up to #AMX8X5_PRECISE_EDGE_TIMEOUT_US.
+ **
+ ** \param  pstcHandle       RTC Handle
+ **
+ ** \param  pstcPreciseTime  Returns time, host time and uncertainty
+ **
+ ** \param  pfnMicros        Host clock in us, e.g. micros()
+ **
+ ** \param  bWaitEdge        true to wait for the next hundredth edge
+ **
+ ** \return Ok on success, ErrorTimeout if the hundredths did not change,
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_GetTimePrecise(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_precise_t* pstcPreciseTime, pfn_amx8x5_micros pfnMicros, bool bWaitEdge)
+{
+    uint32_t u32Start;
+    uint32_t u32Before;
+    uint32_t u32After;
+    uint32_t u32Edge = 0;
+    uint8_t u8Hundredths;
+    uint32_t au32Buffer[2];
+    uint8_t* pu8Buffer = (uint8_t*)&au32Buffer[0];
+    en_result_t res;
+    
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_GetTimePrecise");
+    
+    if (pstcHandle == NULL) 
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    
+    if ((pstcPreciseTime == NULL) || (pfnMicros == NULL))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    
+    u32Start = pfnMicros();
+    u32Before = u32Start;
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,pu8Buffer,8);
+    u32After = pfnMicros();
     if (res != Ok) 
     {
         return AMX8X5_FUNC_END(res);
     }
     
-    if ((u8Temp & 0x40) == 0)
+    if (false == bWaitEdge)
     {
         //
-        // 24-hour mode.
+        // Latched somewhere in [u32Before, u32After], showing a value
+        // reached up to 10 ms earlier.
         //
-        stcSysTime.u8Mode = 2;
-        stcSysTime.u8Hour =stcSysTime.u8Hour & 0x3F;
+        pstcPreciseTime->u32UncertaintyUs = (u32After - u32Before + 1) / 2 + 5000;
+        pstcPreciseTime->u32HostUs = u32Before + (u32After - u32Before) / 2 - 5000;
     }
     else
     {
+        u8Hundredths = pu8Buffer[0];
+        while(pu8Buffer[0] == u8Hundredths)
+        {
+            if ((u32After - u32Start) > AMX8X5_PRECISE_EDGE_TIMEOUT_US)
+            {
+                return AMX8X5_FUNC_END(ErrorTimeout);
+            }
+            u32Edge = u32Before;
+            u32Before = u32After;
+            res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,pu8Buffer,8);
+            u32After = pfnMicros();
+            if (res != Ok) 
+            {
+                return AMX8X5_FUNC_END(res);
+            }
+        }
+        
         //
-        // 12-hour mode.  Get PM:AM.
+        // The edge lies between the latch of the previous burst (after
+        // u32Edge) and the latch of this one (before u32After).
         //
-
-        stcSysTime.u8Mode = (stcSysTime.u8Hour & 0x20) ? 1 : 0;
-        stcSysTime.u8Hour &= 0x1F;
+        pstcPreciseTime->u32UncertaintyUs = (u32After - u32Edge + 1) / 2;
+        pstcPreciseTime->u32HostUs = u32Edge + (u32After - u32Edge) / 2;
     }
     
-    stcSysTime.u8Hour = AMX8X5_BCD_TO_DEC(stcSysTime.u8Hour );
-
-    //
-    // Get the century bit.
-    //
-    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_STATUS,&u8Temp);
+    res = Amx8x5_RegistersToTime(pstcHandle,pu8Buffer);
     if (res != Ok) 
     {
         return AMX8X5_FUNC_END(res);
     }
     
-    stcSysTime.u8Century = (u8Temp & AMX8X5_REG_STATUS_CB_MSK) ? 1 : 0;
-    
-    if (ppstcTime != NULL) *ppstcTime = &stcSysTime;
-    
+    memcpy(&pstcPreciseTime->stcTime,&stcSysTime,sizeof(stcSysTime));
     return AMX8X5_FUNC_END(Ok);
 }
 
@@ -1004,6 +1218,43 @@ int16_t Amx8x5_GetCentury(stc_amx8x5_handle_t* pstcHandle)
     return(u8Temp & AMX8X5_REG_STATUS_CB_MSK) ? 1 : 0;
 }
 
+/**
+ ******************************************************************************
+ ** \brief  Encode a time into the counter registers HUNDREDTHS..WEEKDAYS
+ **
+ ** \param  pstcTime       Time to encode
+ **
+ ** \param  pu8Buffer      8 bytes, receives the BCD counter values incl. PM
+ **
+ ** \return value of the 12/24 bit in CONTROL_1 for the mode of pstcTime
+ **
+ ******************************************************************************/
+static uint8_t Amx8x5_TimeToRegisters(stc_amx8x5_time_t* pstcTime, uint8_t* pu8Buffer)
+{
+    pu8Buffer[0] = AMX8X5_DEC_TO_BCD(pstcTime->u8Hundredth);
+    pu8Buffer[1] = AMX8X5_DEC_TO_BCD(pstcTime->u8Second);
+    pu8Buffer[2] = AMX8X5_DEC_TO_BCD(pstcTime->u8Minute);
+    pu8Buffer[3] = AMX8X5_DEC_TO_BCD(pstcTime->u8Hour);
+    pu8Buffer[4] = AMX8X5_DEC_TO_BCD(pstcTime->u8Date);
+    pu8Buffer[5] = AMX8X5_DEC_TO_BCD(pstcTime->u8Month);
+    pu8Buffer[6] = AMX8X5_DEC_TO_BCD(pstcTime->u8Year);
+    pu8Buffer[7] = AMX8X5_DEC_TO_BCD(pstcTime->u8Weekday);
+    
+    if (pstcTime->u8Mode == AMX8X5_24HR_MODE)
+    {
+        return 0;
+    }
+    
+    //
+    // 12-hour day, set AM/PM.
+    //
+    if (pstcTime->u8Mode == AMX8X5_12HR_MODE)
+    {
+        pu8Buffer[3] |= 0x20;
+    }
+    return AMX8X5_REG_CONTROL_1_12_24_MSK;
+}
+
 /**
  ******************************************************************************
  ** \brief  This function is setting the time of the RTC
@@ -1038,15 +1289,7 @@ en_result_t Amx8x5_SetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* p
     
     AMX8X5_DEBUG_PRINTF("[f] Amx8x5_SetTime\r\n");
     
-    pu8Buffer[0] = AMX8X5_DEC_TO_BCD(pstcTime->u8Hundredth);
-    pu8Buffer[1] = AMX8X5_DEC_TO_BCD(pstcTime->u8Second);
-    pu8Buffer[2] = AMX8X5_DEC_TO_BCD(pstcTime->u8Minute);
-    pu8Buffer[3] = AMX8X5_DEC_TO_BCD(pstcTime->u8Hour);
-    pu8Buffer[4] = AMX8X5_DEC_TO_BCD(pstcTime->u8Date);
-    pu8Buffer[5] = AMX8X5_DEC_TO_BCD(pstcTime->u8Month);
-    pu8Buffer[6] = AMX8X5_DEC_TO_BCD(pstcTime->u8Year);
-    pu8Buffer[7] = AMX8X5_DEC_TO_BCD(pstcTime->u8Weekday);
-    
+    Amx8x5_TimeToRegisters(pstcTime,pu8Buffer);
     
     //
     // Determine whether 12 or 24-hour timekeeping mode is being used and set
@@ -1067,10 +1310,6 @@ en_result_t Amx8x5_SetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* p
     //
     else if (pstcTime->u8Mode == AMX8X5_12HR_MODE)
     {
-        //
-        // Set AM/PM.
-        //
-        pu8Buffer[3] |= 0x20;
         res = Amx8x5_SetRegister(pstcHandle, AMX8X5_REG_CONTROL_1, AMX8X5_REG_CONTROL_1_12_24_MSK);
         if (res != Ok) 
         {
@@ -1153,62 +1392,170 @@ en_result_t Amx8x5_SetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* p
 
 /**
  ******************************************************************************
- ** \brief  Set the alarm value
+ ** \brief  Set the time of the RTC aligned to a reference second edge
  **
- ** This function sets the alarm value and configures the correct pin (if
- ** necessary).
+ ** The counters are held with the STOP bit while the new time is written,
+ ** then pfnWaitEdge() is called and blocks until the reference edge (e.g. a
+ ** GPS PPS interrupt or the host clock rolling over to the next second).
+ ** Directly after it returns a single CONTROL_1 write releases the counters,
+ ** so the alignment error is the duration of this one bus write instead of
+ ** the up to 10 ms of an unaligned Amx8x5_SetTime().
+ **
+ ** The divider chain below 100 Hz is held in reset while STOP is set, so the
+ ** first hundredth elapses 10 ms after the release.
  **
  ** \param  pstcHandle     RTC Handle
  **
- ** \param  pstcTime       Time
+ ** \param  pstcTime       Time valid at the reference edge, usually with
+ **                        u8Hundredth 0
  **
- ** \param enModeRepeat   Repeat mode as defined in #en_amx8x5_alarm_repeat_t
- **        AMx8x5AlarmDisabled => disable alarm
- **        AMx8x5AlarmYear => once per year
- **        AMx8x5AlarmMonth => once per month
- **        AMx8x5AlarmWeek => once per week
- **        AMx8x5AlarmDay => once per day
- **        AMx8x5AlarmHour => once per hour
- **        AMx8x5AlarmMinute => once per minute
- **        AMx8x5AlarmSecond => once per second
- **        AMx8x5Alarm10thSecond => once per 10th of a second
- **        AMx8x5Alarm100thSecond => once per 100th of a second
- **        NOTE: year and century are not used
- **        NOTE: mode must match current 12/24 selection
+ ** \param  bProtect       false to leave counters writable, true to leave counters unwritable
  **
- ** \param enModeIrq       Interrupt mode as defined in #en_amx8x5_interrupt_mode_t
- **        AMx8x5InterruptModeLevel => Level (static) for both XT mode and RC mode.
- **        AMx8x5InterruptModePulseShort => 1/8192 seconds pulse for XT mode. 1/64 seconds for RC mode.
- **        AMx8x5InterruptModePulseMedium => 1/64 seconds pulse for both XT mode and RC mode
- **        AMx8x5InterruptModePulseLong => 1/4 seconds pulse for both XT mode and RC mode.
+ ** \param  pfnWaitEdge    Blocks until the reference edge
  **
- ** \param enModePin pin on which to generate the interrupt as defined in #en_amx8x5_interrupt_pin_t
- **        AMx8x5InterruptPinInternal => internal flag only
- **        AMx8x5InterruptIrq => FOUT/nIRQ
- **        AMx8x5InterruptIrq2 => PSW/nIRQ2
+ ** \param  pfnMicros      Host clock in us to measure the transport latency,
+ **                        may be NULL
+ **
+ ** \param  pu32LatencyUs  Returns the measured duration of a single byte
+ **                        transfer, the expected lag of the release, may be NULL
  **
  ** \return Ok on success, else the Error as en_result_t
- ** 
+ **
+ ** Example:
+ ** @code
+ ** static volatile bool bPps;
+ ** static void WaitPps(stc_amx8x5_handle_t* pstcHandle)
+ ** {
+ **     bPps = false;
+ **     while(!bPps);         // set by the PPS pin interrupt
+ ** }
+ **
+ ** // stcGpsTime is the UTC time of the next PPS pulse
+ ** Amx8x5_SetTimePrecise(&stcRtcConfig,&stcGpsTime,true,WaitPps,micros,NULL);
+ ** @endcode
+ **
  ******************************************************************************/
-en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin)
+en_result_t Amx8x5_SetTimePrecise(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, bool bProtect, pfn_amx8x5_wait_edge pfnWaitEdge, pfn_amx8x5_micros pfnMicros, uint32_t* pu32LatencyUs)
 {
-    uint8_t u8Temp;
+    uint8_t u8Hold;
+    uint8_t u8Release;
+    uint32_t u32Start = 0;
+    uint32_t u32Latency = 0;
+    uint32_t u32Hundredths;
     uint32_t au32Buffer[2];
     uint8_t* pu8Buffer = (uint8_t*)&au32Buffer[0];
     en_result_t res;
     
-    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetAlarm");
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetTimePrecise");
     
     if (pstcHandle == NULL) 
     {
         return AMX8X5_FUNC_END(ErrorUninitialized);
     }
     
-    if (pstcTime == NULL) 
+    if ((pstcTime == NULL) || (pfnWaitEdge == NULL))
     {
         return AMX8X5_FUNC_END(ErrorInvalidParameter);
     }
     
+    //
+    // The CONTROL_1 read is needed anyway, time it as a sample of the
+    // single byte release write.
+    //
+    if (pfnMicros != NULL)
+    {
+        u32Start = pfnMicros();
+    }
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_CONTROL_1,&u8Hold);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (pfnMicros != NULL)
+    {
+        u32Latency = pfnMicros() - u32Start;
+    }
+    
+    u8Hold &= ~AMX8X5_REG_CONTROL_1_12_24_MSK;
+    u8Hold |= Amx8x5_TimeToRegisters(pstcTime,pu8Buffer);
+    u8Hold |= AMX8X5_REG_CONTROL_1_STOP_MSK | AMX8X5_REG_CONTROL_1_WRTC_MSK;
+    
+    u8Release = (uint8_t)(u8Hold & ~(AMX8X5_REG_CONTROL_1_STOP_MSK | AMX8X5_REG_CONTROL_1_WRTC_MSK));
+    if (false == bProtect)
+    {
+         u8Release |= AMX8X5_REG_CONTROL_1_WRTC_MSK;
+    }
+    
+    //
+    // The counters start late by the release write, compensate in whole
+    // hundredths as far as possible without a carry into the seconds.
+    //
+    u32Hundredths = pstcTime->u8Hundredth + ((u32Latency + 5000) / 10000);
+    if (u32Hundredths <= 99)
+    {
+        pu8Buffer[0] = AMX8X5_DEC_TO_BCD(u32Hundredths);
+    }
+    
+    //
+    // Hold the counters and enable counter writes with a single write.
+    //
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONTROL_1,u8Hold);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    
+    if (pstcTime->u8Century == 0)
+    {
+        res = Amx8x5_ClearRegister(pstcHandle, AMX8X5_REG_STATUS, AMX8X5_REG_STATUS_CB_MSK);
+    }
+    else
+    {
+        res = Amx8x5_SetRegister(pstcHandle, AMX8X5_REG_STATUS, AMX8X5_REG_STATUS_CB_MSK);
+    }
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,pu8Buffer,8);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    
+    pfnWaitEdge(pstcHandle);
+    
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONTROL_1,u8Release);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    
+    if (pu32LatencyUs != NULL) *pu32LatencyUs = u32Latency;
+    
+    memcpy(&stcSysTime,pstcTime,sizeof(stcSysTime));
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Encode an alarm time into the alarm registers
+ **
+ ** Tenths and hundredths repeats are expressed by the ALARM_HUNDRS pattern
+ ** (0xF0 + digit, 0xFF) with the RPT value of once per second.
+ **
+ ** \param  pstcTime       Time, see Amx8x5_SetAlarm()
+ **
+ ** \param  enModeRepeat   Repeat mode as defined in #en_amx8x5_alarm_repeat_t
+ **
+ ** \param  pu8Buffer      7 bytes, returns ALARM_HUNDRS..ALARM_WEEKDAY
+ **
+ ** \return Repeat mode written to the RPT field
+ **
+ ******************************************************************************/
+static en_amx8x5_alarm_repeat_t Amx8x5_AlarmEncode(const stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, uint8_t* pu8Buffer)
+{
     pu8Buffer[0] = AMX8X5_DEC_TO_BCD(pstcTime->u8Hundredth);
     pu8Buffer[1] = AMX8X5_DEC_TO_BCD(pstcTime->u8Second);
     pu8Buffer[2] = AMX8X5_DEC_TO_BCD(pstcTime->u8Minute);
@@ -1228,6 +1575,87 @@ en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t*
         //
         pu8Buffer[3] |= 0x20;
     }
+
+    if (enModeRepeat == AMx8x5Alarm10thSecond)
+    {
+        //
+        // 10ths interrupt.
+        // Select correct RPT value.
+        //
+        pu8Buffer[0] |= 0xF0;
+        enModeRepeat = AMx8x5AlarmSecond;
+    }
+    if (enModeRepeat == AMx8x5Alarm100thSecond)
+    {
+        //
+        // 100ths interrupt.
+        // Select correct RPT value.
+        //
+        pu8Buffer[0] = 0xFF;
+        enModeRepeat = AMx8x5AlarmSecond;
+    }
+    return enModeRepeat;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Set the alarm value
+ **
+ ** This function sets the alarm value and configures the correct pin (if
+ ** necessary).
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcTime       Time
+ **
+ ** \param enModeRepeat   Repeat mode as defined in #en_amx8x5_alarm_repeat_t
+ **        AMx8x5AlarmDisabled => disable alarm
+ **        AMx8x5AlarmYear => once per year
+ **        AMx8x5AlarmMonth => once per month
+ **        AMx8x5AlarmWeek => once per week
+ **        AMx8x5AlarmDay => once per day
+ **        AMx8x5AlarmHour => once per hour
+ **        AMx8x5AlarmMinute => once per minute
+ **        AMx8x5AlarmSecond => once per second
+ **        AMx8x5Alarm10thSecond => once per 10th of a second
+ **        AMx8x5Alarm100thSecond => once per 100th of a second
+ **        NOTE: year and century are not used
+ **        NOTE: mode must match current 12/24 selection
+ **
+ ** \param enModeIrq       Interrupt mode as defined in #en_amx8x5_interrupt_mode_t
+ **        AMx8x5InterruptModeLevel => Level (static) for both XT mode and RC mode.
+ **        AMx8x5InterruptModePulseShort => 1/8192 seconds pulse for XT mode. 1/64 seconds for RC mode.
+ **        AMx8x5InterruptModePulseMedium => 1/64 seconds pulse for both XT mode and RC mode
+ **        AMx8x5InterruptModePulseLong => 1/4 seconds pulse for both XT mode and RC mode.
+ **
+ ** \param enModePin pin on which to generate the interrupt as defined in #en_amx8x5_interrupt_pin_t
+ **        AMx8x5InterruptPinInternal => internal flag only
+ **        AMx8x5InterruptIrq => FOUT/nIRQ
+ **        AMx8x5InterruptIrq2 => PSW/nIRQ2
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ ** 
+ ******************************************************************************/
+en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin)
+{
+    uint8_t u8Temp;
+    uint32_t au32Buffer[2];
+    uint8_t* pu8Buffer = (uint8_t*)&au32Buffer[0];
+    en_result_t res;
+    
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetAlarm");
+    
+    if (pstcHandle == NULL) 
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    
+    if (pstcTime == NULL) 
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    
+    enModeRepeat = Amx8x5_AlarmEncode(pstcTime,enModeRepeat,pu8Buffer);
     
     //
     // Clear the RPT field.
@@ -1254,6 +1682,8 @@ en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t*
     
     switch(enModePin)
     {
+            case AMx8x5InterruptPinInternal:
+                break;
             case AMx8x5InterruptIrq:
                 //
                 // Interrupt on FOUT/nIRQ.
@@ -1318,25 +1748,6 @@ en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t*
         return AMX8X5_FUNC_END(ErrorInvalidParameter);
         
     }
-    if (enModeRepeat == AMx8x5Alarm10thSecond)
-    {
-        //
-        // 10ths interrupt.
-        // Select correct RPT value.
-        //
-        pu8Buffer[0] |= 0xF0;
-        enModeRepeat = AMx8x5AlarmSecond;
-    }
-    if (enModeRepeat == AMx8x5Alarm100thSecond)
-    {
-        //
-        // 100ths interrupt.
-        // Select correct RPT value.
-        //
-        pu8Buffer[0] = 0xFF;
-        enModeRepeat = AMx8x5AlarmSecond;
-    }
-    
     //
     // Don't initiate if enModeRepeat is AMx8x5AlarmDisabled.
     //
@@ -1353,6 +1764,8 @@ en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t*
         
         switch(enModeIrq)
         {
+            case AMx8x5InterruptModeLevel:
+                break;
             case AMx8x5InterruptModePulseShort:
                res = Amx8x5_SetRegister(pstcHandle, AMX8X5_REG_INT_MASK, (0x01 << AMX8X5_REG_INT_MASK_IM_POS));
                 if (res != Ok)
@@ -1461,238 +1874,384 @@ en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t*
 
 /**
  ******************************************************************************
- ** \brief  Set the calibration.
+ ** \brief  Forget the alarm configuration, the next rearm is a full one
  **
- ** This function loads the AMX8XX counter registers with the last read
- ** values of Amx8x5_GetTime()
+ ** \param  pstcConfig     Configuration, see #stc_amx8x5_alarm_config_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_AlarmInit(stc_amx8x5_alarm_config_t* pstcConfig)
+{
+    if (pstcConfig == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcConfig,0,sizeof(stc_amx8x5_alarm_config_t));
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Set the alarm, writing only the alarm time if nothing else changed
+ **
+ ** The first call and every call with a different repeat, interrupt mode
+ ** or pin run Amx8x5_SetAlarm() and remember the configuration. Otherwise
+ ** ALM is cleared and ALARM_HUNDRS..ALARM_WEEKDAY are written in one burst,
+ ** INT_MASK, CONTROL_2 and TIMER_CTRL are not touched. Call
+ ** Amx8x5_AlarmInit() after changing those registers by other means.
+ ** AMx8x5AlarmDisabled always takes the full path and is not remembered.
  **
  ** \param  pstcHandle     RTC Handle
  **
- ** \param  enMode         AMx8x5ModeCalibrateXT calibrate the XT oscillator or AMx8x5ModeCalibrateRC calibrate the RC oscillator
+ ** \param  pstcConfig     Configuration of the last full call, see #stc_amx8x5_alarm_config_t
  **
- ** \param   iAdjust: Adjustment in ppm. 
- **          Adjustment limits are:
- **              enMode = AMx8x5ModeCalibrateXT => (-610 to +242)
- **              enMode = AMx8x5ModeCalibrateRC => (-65536 to +65520)
- **              An iAdjust value of zero resets the selected oscillator calibration
- **              value to 0.
+ ** \param  pstcTime       Time, see Amx8x5_SetAlarm()
+ **
+ ** \param  enModeRepeat   Repeat mode as defined in #en_amx8x5_alarm_repeat_t
+ **
+ ** \param  enModeIrq      Interrupt mode as defined in #en_amx8x5_interrupt_mode_t
+ **
+ ** \param  enModePin      Interrupt pin as defined in #en_amx8x5_interrupt_pin_t
  **
  ** \return Ok on success, else the Error as en_result_t
- ** 
- ** Example:
- ** @code
- ** enMode(&stcRtcConfig,AMx8x5ModeCalibrateXT,5);
- ** @endcode
  **
  ******************************************************************************/
-en_result_t Amx8x5_SetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_calibration_mode_t enMode, int32_t iAdjust)
+en_result_t Amx8x5_AlarmRearm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_alarm_config_t* pstcConfig, stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin)
 {
+    uint8_t au8Alarm[AMX8X5_REG_ALARM_WEEKDAY - AMX8X5_REG_ALARM_HUNDRS + 1];
     en_result_t res;
-    int32_t iAdjint;
-    uint8_t u8Adjreg;
-    uint8_t u8Adjregu;
-    uint8_t u8XTcal;
 
-    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetCalibrationValue");
-    
-    //
-    // Calculate current calibration value:
-    //    adjval = (double)iAdjust;
-    //    iAdjint = (int16_t)round(adjval*1000/1907)
-    //
-    if (iAdjust < 0 )
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_AlarmRearm");
+
+    if (pstcHandle == NULL)
     {
-        iAdjint = ((iAdjust)*1000 - 953);
+        return AMX8X5_FUNC_END(ErrorUninitialized);
     }
-    else
+    if ((pstcConfig == NULL) || (pstcTime == NULL))
     {
-        iAdjint = ((iAdjust)*1000 + 953);
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
     }
-    iAdjint = iAdjint / 1907;
 
-    if (enMode == AMx8x5ModeCalibrateXT)
+    if ((!pstcConfig->bValid) || (enModeRepeat == AMx8x5AlarmDisabled) || (enModeRepeat != pstcConfig->enModeRepeat) ||
+        (enModeIrq != pstcConfig->enModeIrq) || (enModePin != pstcConfig->enModePin))
     {
-        //
-        // XT Adjust
-        //
-        if (iAdjint > 63 )
-        {
-            //
-            // 64 to 127.
-            // CMDX = 1.
-            //
-            u8XTcal = 0;
-            u8Adjreg = ((iAdjint >> 1) & 0x3F) | 0x80;
-        }
-        else if (iAdjint > -65)
-        {
-            //
-            // -64 to 63.
-            // CMDX = 0.
-            //
-            u8XTcal = 0;
-            u8Adjreg = (iAdjint & 0x7F);
-        }
-        else if (iAdjint > -129)
-        {
-            //
-            // -128 to -65.
-            // CMDX = 0.
-            //
-            u8XTcal = 1;
-            u8Adjreg = ((iAdjint + 64) & 0x7F);
-        }
-        else if (iAdjint > -193)
-        {
-            //
-            // -192 to -129.
-            // CMDX = 0.
-            //
-            u8XTcal = 2;
-            u8Adjreg = ((iAdjint + 128) & 0x7F);
-        }
-        else if (iAdjint > -257)
+        pstcConfig->bValid = false;
+        res = Amx8x5_SetAlarm(pstcHandle,pstcTime,enModeRepeat,enModeIrq,enModePin);
+        if (res != Ok)
         {
-            //
-            // -256 to -193.
-            // CMDX = 0.
-            //
-            u8XTcal = 3;
-            u8Adjreg = ((iAdjint + 192) & 0x7F);
+            return AMX8X5_FUNC_END(res);
         }
-        else
-        {
-            //
-            // -320 to -257.
-            // CMDX = 1.
+        pstcConfig->enModeRepeat = enModeRepeat;
+        pstcConfig->enModeIrq = enModeIrq;
+        pstcConfig->enModePin = enModePin;
+        pstcConfig->bValid = (enModeRepeat != AMx8x5AlarmDisabled);
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    //
+    // ALM first as in Amx8x5_SetAlarm(), a match of the new time stays pending.
+    //
+    (void)Amx8x5_AlarmEncode(pstcTime,enModeRepeat,au8Alarm);
+    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_ALM_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_ALARM_HUNDRS,au8Alarm,sizeof(au8Alarm));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Encode a calibration adjustment into the calibration registers
+ **
+ ** The adjustment is rounded to steps of 1.907 ppm, the division by 1907
+ ** is done as multiplication with its reciprocal and a shift (exact for
+ ** the full range), the band selection uses shifts only.
+ **
+ ** \param  enMode         AMx8x5ModeCalibrateXT or AMx8x5ModeCalibrateRC
+ **
+ ** \param  iAdjust        Adjustment in ppm, see Amx8x5_SetCalibrationValue()
+ **
+ ** \param  pu8Reg         2 bytes, returns
+ **                        XT: CAL_XT, XTCAL field (0..3) of OSC_STATUS
+ **                        RC: CAL_RC_HI, CAL_RC_LOW
+ **
+ ** \return Ok on success, ErrorInvalidParameter if iAdjust is out of range
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_CalibrationEncode(en_amx8x5_calibration_mode_t enMode, int32_t iAdjust, uint8_t* pu8Reg)
+{
+    uint32_t u32Abs;
+    int32_t iAdjint;
+
+    if (pu8Reg == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    if ((enMode == AMx8x5ModeCalibrateXT) ? ((iAdjust < AMX8X5_CALIBRATION_XT_MIN_PPM) || (iAdjust > AMX8X5_CALIBRATION_XT_MAX_PPM))
+                                          : ((iAdjust < AMX8X5_CALIBRATION_RC_MIN_PPM) || (iAdjust > AMX8X5_CALIBRATION_RC_MAX_PPM)))
+    {
+        return ErrorInvalidParameter;
+    }
+
+    //
+    // iAdjint = round(iAdjust * 1000 / 1907), the numerator is < 2^26.
+    //
+    u32Abs = (iAdjust < 0) ? (uint32_t)(-iAdjust) : (uint32_t)iAdjust;
+    iAdjint = (int32_t)(((uint64_t)(u32Abs * 1000 + 953) * AMX8X5_CALIBRATION_RECIPROCAL) >> 37);
+    if (iAdjust < 0)
+    {
+        iAdjint = -iAdjint;
+    }
+
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        if (iAdjint > 63)
+        {
+            //
+            // 64 to 127, CMDX = 1.
             //
-            u8XTcal = 3;
-            u8Adjreg = ((iAdjint + 192) >> 1) & 0xFF;
+            pu8Reg[0] = ((iAdjint >> 1) & 0x3F) | 0x80;
+            pu8Reg[1] = 0;
         }
-        //
-        // Load the CALX register.
-        //
-        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_XT, u8Adjreg);
-        if (res != Ok) 
+        else if (iAdjint > -65)
         {
-            return AMX8X5_FUNC_END(res);
+            //
+            // -64 to 63, CMDX = 0.
+            //
+            pu8Reg[0] = iAdjint & 0x7F;
+            pu8Reg[1] = 0;
         }
-        
-        //
-        // Mask u8XTcal.
-        //
-        res = Amx8x5_ReadByte(pstcHandle, AMX8X5_REG_OSC_STATUS,&u8Adjreg);
-        if (res != Ok) 
+        else if (iAdjint > -257)
         {
-            return AMX8X5_FUNC_END(res);
+            //
+            // -256 to -65, CMDX = 0, XTCAL 1..3 adds -64 steps each.
+            //
+            pu8Reg[1] = (uint8_t)((-1 - iAdjint) >> 6);
+            pu8Reg[0] = (iAdjint + (pu8Reg[1] << 6)) & 0x7F;
         }
-        
-        u8Adjreg = u8Adjreg & 0x3F;
-        
-        //
-        // Add u8XTcal field.
-        //
-        u8Adjreg = u8Adjreg | (u8XTcal << 6);
-
-        //
-        // Write it back.
-        //
-        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_OSC_STATUS, u8Adjreg);
-        if (res != Ok) 
+        else
         {
-            return AMX8X5_FUNC_END(res);
+            //
+            // -320 to -257, CMDX = 1, XTCAL = 3.
+            //
+            pu8Reg[0] = ((iAdjint + 192) >> 1) & 0xFF;
+            pu8Reg[1] = 3;
         }
     }
     else
     {
         //
-        // RC Adjust.
+        // RC: OFFSETR is 14 bit, CMDR shifts it by 0..3.
         //
-        if (iAdjint > 32767 )
+        if (iAdjint > 32767)
         {
-            //
-            // 32768 to 65535.
-            // Lower 8 bits.
-            // CMDR = 3.
-            //
-            u8Adjreg = ((iAdjint >> 3) & 0xFF);
-            u8Adjregu = ((iAdjint >> 11) | 0xC0);
+            pu8Reg[0] = (uint8_t)((iAdjint >> 11) | 0xC0);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 3) & 0xFF);
         }
-        else if (iAdjint > 16383 )
+        else if (iAdjint > 16383)
         {
-            //
-            // 16384 to 32767.
-            // Lower 8 bits.
-            // CMDR = 2.
-            //
-            u8Adjreg = ((iAdjint >> 2) & 0xFF);
-            u8Adjregu = ((iAdjint >> 10) | 0x80);
+            pu8Reg[0] = (uint8_t)((iAdjint >> 10) | 0x80);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 2) & 0xFF);
         }
-        else if (iAdjint > 8191 )
+        else if (iAdjint > 8191)
         {
-            //
-            // 8192 to 16383.
-            // Lower 8 bits.
-            // CMDR = 2.
-            //
-            u8Adjreg = ((iAdjint >> 1) & 0xFF);
-            u8Adjregu = ((iAdjint >> 9) | 0x40);
+            pu8Reg[0] = (uint8_t)((iAdjint >> 9) | 0x40);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 1) & 0xFF);
         }
-        else if (iAdjint >= 0 )
+        else if (iAdjint > -8193)
         {
-            //
-            // 0 to 1023.
-            // Lower 8 bits.
-            // CMDR = 0.
-            //
-            u8Adjreg = ((iAdjint) & 0xFF);
-            u8Adjregu = (iAdjint >> 8);
+            pu8Reg[0] = (uint8_t)((iAdjint >> 8) & 0x3F);
+            pu8Reg[1] = (uint8_t)(iAdjint & 0xFF);
         }
-        else if (iAdjint > -8193 )
+        else if (iAdjint > -16385)
         {
-            //
-            // -8192 to -1.
-            // Lower 8 bits.
-            // CMDR = 0.
-            //
-            u8Adjreg = ((iAdjint) & 0xFF);
-            u8Adjregu = (iAdjint >> 8) & 0x3F;
+            pu8Reg[0] = (uint8_t)((iAdjint >> 9) & 0x7F);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 1) & 0xFF);
         }
-        else if (iAdjint > -16385 )
+        else if (iAdjint > -32769)
         {
-            //
-            // -16384 to -8193.
-            // Lower 8 bits.
-            // CMDR = 1.
-            //
-            u8Adjreg = ((iAdjint >> 1) & 0xFF);
-            u8Adjregu = (iAdjint >> 9) & 0x7F;
+            pu8Reg[0] = (uint8_t)((iAdjint >> 10) & 0xBF);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 2) & 0xFF);
         }
-        else if (iAdjint > -32769 )
+        else
         {
-            //
-            // -32768 to -16385.
-            // Lower 8 bits.
-            // CMDR = 2.
-            //
-            u8Adjreg = ((iAdjint >> 2) & 0xFF);
-            u8Adjregu = (iAdjint >> 10) & 0xBF;
+            pu8Reg[0] = (uint8_t)((iAdjint >> 11) & 0xFF);
+            pu8Reg[1] = (uint8_t)((iAdjint >> 3) & 0xFF);
         }
-        else
+    }
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Decode the calibration registers
+ **
+ ** \param  enMode         AMx8x5ModeCalibrateXT or AMx8x5ModeCalibrateRC
+ **
+ ** \param  pu8Reg         2 bytes as returned by Amx8x5_CalibrationEncode()
+ **
+ ** \return adjustment in ppb (steps * 1907)
+ **
+ ******************************************************************************/
+int32_t Amx8x5_CalibrationDecode(en_amx8x5_calibration_mode_t enMode, const uint8_t* pu8Reg)
+{
+    int32_t iSteps;
+
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        //
+        // OFFSETX is 7 bit two's complement, doubled by CMDX.
+        //
+        iSteps = (int32_t)((pu8Reg[0] & 0x7F) ^ 0x40) - 0x40;
+        if (pu8Reg[0] & AMX8X5_REG_CAL_XT_CMDX_MSK)
         {
-            //
-            // -65536 to -32769.
-            // Lower 8 bits.
-            // CMDR = 3.
-            //
-            u8Adjreg = ((iAdjint >> 3) & 0xFF);
-            u8Adjregu = (iAdjint >> 11) & 0xFF;
+            iSteps *= 2;
         }
+        iSteps -= (int32_t)(pu8Reg[1] & 0x03) * 64;
+    }
+    else
+    {
+        //
+        // OFFSETR is 14 bit two's complement, times 2^CMDR.
+        //
+        iSteps = (int32_t)((((uint32_t)(pu8Reg[0] & 0x3F) << 8) | pu8Reg[1]) ^ 0x2000) - 0x2000;
+        iSteps *= (int32_t)1 << (pu8Reg[0] >> 6);
+    }
+    return iSteps * 1907;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Read the calibration currently set
+ **
+ ** One burst read: CAL_XT..OSC_STATUS for XT, CAL_RC_HI..CAL_RC_LOW for RC.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  enMode         AMx8x5ModeCalibrateXT or AMx8x5ModeCalibrateRC
+ **
+ ** \param  pi32Ppb        Returns the adjustment in ppb
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_GetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_calibration_mode_t enMode, int32_t* pi32Ppb)
+{
+    uint8_t au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_CAL_XT + 1];
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_GetCalibrationValue");
 
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pi32Ppb == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_CAL_XT,au8Reg,sizeof(au8Reg));
+        au8Reg[1] = au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_CAL_XT] >> 6;
+    }
+    else
+    {
+        res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_CAL_RC_HI,au8Reg,2);
+    }
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    *pi32Ppb = Amx8x5_CalibrationDecode(enMode,au8Reg);
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Set the calibration.
+ **
+ ** This function loads the AMX8XX counter registers with the last read
+ ** values of Amx8x5_GetTime()
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  enMode         AMx8x5ModeCalibrateXT calibrate the XT oscillator or AMx8x5ModeCalibrateRC calibrate the RC oscillator
+ **
+ ** \param   iAdjust: Adjustment in ppm. 
+ **          Adjustment limits are:
+ **              enMode = AMx8x5ModeCalibrateXT => (-610 to +242)
+ **              enMode = AMx8x5ModeCalibrateRC => (-65536 to +65520)
+ **              An iAdjust value of zero resets the selected oscillator calibration
+ **              value to 0.
+ **
+ ** \return Ok on success, ErrorInvalidParameter if iAdjust is out of range,
+ **         else the Error as en_result_t
+ ** 
+ ** Example:
+ ** @code
+ ** enMode(&stcRtcConfig,AMx8x5ModeCalibrateXT,5);
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_calibration_mode_t enMode, int32_t iAdjust)
+{
+    en_result_t res;
+    uint8_t au8Reg[2];
+    uint8_t u8OscStatus;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetCalibrationValue");
+    
+    res = Amx8x5_CalibrationEncode(enMode,iAdjust,au8Reg);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        //
+        // Load the CALX register.
+        //
+        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_XT, au8Reg[0]);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        
+        //
+        // Mask u8XTcal.
+        //
+        res = Amx8x5_ReadByte(pstcHandle, AMX8X5_REG_OSC_STATUS,&u8OscStatus);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        
+        //
+        // Add u8XTcal field and write it back.
+        //
+        u8OscStatus = (u8OscStatus & 0x3F) | (au8Reg[1] << 6);
+        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_OSC_STATUS, u8OscStatus);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+    else
+    {
         //
         // Load the CALRU register.
         //
-        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_RC_HI, u8Adjregu);
+        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_RC_HI, au8Reg[0]);
         if (res != Ok) 
         {
             return AMX8X5_FUNC_END(res);
@@ -1701,7 +2260,7 @@ en_result_t Amx8x5_SetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x
         //
         // Load the CALRL register.
         //
-        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_RC_LOW, u8Adjreg);
+        res = Amx8x5_WriteByte(pstcHandle, AMX8X5_REG_CAL_RC_LOW, au8Reg[1]);
         if (res != Ok) 
         {
             return AMX8X5_FUNC_END(res);
@@ -2558,6 +3117,35 @@ en_result_t Amx8x5_EnableOutput(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Outpu
     }
 }
 
+/**
+ ******************************************************************************
+ ** \brief  TRICKLE register value
+ **
+ ** \param  enDiode        Diode Select, AMx8x5TrickleDiodeDisabled disables the Trickle Charger
+ **
+ ** \param  enResistor     Output Resistor, AMx8x5TrickleResistorDisabled disables the Trickle Charger
+ **
+ ** \param  bEnable        true for enable, false for disable
+ **
+ ** \return TRICKLE value
+ **
+ ******************************************************************************/
+static uint8_t Amx8x5_TrickleEncode(en_amx8x5_trickle_diode_t enDiode, en_amx8x5_trickle_resistor_t enResistor, bool bEnable)
+{
+    uint8_t u8Tmp = 0;
+
+    //
+    // A value of 1010 enables the trickle charge function. All other values disable the Trickle Charger.
+    //
+    if ((true == bEnable) && (enDiode != AMx8x5TrickleDiodeDisabled) && (enResistor != AMx8x5TrickleResistorDisabled))
+    {
+        u8Tmp |= (AMX8X5_REG_TRICKLE_TCS_ENABLE_VALUE << AMX8X5_REG_TRICKLE_TCS_POS);
+    }
+    u8Tmp |= ((uint8_t)enDiode << AMX8X5_REG_TRICKLE_DIODE_POS) & AMX8X5_REG_TRICKLE_DIODE_MSK;
+    u8Tmp |= ((uint8_t)enResistor << AMX8X5_REG_TRICKLE_ROUT_POS) & AMX8X5_REG_TRICKLE_ROUT_MSK;
+    return u8Tmp;
+}
+
 /**
  ******************************************************************************
  ** \brief  This function controls the Trickle Charger
@@ -2585,7 +3173,7 @@ en_result_t Amx8x5_EnableOutput(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Outpu
  ******************************************************************************/
 en_result_t Amx8x5_EnableTrickleCharger(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_trickle_diode_t enDiode, en_amx8x5_trickle_resistor_t enResistor, bool bEnable)
 {
-    uint8_t u8Tmp = 0;
+    uint8_t u8Tmp;
     en_result_t res;
     
     AMX8X5_DEBUG_FUNC_START("Amx8x5_EnableTrickleCharger");
@@ -2595,42 +3183,7 @@ en_result_t Amx8x5_EnableTrickleCharger(stc_amx8x5_handle_t* pstcHandle, en_amx8
         return AMX8X5_FUNC_END(ErrorUninitialized);
     }
     
-    //
-    // A value of 1010 enables the trickle charge function. All other values disable the Trickle Charger.
-    //
-    if (true == bEnable)
-    {
-        u8Tmp |= (AMX8X5_REG_TRICKLE_TCS_ENABLE_VALUE << AMX8X5_REG_TRICKLE_TCS_POS);
-    }
-    
-    switch(enDiode)
-    {
-        case AMx8x5TrickleDiodeSchottky:
-            u8Tmp |= (0x1) << AMX8X5_REG_TRICKLE_DIODE_POS;
-            break;
-        case AMx8x5TrickleDiodeNormal:
-            u8Tmp |= (0x2) << AMX8X5_REG_TRICKLE_DIODE_POS;
-            break;
-        default:
-           u8Tmp &= ~(AMX8X5_REG_TRICKLE_TCS_ENABLE_VALUE << AMX8X5_REG_TRICKLE_TCS_POS);
-           break;
-    }
-    
-    switch(enResistor)
-    {
-        case AMx8x5TrickleResistor3K:
-            u8Tmp |= (0x1) << AMX8X5_REG_TRICKLE_DIODE_POS;
-            break;
-        case AMx8x5TrickleResistor6K:
-            u8Tmp |= (0x2) << AMX8X5_REG_TRICKLE_DIODE_POS;
-            break;
-        case AMx8x5TrickleResistor11K:
-            u8Tmp |= (0x3) << AMX8X5_REG_TRICKLE_DIODE_POS;
-            break;
-        default:
-           u8Tmp &= ~(AMX8X5_REG_TRICKLE_TCS_ENABLE_VALUE << AMX8X5_REG_TRICKLE_TCS_POS);
-           break;
-    }
+    u8Tmp = Amx8x5_TrickleEncode(enDiode,enResistor,bEnable);
     
     //
     // The Key Register must be written with the value 0x9D in order to enable access to this register.
@@ -3071,46 +3624,21 @@ en_result_t Amx8x5_SelectOscillatorMode(stc_amx8x5_handle_t* pstcHandle, en_amx8
 
 /**
  ******************************************************************************
- ** \brief  Select an oscillator mode.
+ ** \brief  Calculate the WDT register value
  **
- ** \param  pstcHandle     RTC Handle
+ ** \param  u32Period      timeout period in ms (65 to 124,000)
  **
- ** \param u32Period     timeout period in ms (65 to 124,000)
+ ** \param  enPin          pin to generate the watchdog signal
  **
- ** \param  enPin        pin to generate the watchdog signal
- **                      AMx8x5WatchdogInterruptPinDisable => disable WDT
- **                      AMx8x5WatchdogInterruptPinFOUTnIRQ => generate an interrupt on FOUT/nIRQ
- **                      AMx8x5WatchdogInterruptPinPSWnIRQ2 => generate an interrupt on PSW/nIRQ2
- **                      AMx8x5WatchdogInterruptPinnRST => generate a reset on nRST (AM18xx only)
- **
- ** \return Ok on success, else the Error as en_result_t
- ** 
+ ** \return WDT register value, BMB = 0 (disabled) for AMx8x5WatchdogInterruptPinDisable
+ **         or a period below 63 ms
  **
  ******************************************************************************/
-en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin)
+static uint8_t Amx8x5_WatchdogEncode(uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin)
 {
-    uint8_t u8WDTreg;
     uint8_t u8WDS;
-    uint8_t u8BMB;
+    uint32_t u32BMB;
     uint8_t u8WRB;
-    en_result_t res;
-    
-    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetWatchdog");
-    
-    //
-    // Disable the WDT with BMB = 0.
-    // Clear the WDT flag.
-    //
-    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_WDT,0);
-    if (res != Ok) 
-    {
-        return AMX8X5_FUNC_END(res);
-    }
-    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_WDT_MSK);
-    if (res != Ok) 
-    {
-        return AMX8X5_FUNC_END(res);
-    }
 
     //
     // Use the shortest clock interval which will allow the selected period.
@@ -3121,7 +3649,7 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         // Use 16 Hz.
         //
         u8WRB = 0;
-        u8BMB = (u32Period * 16) / 1000;
+        u32BMB = (u32Period * 16) / 1000;
     }
     else if (u32Period < (31000 / 4))
     {
@@ -3129,7 +3657,7 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         // Use 4 Hz.
         //
         u8WRB = 1;
-        u8BMB = (u32Period * 4) / 1000;
+        u32BMB = (u32Period * 4) / 1000;
     }
     else if (u32Period < 31000)
     {
@@ -3137,15 +3665,16 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         // Use 1 Hz.
         //
         u8WRB = 2;
-        u8BMB = u32Period / 1000;
+        u32BMB = u32Period / 1000;
     }
     else
     {
         //
-        // Use 1/4 Hz.
+        // Use 1/4 Hz, BMB has 5 bits.
         //
         u8WRB = 3;
-        u8BMB = u32Period / 4000;
+        u32BMB = u32Period / 4000;
+        if (u32BMB > 31) u32BMB = 31;
     }
 
     switch (enPin)
@@ -3155,9 +3684,71 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         //
         case AMx8x5WatchdogInterruptPinDisable:
         u8WDS = 0;
-        u8BMB = 0;
+        u32BMB = 0;
+        break;
+
+        //
+        // Interrupt on FOUT/nIRQ or PSW/nIRQ2.
+        //
+        case AMx8x5WatchdogInterruptPinFOUTnIRQ:
+        case AMx8x5WatchdogInterruptPinPSWnIRQ2:
+        u8WDS = 0;
+        break;
+
+        //
+        // Reset on nRST.
+        //
+        case AMx8x5WatchdogInterruptPinnRST:
+        default:
+        u8WDS = 1;
         break;
+    }
+
+    return (uint8_t)((u8WDS << AMX8X5_REG_WDT_WDS_POS) | (u32BMB << AMX8X5_REG_WDT_BMB_POS) | u8WRB);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Configure and start the watchdog timer.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param u32Period     timeout period in ms (65 to 124,000)
+ **
+ ** \param  enPin        pin to generate the watchdog signal
+ **                      AMx8x5WatchdogInterruptPinDisable => disable WDT
+ **                      AMx8x5WatchdogInterruptPinFOUTnIRQ => generate an interrupt on FOUT/nIRQ
+ **                      AMx8x5WatchdogInterruptPinPSWnIRQ2 => generate an interrupt on PSW/nIRQ2
+ **                      AMx8x5WatchdogInterruptPinnRST => generate a reset on nRST (AM18xx only)
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ ** 
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin)
+{
+    uint8_t u8WDTreg;
+    en_result_t res;
+    
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SetWatchdog");
+    
+    //
+    // Disable the WDT with BMB = 0.
+    // Clear the WDT flag.
+    //
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_WDT,0);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_WDT_MSK);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
 
+    switch (enPin)
+    {
         //
         // Interrupt on FOUT/nIRQ.
         //
@@ -3166,7 +3757,6 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         // Select interrupt.
         // Clear the OUT1S field
         //
-        u8WDS = 0;
         res = Amx8x5_SetOut1Mode(pstcHandle,AMx8x5Out1nIRQAtIrqElseOut);
         if (res != Ok) 
         {
@@ -3182,7 +3772,6 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         // Select interrupt.
         // Clear the OUT2S field.
         //
-        u8WDS = 0;
         res = Amx8x5_SetOut2Mode(pstcHandle,AMx8x5Out2nIRQAtIrqElseOutB);
         if (res != Ok) 
         {
@@ -3190,15 +3779,7 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
         }
         break;
 
-        //
-        // Interrupt on nRST.
-        //
-        case AMx8x5WatchdogInterruptPinnRST:
         default:
-        //
-        // Select reset out.
-        //
-        u8WDS = 1;
         break;
     }
 
@@ -3206,14 +3787,14 @@ en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Peri
     // Create the correct value.
     // Write the register.
     //
-    u8WDTreg = (u8WDS * 0x80) + (u8BMB * 0x4) + u8WRB;
+    u8WDTreg = Amx8x5_WatchdogEncode(u32Period,enPin);
  
-    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_WDT,u8WDTreg);
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_WDT,u8WDTreg);
     if (res != Ok) 
     {
         return AMX8X5_FUNC_END(res);
     }
-    return Ok;
+    return AMX8X5_FUNC_END(Ok);
 }
 
 /**
@@ -3377,10 +3958,7 @@ en_result_t  Amx8x5_SetAutocalibration(stc_amx8x5_handle_t* pstcHandle, en_amx8x
  ******************************************************************************/
 en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin)
 {
-    uint8_t u8TM = 0;
-    uint8_t u8TRPT = 0;
-    uint8_t u8TFS = 0;
-    uint8_t u8TE;
+    uint8_t u8Fields;
     uint8_t u8Temp;
     uint8_t u8TCTRL;
     int32_t u8Timer = 0;
@@ -3406,6 +3984,103 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         enOMODE = AMx8x5ModeCalibrateXT;
     }
 
+    Amx8x5_CountdownEncode(enOMODE,enRange,iPeriod,enRepeat,enPin,&u8Timer,&u8Fields);
+
+    //
+    // Get TCTRL, keep RPT, clear TE.
+    //
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,&u8TCTRL);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u8TCTRL = u8TCTRL & 0x1C;
+    
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,u8TCTRL);
+    if (res != Ok) 
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    
+    //
+    // Merge the fields.
+    //
+    u8TCTRL = u8TCTRL | u8Fields;
+
+    //
+    // Route the interrupt to the pins.
+    //
+    res = Amx8x5_SetCountdownPin(pstcHandle,enPin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    if (enPin != AMx8x5CountdownInterruptPinDisable)
+    {
+        //
+        // Clear TIM.
+        // Set TIE.
+        // Initialize the timer.
+        // Initialize the timer repeat.
+        // Start the timer.
+        //
+        res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_TIM_MSK);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,AMX8X5_REG_INT_MASK_TIE_MSK);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER,u8Timer);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_INITIAL,u8Timer);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,u8TCTRL);
+        if (res != Ok) 
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Calculate TIMER and the TE, TM, TRPT, TFS fields of TIMER_CTRL
+ **
+ ** \param  enOMODE        Oscillator mode, XT or RC
+ **
+ ** \param  enRange        Periode range, see #en_amx8x5_periode_range_t
+ **
+ ** \param  iPeriod        Periode in us or seconds
+ **
+ ** \param  enRepeat       Interrupt output, see #en_amx8x5_countdown_interrupt_output_t
+ **
+ ** \param  enPin          Interrupt pin, see #en_amx8x5_countdown_interrupt_pin_t
+ **
+ ** \param  piTimer        returns the TIMER value, may be out of 0..255 if the period does not fit
+ **
+ ** \param  pu8TimerCtrl   returns TE, TM, TRPT and TFS of TIMER_CTRL
+ **
+ ******************************************************************************/
+static void Amx8x5_CountdownEncode(en_amx8x5_calibration_mode_t enOMODE, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin, int32_t* piTimer, uint8_t* pu8TimerCtrl)
+{
+    uint8_t u8TM = 0;
+    uint8_t u8TRPT = 0;
+    uint8_t u8TFS = 0;
+    uint8_t u8TE;
+    int32_t u8Timer = 0;
+
     if (enPin == AMx8x5CountdownInterruptPinDisable)
     {
         u8TE = 0;
@@ -3569,26 +4244,25 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         }
     }
 
-    //
-    // Get TCTRL, keep RPT, clear TE.
-    //
-    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,&u8TCTRL);
-    if (res != Ok) 
-    {
-        return AMX8X5_FUNC_END(res);
-    }
-    u8TCTRL = u8TCTRL & 0x1C;
-    
-    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,u8TCTRL);
-    if (res != Ok) 
-    {
-        return AMX8X5_FUNC_END(res);
-    }
-    
-    //
-    // Merge the fields.
-    //
-    u8TCTRL = u8TCTRL | (u8TE * 0x80) | (u8TM * 0x40) | (u8TRPT * 0x20) | u8TFS;
+    *piTimer = u8Timer;
+    *pu8TimerCtrl = (u8TE * 0x80) | (u8TM * 0x40) | (u8TRPT * 0x20) | u8TFS;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Route the countdown timer interrupt to the output pins
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  enPin          Interrupt pin, see #en_amx8x5_countdown_interrupt_pin_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_SetCountdownPin(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_countdown_interrupt_pin_t enPin)
+{
+    uint8_t u8Temp;
+    en_result_t res;
 
     //
     // Generate nTIRQ interrupt on FOUT/nIRQ (asserted low).
@@ -3601,7 +4275,7 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         res = Amx8x5_SetOut1Mode(pstcHandle,AMx8x5Out1nIRQAtIrqElseOut);
         if (res != Ok)
         {
-            return AMX8X5_FUNC_END(res);
+            return res;
         }
     }
 
@@ -3616,7 +4290,7 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_CONTROL_2,&u8Temp);
         if (res != Ok) 
         {
-            return AMX8X5_FUNC_END(res);
+            return res;
         }
 
         //
@@ -3633,7 +4307,7 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONTROL_2,u8Temp);
         if (res != Ok) 
         {
-            return AMX8X5_FUNC_END(res);
+            return res;
         }
     }
 
@@ -3648,7 +4322,7 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_SQW,0x9B);
         if (res != Ok) 
         {
-            return AMX8X5_FUNC_END(res);
+            return res;
         }
     }
 
@@ -3663,67 +4337,31 @@ en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_perio
         res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_SQW,0x9A);
         if (res != Ok) 
         {
-            return AMX8X5_FUNC_END(res);
+            return res;
         }
     }
+    return Ok;
+}
 
-    if (enPin != AMx8x5CountdownInterruptPinDisable)
-    {
-        //
-        // Clear TIM.
-        // Set TIE.
-        // Initialize the timer.
-        // Initialize the timer repeat.
-        // Start the timer.
-        //
-        res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_TIM_MSK);
-        if (res != Ok) 
-        {
-            return AMX8X5_FUNC_END(res);
-        }
-        res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,AMX8X5_REG_INT_MASK_TIE_MSK);
-        if (res != Ok) 
-        {
-            return AMX8X5_FUNC_END(res);
-        }
-        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER,u8Timer);
-        if (res != Ok) 
-        {
-            return AMX8X5_FUNC_END(res);
-        }
-        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_INITIAL,u8Timer);
-        if (res != Ok) 
-        {
-            return AMX8X5_FUNC_END(res);
-        }
-        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,u8TCTRL);
-        if (res != Ok) 
-        {
-            return AMX8X5_FUNC_END(res);
-        }
-    }
-    return AMX8X5_FUNC_END(Ok);
-}
-
-/**
- ******************************************************************************
- ** \brief  Enable interrupt
- **
- ** see also #AMX8X5_REG_INT_MASK definition
- **
- ** \param  pstcHandle          RTC Handle
- **
- ** \param  u8IrqMask           Mask of interrupts to enable as defined in #AMX8X5_REG_INT_MASK
- **
- ** \return                     Ok on success, else the Error as en_result_t
- **
- ******************************************************************************/
-en_result_t Amx8x5_EnableInterrupt(stc_amx8x5_handle_t* pstcHandle, uint8_t u8IrqMask)
-{
-    en_result_t res;
-    AMX8X5_DEBUG_FUNC_START("Amx8x5_EnableInterrupt");
-    res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,u8IrqMask);
-    if (res != Ok) 
+/**
+ ******************************************************************************
+ ** \brief  Enable interrupt
+ **
+ ** see also #AMX8X5_REG_INT_MASK definition
+ **
+ ** \param  pstcHandle          RTC Handle
+ **
+ ** \param  u8IrqMask           Mask of interrupts to enable as defined in #AMX8X5_REG_INT_MASK
+ **
+ ** \return                     Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_EnableInterrupt(stc_amx8x5_handle_t* pstcHandle, uint8_t u8IrqMask)
+{
+    en_result_t res;
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_EnableInterrupt");
+    res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,u8IrqMask);
+    if (res != Ok) 
     {
         return AMX8X5_FUNC_END(res);
     }
@@ -3993,198 +4631,5156 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
 }
 
 
-#ifdef __cplusplus
-    #if defined(ARDUINO)
-    #include <Arduino.h>
-
-    // -----------------------------------------------------------------------
-    // Platform capability detection
-    //
-    // AMX8X5_WIRE_AVAILABLE: Wire (I2C) is present on this platform.
-    //   Explicitly known platforms always have Wire. For unknown platforms
-    //   fall back to WIRE_INTERFACES_COUNT: include Wire when > 0 or when
-    //   the macro is not defined at all (conservative: assume available).
-    //
-    // AMX8X5_SPI_AVAILABLE: SPI is present on this platform.
-    //   Same logic as Wire. Additionally, if the user already included
-    //   <SPI.h> before this library, SPI is always considered available.
-    //
-    // Platforms with Wire and SPI always available:
-    //   AVR (Uno, Mega, Leonardo …), megaAVR (Nano Every),
-    //   ESP8266, ESP32 (all variants),
-    //   STM32 (Arduino_Core_STM32),
-    //   nRF52 (Adafruit / Arduino),
-    //   RP2040 (Arduino-Pico / Mbed),
-    //   SAMD (Zero, MKR …) — signalled by WIRE/SPI_INTERFACES_COUNT > 0
-    // -----------------------------------------------------------------------
-    #if defined(ARDUINO_ARCH_AVR)     || defined(ARDUINO_ARCH_MEGAAVR)  || \
-        defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)    || \
-        defined(ARDUINO_ARCH_STM32)   || defined(ARDUINO_ARCH_NRF52)    || \
-        defined(ARDUINO_ARCH_RP2040)  || defined(ARDUINO_ARCH_MBED_RP2040) || \
-        !defined(WIRE_INTERFACES_COUNT) || (WIRE_INTERFACES_COUNT > 0)
-      #define AMX8X5_WIRE_AVAILABLE 1
-    #endif
-
-    #if defined(ARDUINO_ARCH_AVR)     || defined(ARDUINO_ARCH_MEGAAVR)  || \
-        defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)    || \
-        defined(ARDUINO_ARCH_STM32)   || defined(ARDUINO_ARCH_NRF52)    || \
-        defined(ARDUINO_ARCH_RP2040)  || defined(ARDUINO_ARCH_MBED_RP2040) || \
-        (defined(SPI_INTERFACES_COUNT) && (SPI_INTERFACES_COUNT > 0))   || \
-        defined(SPI_H) || defined(_SPI_H_INCLUDED) || defined(SPI_H_)
-      #define AMX8X5_SPI_AVAILABLE 1
-    #endif
-    // -----------------------------------------------------------------------
+/**
+ ******************************************************************************
+ ** \brief  Capture the register set 0x00..0x30 with a single burst read.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcState      Snapshot to fill, see #stc_amx8x5_state_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SaveState(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_state_t* pstcState)
+{
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SaveState");
 
-    #if defined(AMX8X5_WIRE_AVAILABLE)
-    #include <Wire.h>
-    static int i2cWrite(void* pHandle, uint32_t u32Address, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    if (pstcHandle == NULL)
     {
-        for(int i = 0; i < u32Len;i++)
-        {
-            Wire.beginTransmission(u32Address);  	// Initialize the Tx buffer
-            Wire.write(u8Register+i);    		// Put slave register address in Tx buffer
-            Wire.write(*pu8Data);					// Put data in Tx buffer
-            pu8Data++;
-            Wire.endTransmission();				// Send the Tx buffer
-        }
-        
-        return Ok;
+        return AMX8X5_FUNC_END(ErrorUninitialized);
     }
-
-    static int i2cRead(void* pHandle, uint32_t u32Address, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    if (pstcState == NULL)
     {
-        for(int i = 0; i < u32Len;i++)
-        {
-            Wire.beginTransmission(u32Address);  	// Initialize the Tx buffer
-            Wire.write(u8Register+i);    		// Put slave register address in Tx buffer
-            Wire.endTransmission();				// Send the Tx buffer
-            Wire.requestFrom(u32Address,1);
-            *pu8Data = Wire.read();					// Get data in Rx buffer
-            pu8Data++;
-        }
-       
-        return Ok;
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
     }
-    #endif // AMX8X5_WIRE_AVAILABLE
 
-    #if defined(AMX8X5_SPI_AVAILABLE)
-    #if !defined(SPI_H) && !defined(_SPI_H_INCLUDED) && !defined(SPI_H_)
-    #include <SPI.h>
-    #endif
-    static SPISettings spiSettings(2000000, MSBFIRST, SPI_MODE0);
+    return AMX8X5_FUNC_END(Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,pstcState->au8Register,AMX8X5_STATE_SIZE));
+}
 
-    static int spiWrite(void* pHandle, uint32_t u32ChipSelect, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
-    {
-        // AM08X5 SPI write: register byte with MSB=0 (write), then data bytes
-        SPI.beginTransaction(spiSettings);
-        digitalWrite((uint8_t)u32ChipSelect, LOW);
-        SPI.transfer(u8Register & 0x7F);
-        for (uint32_t i = 0; i < u32Len; i++)
-        {
-            SPI.transfer(pu8Data[i]);
-        }
-        digitalWrite((uint8_t)u32ChipSelect, HIGH);
-        SPI.endTransaction();
-        return Ok;
-    }
+/**
+ ******************************************************************************
+ ** \brief  Restore a snapshot taken by Amx8x5_SaveState()
+ **
+ ** Only the writable configuration registers are written back. The time
+ ** counters (0x00..0x07), status flags, ID and analog status registers are
+ ** left untouched. The countdown timer is reloaded from its initial value
+ ** and a pending SLEEP request is not repeated.
+ **
+ ** Alarm and control registers are written in two bursts, the key protected
+ ** registers are written each after its own CONFIG_KEY unlock. TRICKLE, BREF
+ ** and BATMODE IO are only restored on AM18x5 devices.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcState      Snapshot to restore, see #stc_amx8x5_state_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_RestoreState(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_state_t* pstcState)
+{
+    uint8_t au8Temp[AMX8X5_REG_WDT - AMX8X5_REG_CONTROL_1 + 1];
+    uint8_t* pu8Reg;
+    en_result_t res;
 
-    static int spiRead(void* pHandle, uint32_t u32ChipSelect, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
-    {
-        // AM08X5 SPI read: register byte with MSB=1 (read), then receive data bytes
-        SPI.beginTransaction(spiSettings);
-        digitalWrite((uint8_t)u32ChipSelect, LOW);
-        SPI.transfer(u8Register | 0x80);
-        for (uint32_t i = 0; i < u32Len; i++)
-        {
-            pu8Data[i] = SPI.transfer(0x00);
-        }
-        digitalWrite((uint8_t)u32ChipSelect, HIGH);
-        SPI.endTransaction();
-        return Ok;
-    }
-    #endif // AMX8X5_SPI_AVAILABLE
-    #endif // ARDUINO
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_RestoreState");
 
-    bool AMx8x5::begin(void)
+    if (pstcHandle == NULL)
     {
-        #if defined(ARDUINO) && defined(AMX8X5_WIRE_AVAILABLE)
-        stcRtcConfig.pfnReadI2C = i2cRead;
-        stcRtcConfig.pfnWriteI2C = i2cWrite;
-        #endif
-        if (Amx8x5_Init(&stcRtcConfig) == Ok)
-        {
-            return true;
-        }
-        return false;
+        return AMX8X5_FUNC_END(ErrorUninitialized);
     }
-
-    /**
-     * @brief Initialise the RTC using the Arduino SPI library.
-     *
-     * Sets up the built-in SPI callbacks (2 MHz, SPI_MODE0) and configures
-     * the given pin as chip-select output.  Use this instead of begin() when
-     * the device type is a SPI variant (AM0815 / AM1815).
-     *
-     * Only available when <SPI.h> has been included before this library.
-     * On boards without SPI hardware simply omit <SPI.h> and this overload
-     * will not be compiled.
-     *
-     * @param u8CsPin  Arduino pin number connected to the RTC nCE/CS line.
-     * @return true on success (ID registers verified), false otherwise.
-     */
-    bool AMx8x5::begin(uint8_t u8CsPin)
+    if (pstcState == NULL)
     {
-        #if defined(ARDUINO) && defined(AMX8X5_SPI_AVAILABLE)
-        pinMode(u8CsPin, OUTPUT);
-        digitalWrite(u8CsPin, HIGH);
-        SPI.begin();
-        stcRtcConfig.enMode        = AMx8x5ModeSPI;
-        stcRtcConfig.u32ChipSelect = (uint32_t)u8CsPin;
-        stcRtcConfig.pfnReadSpi    = spiRead;
-        stcRtcConfig.pfnWriteSpi   = spiWrite;
-        #endif
-        if (Amx8x5_Init(&stcRtcConfig) == Ok)
-        {
-            return true;
-        }
-        return false;
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
     }
+    pu8Reg = pstcState->au8Register;
 
-    en_result_t AMx8x5::init(AMx8x5::stcHandle* pstcHandle)
+    //
+    // Alarm registers 0x08..0x0E.
+    //
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_ALARM_HUNDRS,&pu8Reg[AMX8X5_REG_ALARM_HUNDRS],AMX8X5_REG_STATUS - AMX8X5_REG_ALARM_HUNDRS);
+    if (res != Ok)
     {
-        memcpy(&stcRtcConfig,pstcHandle,sizeof(stcRtcConfig));
-        return Ok;
+        return AMX8X5_FUNC_END(res);
     }
 
-    void AMx8x5::update(void)
+    //
+    // Control registers 0x10..0x1B:
+    // clear SLP and SLST in the sleep control register,
+    // load the countdown timer with its initial value.
+    //
+    memcpy(au8Temp,&pu8Reg[AMX8X5_REG_CONTROL_1],sizeof(au8Temp));
+    au8Temp[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_CONTROL_1] &= ~(0x80 | 0x08);
+    au8Temp[AMX8X5_REG_TIMER - AMX8X5_REG_CONTROL_1] = pu8Reg[AMX8X5_REG_TIMER_INITIAL];
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_CONTROL_1,au8Temp,sizeof(au8Temp));
+    if (res != Ok)
     {
-
+        return AMX8X5_FUNC_END(res);
     }
 
-    bool AMx8x5::end(void)
+    //
+    // Oscillator control and status:
+    // unlock OSC_CONTROL, write XTCAL and LKO2,
+    // OF and ACF are written as 1 to keep pending flags.
+    //
+    au8Temp[0] = pu8Reg[AMX8X5_REG_OSC_CONTROL];
+    au8Temp[1] = (pu8Reg[AMX8X5_REG_OSC_STATUS] & (AMX8X5_REG_OSC_STATUS_XTCAL_MSK | AMX8X5_REG_OSC_STATUS_LKO2_MSK)) |
+                 AMX8X5_REG_OSC_STATUS_OF_MSK | AMX8X5_REG_OSC_STATUS_ACF_MSK;
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OSC);
+    if (res != Ok)
     {
-        return true;
+        return AMX8X5_FUNC_END(res);
     }
-
-    /**
-     ******************************************************************************
-     ** \brief  This function is reset the RTC
-     **
-     ** \return Ok on success, else the Error as en_result_t
-     ** 
-     ******************************************************************************/
-    AMx8x5::enResult  AMx8x5::reset(void){
-        return Amx8x5_Reset(&stcRtcConfig);
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_OSC_CONTROL,au8Temp,2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
     }
 
-    /**
-     ******************************************************************************
-     ** \brief  This function is getting the time of the RTC
-     **
-     ** \param  ppstcTime      returns the pointer of the time structure stc_amx8x5_time_t in a pointer of the pointer
-     **
-     ** \return Ok on success, else the Error as en_result_t
-     **
+    if ((pstcHandle->enRtcType == AMx8x5Type1805) || (pstcHandle->enRtcType == AMx8x5Type1815))
+    {
+        //
+        // Trickle charger, BREF and BATMODE IO,
+        // each write needs its own key.
+        //
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TRICKLE,pu8Reg[AMX8X5_REG_TRICKLE]);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_BREF_CTRL,pu8Reg[AMX8X5_REG_BREF_CTRL]);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_BATMODE_IO,pu8Reg[AMX8X5_REG_BATMODE_IO] & 0x80);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    //
+    // Output control.
+    //
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_OCTRL,pu8Reg[AMX8X5_REG_OCTRL]);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    return AMX8X5_FUNC_END(Ok);
+}
+
+
+/**
+ ******************************************************************************
+ ** \brief  Calculate the configuration fingerprint (CRC-16/CCITT)
+ **
+ ** Only the configuration bits selected by au8FingerprintMask are covered,
+ ** counters, flags and status bits are ignored.
+ **
+ ** \param  pu8Config      Registers 0x10 (#AMX8X5_REG_CONTROL_1) .. 0x30 (#AMX8X5_REG_OCTRL)
+ **
+ ** \return Fingerprint
+ **
+ ******************************************************************************/
+static uint16_t Amx8x5_ConfigFingerprint(uint8_t* pu8Config)
+{
+    uint16_t u16Crc = 0xFFFF;
+    uint32_t i;
+    int iBit;
+    for(i = 0; i < sizeof(au8FingerprintMask); i++)
+    {
+        if (au8FingerprintMask[i] == 0)
+        {
+            continue;
+        }
+        u16Crc ^= (uint16_t)(pu8Config[i] & au8FingerprintMask[i]) << 8;
+        for(iBit = 0; iBit < 8; iBit++)
+        {
+            if (u16Crc & 0x8000)
+            {
+                u16Crc = (u16Crc << 1) ^ 0x1021;
+            }
+            else
+            {
+                u16Crc = u16Crc << 1;
+            }
+        }
+    }
+    return u16Crc;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Read configuration registers and RAM window in one burst and
+ **         select the RAM bank of the fingerprint
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u8RamAddress   RTC RAM address of the 2 byte fingerprint
+ **
+ ** \param  pu8Config      Buffer for registers 0x10 .. 0x3F
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_ReadConfig(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, uint8_t* pu8Config)
+{
+    uint8_t u8Xadd;
+    en_result_t res;
+
+    if ((u8RamAddress & 0x3F) == 0x3F)
+    {
+        //
+        // Fingerprint must not cross a RAM bank.
+        //
+        return ErrorInvalidParameter;
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_CONTROL_1,pu8Config,AMX8X5_REG_EXTENDED_ADDR - AMX8X5_REG_CONTROL_1 + 1);
+    if (res != Ok)
+    {
+        return res;
+    }
+    res = Amx8x5_CheckId(pstcHandle,((uint16_t)pu8Config[AMX8X5_REG_ID1 - AMX8X5_REG_CONTROL_1] << 8) | pu8Config[AMX8X5_REG_ID0 - AMX8X5_REG_CONTROL_1]);
+    if (res != Ok)
+    {
+        return res;
+    }
+
+    //
+    // Same XADDR calculation as Amx8x5_GetExtensionAddress(),
+    // only written if another bank is selected.
+    //
+    u8Xadd = (0x8 | (u8RamAddress >> 6)) | (pu8Config[AMX8X5_REG_EXTENDED_ADDR - AMX8X5_REG_CONTROL_1] & 0xC0);
+    if (u8Xadd != pu8Config[AMX8X5_REG_EXTENDED_ADDR - AMX8X5_REG_CONTROL_1])
+    {
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,u8Xadd);
+    }
+    return res;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Store the fingerprint of the current configuration in RTC RAM
+ **
+ ** Call after the application has finished configuring the RTC. On the next
+ ** start Amx8x5_CheckWarmBoot() detects whether this configuration was kept.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u8RamAddress   RTC RAM address for the 2 byte fingerprint, must not be the last byte of a 64 byte bank
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SaveConfigFingerprint(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress)
+{
+    uint8_t au8Config[AMX8X5_REG_EXTENDED_ADDR - AMX8X5_REG_CONTROL_1 + 1];
+    uint8_t au8Fingerprint[2];
+    uint16_t u16Fingerprint;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SaveConfigFingerprint");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+
+    res = Amx8x5_ReadConfig(pstcHandle,u8RamAddress,au8Config);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u16Fingerprint = Amx8x5_ConfigFingerprint(au8Config);
+    au8Fingerprint[0] = (uint8_t)(u16Fingerprint >> 8);
+    au8Fingerprint[1] = (uint8_t)(u16Fingerprint & 0xFF);
+
+    res = Amx8x5_WriteBytes(pstcHandle,(u8RamAddress & 0x3F) | 0x40,au8Fingerprint,2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize the RTC and detect a warm boot
+ **
+ ** Replaces Amx8x5_Init() on systems that keep the RTC powered while the
+ ** MCU restarts. The ID and control registers are read with one burst and
+ ** their fingerprint is compared to the one stored by
+ ** Amx8x5_SaveConfigFingerprint(). If both match the RTC kept its
+ ** configuration and the application can skip its setup.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u8RamAddress   RTC RAM address of the 2 byte fingerprint
+ **
+ ** \param  pbWarmBoot     returns true if the configuration is unchanged
+ **
+ ** \return Ok on success (ID verified), else the Error as en_result_t
+ **
+ ** Example:
+ ** @code
+ ** bool bWarm;
+ ** if (Amx8x5_CheckWarmBoot(&stcRtcConfig,0xFE,&bWarm) == Ok)
+ ** {
+ **     if (!bWarm)
+ **     {
+ **         ... configure RTC ...
+ **         Amx8x5_SaveConfigFingerprint(&stcRtcConfig,0xFE);
+ **     }
+ ** }
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_CheckWarmBoot(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, bool* pbWarmBoot)
+{
+    uint8_t au8Config[AMX8X5_REG_EXTENDED_ADDR - AMX8X5_REG_CONTROL_1 + 1];
+    uint8_t au8Fingerprint[2];
+    uint16_t u16Fingerprint;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_CheckWarmBoot");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pbWarmBoot == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    *pbWarmBoot = false;
+
+    res = Amx8x5_ReadConfig(pstcHandle,u8RamAddress,au8Config);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,(u8RamAddress & 0x3F) | 0x40,au8Fingerprint,2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u16Fingerprint = Amx8x5_ConfigFingerprint(au8Config);
+    if ((au8Fingerprint[0] == (uint8_t)(u16Fingerprint >> 8)) && (au8Fingerprint[1] == (uint8_t)(u16Fingerprint & 0xFF)))
+    {
+        *pbWarmBoot = true;
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize an interrupt dispatcher, no callbacks registered
+ **
+ ** \param  pstcDispatcher Dispatcher, see #stc_amx8x5_irq_dispatcher_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_IrqDispatcherInit(stc_amx8x5_irq_dispatcher_t* pstcDispatcher)
+{
+    if (pstcDispatcher == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcDispatcher,0,sizeof(stc_amx8x5_irq_dispatcher_t));
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Register the callback of an interrupt source
+ **
+ ** \param  pstcDispatcher Dispatcher, see #stc_amx8x5_irq_dispatcher_t
+ **
+ ** \param  enSource       Interrupt source
+ **
+ ** \param  pfnCallback    Callback, NULL to unregister
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_IrqDispatcherRegister(stc_amx8x5_irq_dispatcher_t* pstcDispatcher, en_amx8x5_irq_source_t enSource, pfn_amx8x5_irq_callback pfnCallback)
+{
+    if ((pstcDispatcher == NULL) || (enSource >= AMx8x5IrqSourceCount))
+    {
+        return ErrorInvalidParameter;
+    }
+    pstcDispatcher->apfnCallback[enSource] = pfnCallback;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Service pending interrupts
+ **
+ ** Reads STATUS once, clears all flags having a registered callback with a
+ ** single write and invokes the callbacks afterwards. Flags are cleared by
+ ** writing 0, all other flags are written as 1 so interrupts arriving
+ ** between read and write are kept. OSC_STATUS is only accessed if an
+ ** oscillator fail or autocalibration fail callback or an oscillator health
+ ** monitor (see Amx8x5_OscHealthSample()) is registered, it is then read
+ ** together with STATUS in one burst.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcDispatcher Dispatcher, see #stc_amx8x5_irq_dispatcher_t
+ **
+ ** \param  pu8Serviced    returns the serviced sources as mask of (1 << #en_amx8x5_irq_source_t), can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ** Example:
+ ** @code
+ ** static void AlarmHandler(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_irq_source_t enSource)
+ ** {
+ **     ...
+ ** }
+ **
+ ** Amx8x5_IrqDispatcherInit(&stcDispatcher);
+ ** Amx8x5_IrqDispatcherRegister(&stcDispatcher,AMx8x5IrqAlarm,AlarmHandler);
+ ** ...
+ ** Amx8x5_IrqDispatch(&stcRtcConfig,&stcDispatcher,NULL);
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_IrqDispatch(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_irq_dispatcher_t* pstcDispatcher, uint8_t* pu8Serviced)
+{
+    uint8_t au8Status[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_STATUS + 1];
+    uint8_t u8Status;
+    uint8_t u8OscStatus = 0;
+    uint8_t u8Registered = 0;
+    uint8_t u8Serviced;
+    uint8_t u8Temp;
+    bool bOscStatus;
+    int i;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_IrqDispatch");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcDispatcher == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pu8Serviced != NULL)
+    {
+        *pu8Serviced = 0;
+    }
+
+    for(i = 0; i < AMx8x5IrqSourceCount; i++)
+    {
+        if (pstcDispatcher->apfnCallback[i] != NULL)
+        {
+            u8Registered |= (1 << i);
+        }
+    }
+
+    //
+    // STATUS flags EX1..WDT map 1:1 to the sources AMx8x5IrqEx1..AMx8x5IrqWatchdog.
+    // OSC_STATUS is read in the same transaction if needed.
+    //
+    bOscStatus = ((u8Registered & ((1 << AMx8x5IrqOscillatorFail) | (1 << AMx8x5IrqAutocalibFail))) != 0) ||
+                 (pstcDispatcher->pstcOscHealth != NULL);
+    if (bOscStatus)
+    {
+        res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_STATUS,au8Status,sizeof(au8Status));
+        u8OscStatus = au8Status[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_STATUS];
+    }
+    else
+    {
+        res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_STATUS,au8Status,1);
+    }
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u8Status = au8Status[0];
+    u8Serviced = u8Status & u8Registered & 0x3F;
+    if (u8Serviced != 0)
+    {
+        //
+        // Keep CB (century), write 0 to serviced flags only.
+        //
+        u8Temp = (u8Status & AMX8X5_REG_STATUS_CB_MSK) | (~u8Serviced & 0x7F);
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_STATUS,u8Temp);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    if (bOscStatus)
+    {
+        u8Temp = 0;
+        if ((u8OscStatus & AMX8X5_REG_OSC_STATUS_OF_MSK) && (u8Registered & (1 << AMx8x5IrqOscillatorFail)))
+        {
+            u8Temp |= AMX8X5_REG_OSC_STATUS_OF_MSK;
+            u8Serviced |= (1 << AMx8x5IrqOscillatorFail);
+        }
+        if ((u8OscStatus & AMX8X5_REG_OSC_STATUS_ACF_MSK) && (u8Registered & (1 << AMx8x5IrqAutocalibFail)))
+        {
+            u8Temp |= AMX8X5_REG_OSC_STATUS_ACF_MSK;
+            u8Serviced |= (1 << AMx8x5IrqAutocalibFail);
+        }
+        if (pstcDispatcher->pstcOscHealth != NULL)
+        {
+            //
+            // The monitor counts flags set since its last sample, clear them
+            // so the next failure is counted again.
+            //
+            u8Temp |= u8OscStatus & (AMX8X5_REG_OSC_STATUS_OF_MSK | AMX8X5_REG_OSC_STATUS_ACF_MSK);
+        }
+        if (u8Temp != 0)
+        {
+            //
+            // Keep XTCAL and LKO2, write 0 to serviced flags only.
+            //
+            u8Temp = (u8OscStatus & (AMX8X5_REG_OSC_STATUS_XTCAL_MSK | AMX8X5_REG_OSC_STATUS_LKO2_MSK)) |
+                     ((AMX8X5_REG_OSC_STATUS_OF_MSK | AMX8X5_REG_OSC_STATUS_ACF_MSK) & ~u8Temp);
+            res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_OSC_STATUS,u8Temp);
+            if (res != Ok)
+            {
+                return AMX8X5_FUNC_END(res);
+            }
+        }
+        if (pstcDispatcher->pstcOscHealth != NULL)
+        {
+            res = Amx8x5_OscHealthSample(pstcHandle,pstcDispatcher->pstcOscHealth,u8OscStatus,NULL);
+            pstcDispatcher->pstcOscHealth->u8Flags = 0;
+            if (res != Ok)
+            {
+                return AMX8X5_FUNC_END(res);
+            }
+        }
+    }
+
+    //
+    // Flags are cleared, invoke the callbacks.
+    //
+    for(i = 0; i < AMx8x5IrqSourceCount; i++)
+    {
+        if (u8Serviced & (1 << i))
+        {
+            pstcDispatcher->apfnCallback[i](pstcHandle,(en_amx8x5_irq_source_t)i);
+        }
+    }
+
+    if (pu8Serviced != NULL)
+    {
+        *pu8Serviced = u8Serviced;
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize an empty event queue
+ **
+ ** \param  pstcQueue      Event queue, see #stc_amx8x5_event_queue_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_EventQueueInit(stc_amx8x5_event_queue_t* pstcQueue)
+{
+    if (pstcQueue == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    memset((void*)pstcQueue,0,sizeof(stc_amx8x5_event_queue_t));
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Add an event to the queue (producer side, e.g. nIRQ pin ISR)
+ **
+ ** Lock free for one producer and one consumer, no bus access.
+ **
+ ** \param  pstcQueue      Event queue, see #stc_amx8x5_event_queue_t
+ **
+ ** \param  u32Timestamp   Timestamp of the event (e.g. micros())
+ **
+ ** \param  u8Pin          Application defined source of the event (e.g. pin number)
+ **
+ ** \return Ok on success, ErrorBufferFull if the event was dropped
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_EventQueuePush(stc_amx8x5_event_queue_t* pstcQueue, uint32_t u32Timestamp, uint8_t u8Pin)
+{
+    uint8_t u8Head;
+    stc_amx8x5_event_t* pstcEvent;
+
+    if (pstcQueue == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    u8Head = pstcQueue->u8Head;
+    if ((uint8_t)(u8Head - pstcQueue->u8Tail) >= AMX8X5_EVENT_QUEUE_SIZE)
+    {
+        if (pstcQueue->u8Dropped != 0xFF)
+        {
+            pstcQueue->u8Dropped++;
+        }
+        return ErrorBufferFull;
+    }
+
+    pstcEvent = (stc_amx8x5_event_t*)&pstcQueue->astcEvent[u8Head & (AMX8X5_EVENT_QUEUE_SIZE - 1)];
+    pstcEvent->u32Timestamp = u32Timestamp;
+    pstcEvent->u8Pin = u8Pin;
+
+    //
+    // Publish the event after its content is written.
+    //
+    AMX8X5_MEMORY_BARRIER();
+    pstcQueue->u8Head = u8Head + 1;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Take the oldest event from the queue (consumer side, task context)
+ **
+ ** \param  pstcQueue      Event queue, see #stc_amx8x5_event_queue_t
+ **
+ ** \param  pstcEvent      returns the event, can be NULL to discard it
+ **
+ ** \return Ok on success, ErrorNotReady if the queue is empty
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_EventQueuePop(stc_amx8x5_event_queue_t* pstcQueue, stc_amx8x5_event_t* pstcEvent)
+{
+    uint8_t u8Tail;
+    volatile stc_amx8x5_event_t* pstcSlot;
+
+    if (pstcQueue == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    u8Tail = pstcQueue->u8Tail;
+    if (pstcQueue->u8Head == u8Tail)
+    {
+        return ErrorNotReady;
+    }
+
+    //
+    // Read the event only after the producer published it.
+    //
+    AMX8X5_MEMORY_BARRIER();
+    pstcSlot = &pstcQueue->astcEvent[u8Tail & (AMX8X5_EVENT_QUEUE_SIZE - 1)];
+    if (pstcEvent != NULL)
+    {
+        pstcEvent->u32Timestamp = pstcSlot->u32Timestamp;
+        pstcEvent->u8Pin = pstcSlot->u8Pin;
+    }
+
+    //
+    // Release the slot after it was read.
+    //
+    AMX8X5_MEMORY_BARRIER();
+    pstcQueue->u8Tail = u8Tail + 1;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Drain the event queue and service the RTC interrupts
+ **
+ ** All queued events are removed, if at least one was queued the interrupts
+ ** are serviced with one Amx8x5_IrqDispatch() call. Call from task context.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcQueue      Event queue, see #stc_amx8x5_event_queue_t
+ **
+ ** \param  pstcDispatcher Dispatcher, see #stc_amx8x5_irq_dispatcher_t
+ **
+ ** \param  pstcLastEvent  returns the most recent event, can be NULL
+ **
+ ** \param  pu8Serviced    returns the serviced sources as mask of (1 << #en_amx8x5_irq_source_t), can be NULL
+ **
+ ** \return Ok on success, ErrorNotReady if no event was queued, else the Error as en_result_t
+ **
+ ** Example:
+ ** @code
+ ** static stc_amx8x5_event_queue_t stcQueue;
+ **
+ ** void RtcIsr(void)
+ ** {
+ **     Amx8x5_EventQueuePush(&stcQueue,micros(),0);
+ ** }
+ **
+ ** void RtcTask(void)
+ ** {
+ **     Amx8x5_EventQueueDispatch(&stcRtcConfig,&stcQueue,&stcDispatcher,NULL,NULL);
+ ** }
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_EventQueueDispatch(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_event_queue_t* pstcQueue, stc_amx8x5_irq_dispatcher_t* pstcDispatcher, stc_amx8x5_event_t* pstcLastEvent, uint8_t* pu8Serviced)
+{
+    stc_amx8x5_event_t stcEvent;
+    bool bPending = false;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_EventQueueDispatch");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcQueue == NULL) || (pstcDispatcher == NULL))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pu8Serviced != NULL)
+    {
+        *pu8Serviced = 0;
+    }
+
+    while(Amx8x5_EventQueuePop(pstcQueue,&stcEvent) == Ok)
+    {
+        bPending = true;
+    }
+    if (bPending == false)
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+    if (pstcLastEvent != NULL)
+    {
+        *pstcLastEvent = stcEvent;
+    }
+    return AMX8X5_FUNC_END(Amx8x5_IrqDispatch(pstcHandle,pstcDispatcher,pu8Serviced));
+}
+
+
+/**
+ ******************************************************************************
+ ** \brief  Convert a time structure to seconds since 2000-01-01 00:00:00
+ **
+ ** Valid for the years 2000..2099 (u8Year 0..99). u8Mode #AMX8X5_24HR_MODE
+ ** takes the hour as is, #AMX8X5_12HR_MODE as PM and 0 as AM hour 1..12 of
+ ** the 12-hour mode (12 AM is midnight, 12 PM is noon).
+ **
+ ** \param  pstcTime       Time, see #stc_amx8x5_time_t
+ **
+ ** \param  pu32Seconds    returns the seconds
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TimeToSeconds(stc_amx8x5_time_t* pstcTime, uint32_t* pu32Seconds)
+{
+    uint32_t u32Days;
+    uint8_t u8Hour;
+
+    if ((pstcTime == NULL) || (pu32Seconds == NULL))
+    {
+        return ErrorInvalidParameter;
+    }
+    if ((pstcTime->u8Year > 99) || (pstcTime->u8Month < 1) || (pstcTime->u8Month > 12) || (pstcTime->u8Date < 1) || (pstcTime->u8Date > 31))
+    {
+        return ErrorInvalidParameter;
+    }
+
+    u8Hour = pstcTime->u8Hour;
+    if (pstcTime->u8Mode == AMX8X5_12HR_MODE)
+    {
+        u8Hour = (u8Hour % 12) + 12;
+    }
+    else if (pstcTime->u8Mode != AMX8X5_24HR_MODE)
+    {
+        u8Hour = u8Hour % 12;
+    }
+
+    //
+    // Days of the complete years, 2000 is a leap year.
+    //
+    u32Days = 365UL * pstcTime->u8Year + ((pstcTime->u8Year + 3) >> 2);
+    u32Days += au16DaysBeforeMonth[pstcTime->u8Month - 1];
+    if (((pstcTime->u8Year & 0x3) == 0) && (pstcTime->u8Month > 2))
+    {
+        u32Days++;
+    }
+    u32Days += pstcTime->u8Date - 1;
+
+    *pu32Seconds = ((u32Days * 24 + u8Hour) * 60 + pstcTime->u8Minute) * 60 + pstcTime->u8Second;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Convert seconds since 2000-01-01 00:00:00 to a time structure
+ **
+ ** The result is in 24-hour mode, hundredths are 0, weekday 0 is Sunday.
+ **
+ ** \param  u32Seconds     Seconds, max. end of year 2099
+ **
+ ** \param  pstcTime       returns the time, see #stc_amx8x5_time_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SecondsToTime(uint32_t u32Seconds, stc_amx8x5_time_t* pstcTime)
+{
+    uint32_t u32Days;
+    uint16_t u16DaysOfYear;
+    uint8_t u8Year = 0;
+    uint8_t u8Month = 1;
+    uint8_t u8Leap;
+
+    if (pstcTime == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+
+    u32Days = u32Seconds / 86400UL;
+    if (u32Days >= 36525UL)
+    {
+        return ErrorInvalidParameter;
+    }
+    u32Seconds -= u32Days * 86400UL;
+
+    pstcTime->u8Hundredth = 0;
+    pstcTime->u8Hour = (uint8_t)(u32Seconds / 3600);
+    u32Seconds -= (uint32_t)pstcTime->u8Hour * 3600;
+    pstcTime->u8Minute = (uint8_t)(u32Seconds / 60);
+    pstcTime->u8Second = (uint8_t)(u32Seconds - (uint32_t)pstcTime->u8Minute * 60);
+
+    //
+    // 2000-01-01 was a Saturday.
+    //
+    pstcTime->u8Weekday = (uint8_t)((u32Days + 6) % 7);
+
+    //
+    // Complete 4 year blocks, then single years.
+    //
+    u8Year = (uint8_t)(u32Days / 1461) * 4;
+    u32Days -= (uint32_t)(u8Year / 4) * 1461;
+    while(1)
+    {
+        u16DaysOfYear = ((u8Year & 0x3) == 0) ? 366 : 365;
+        if (u32Days < u16DaysOfYear)
+        {
+            break;
+        }
+        u32Days -= u16DaysOfYear;
+        u8Year++;
+    }
+    u8Leap = ((u8Year & 0x3) == 0) ? 1 : 0;
+    while((u8Month < 12) && (u32Days >= (uint32_t)au16DaysBeforeMonth[u8Month] + ((u8Month >= 2) ? u8Leap : 0)))
+    {
+        u8Month++;
+    }
+    u32Days -= au16DaysBeforeMonth[u8Month - 1] + ((u8Month > 2) ? u8Leap : 0);
+
+    pstcTime->u8Date = (uint8_t)(u32Days + 1);
+    pstcTime->u8Month = u8Month;
+    pstcTime->u8Year = u8Year;
+    pstcTime->u8Century = 1;
+    pstcTime->u8Mode = AMX8X5_24HR_MODE;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Convert a 24-hour time to the 12-hour mode
+ **
+ ** \param  pstcTime       Time, u8Hour 0..23, returns hour 1..12 and u8Mode
+ **                        #AMX8X5_12HR_MODE for PM, 0 for AM
+ **
+ ******************************************************************************/
+static void Amx8x5_TimeTo12Hour(stc_amx8x5_time_t* pstcTime)
+{
+    pstcTime->u8Mode = (pstcTime->u8Hour >= 12) ? AMX8X5_12HR_MODE : 0;
+    pstcTime->u8Hour = pstcTime->u8Hour % 12;
+    if (pstcTime->u8Hour == 0)
+    {
+        pstcTime->u8Hour = 12;
+    }
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Read the RTC time as seconds since 2000-01-01 00:00:00
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pu32Seconds    returns the seconds
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_GetSeconds(stc_amx8x5_handle_t* pstcHandle, uint32_t* pu32Seconds)
+{
+    stc_amx8x5_time_t* pstcTime;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_GetSeconds");
+
+    res = Amx8x5_GetTime(pstcHandle,&pstcTime);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_TimeToSeconds(pstcTime,pu32Seconds));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Convert a 24-hour alarm time to the 12/24 mode of the RTC
+ **
+ ** The alarm hour is compared in the mode selected by the 12/24 bit of
+ ** CONTROL_1, Amx8x5_SecondsToTime() always returns the 24-hour mode.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcAlarm      Alarm time in 24-hour mode, converted in place
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_AlarmToHourMode(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcAlarm)
+{
+    uint8_t u8Control1;
+    en_result_t res;
+
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_CONTROL_1,&u8Control1);
+    if (res != Ok)
+    {
+        return res;
+    }
+    if ((u8Control1 & AMX8X5_REG_CONTROL_1_12_24_MSK) != 0)
+    {
+        Amx8x5_TimeTo12Hour(pstcAlarm);
+    }
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Move a software alarm up in the heap until its parent is earlier
+ **
+ ******************************************************************************/
+static void Amx8x5_SwAlarmSiftUp(stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Index)
+{
+    stc_amx8x5_swalarm_entry_t stcEntry = pstcSwAlarm->astcHeap[u8Index];
+    uint8_t u8Parent;
+    while(u8Index > 0)
+    {
+        u8Parent = (u8Index - 1) / 2;
+        if (pstcSwAlarm->astcHeap[u8Parent].u32Deadline <= stcEntry.u32Deadline)
+        {
+            break;
+        }
+        pstcSwAlarm->astcHeap[u8Index] = pstcSwAlarm->astcHeap[u8Parent];
+        u8Index = u8Parent;
+    }
+    pstcSwAlarm->astcHeap[u8Index] = stcEntry;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Move a software alarm down in the heap until its children are later
+ **
+ ******************************************************************************/
+static void Amx8x5_SwAlarmSiftDown(stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Index)
+{
+    stc_amx8x5_swalarm_entry_t stcEntry = pstcSwAlarm->astcHeap[u8Index];
+    uint8_t u8Child;
+    while(1)
+    {
+        u8Child = 2 * u8Index + 1;
+        if (u8Child >= pstcSwAlarm->u8Count)
+        {
+            break;
+        }
+        if (((u8Child + 1) < pstcSwAlarm->u8Count) && (pstcSwAlarm->astcHeap[u8Child + 1].u32Deadline < pstcSwAlarm->astcHeap[u8Child].u32Deadline))
+        {
+            u8Child++;
+        }
+        if (stcEntry.u32Deadline <= pstcSwAlarm->astcHeap[u8Child].u32Deadline)
+        {
+            break;
+        }
+        pstcSwAlarm->astcHeap[u8Index] = pstcSwAlarm->astcHeap[u8Child];
+        u8Index = u8Child;
+    }
+    pstcSwAlarm->astcHeap[u8Index] = stcEntry;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Remove the software alarm at a heap position
+ **
+ ******************************************************************************/
+static void Amx8x5_SwAlarmRemoveAt(stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Index)
+{
+    pstcSwAlarm->u8Count--;
+    if (u8Index == pstcSwAlarm->u8Count)
+    {
+        return;
+    }
+    pstcSwAlarm->astcHeap[u8Index] = pstcSwAlarm->astcHeap[pstcSwAlarm->u8Count];
+    Amx8x5_SwAlarmSiftDown(pstcSwAlarm,u8Index);
+    Amx8x5_SwAlarmSiftUp(pstcSwAlarm,u8Index);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Program the hardware alarm with the earliest software alarm
+ **
+ ** Deadlines in the past are armed one second ahead, deadlines more than
+ ** #AMX8X5_SWALARM_MAX_ARM seconds ahead are armed at that limit and
+ ** rearmed when it is reached. The hardware is only written if the target
+ ** changes, after the first arm via Amx8x5_AlarmRearm() with the alarm time
+ ** only. If the second boundary passed the target while arming, the
+ ** alarm is armed again.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSwAlarm    Software alarms
+ **
+ ** \param  u32Now         Current RTC time in seconds since 2000
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_SwAlarmArm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint32_t u32Now)
+{
+    stc_amx8x5_time_t stcAlarm;
+    uint32_t u32Target;
+    int i;
+    en_result_t res;
+
+    for(i = 0; i < 3; i++)
+    {
+        if (pstcSwAlarm->u8Count == 0)
+        {
+            if (pstcSwAlarm->u32Armed != 0)
+            {
+                memset(&stcAlarm,0,sizeof(stcAlarm));
+                res = Amx8x5_AlarmRearm(pstcHandle,&pstcSwAlarm->stcConfig,&stcAlarm,AMx8x5AlarmDisabled,pstcSwAlarm->enModeIrq,pstcSwAlarm->enModePin);
+                if (res != Ok)
+                {
+                    return res;
+                }
+                pstcSwAlarm->u32Armed = 0;
+            }
+            return Ok;
+        }
+
+        u32Target = pstcSwAlarm->astcHeap[0].u32Deadline;
+        if (u32Target <= u32Now)
+        {
+            u32Target = u32Now + 1;
+        }
+        if ((u32Target - u32Now) > AMX8X5_SWALARM_MAX_ARM)
+        {
+            u32Target = u32Now + AMX8X5_SWALARM_MAX_ARM;
+        }
+        if (u32Target != pstcSwAlarm->u32Armed)
+        {
+            //
+            // Match month, date, hour, minute, second: once per year.
+            //
+            res = Amx8x5_SecondsToTime(u32Target,&stcAlarm);
+            if (res != Ok)
+            {
+                return res;
+            }
+            res = Amx8x5_AlarmToHourMode(pstcHandle,&stcAlarm);
+            if (res != Ok)
+            {
+                return res;
+            }
+            res = Amx8x5_AlarmRearm(pstcHandle,&pstcSwAlarm->stcConfig,&stcAlarm,AMx8x5AlarmYear,pstcSwAlarm->enModeIrq,pstcSwAlarm->enModePin);
+            if (res != Ok)
+            {
+                return res;
+            }
+            pstcSwAlarm->u32Armed = u32Target;
+        }
+        if ((u32Target - u32Now) > 1)
+        {
+            return Ok;
+        }
+
+        //
+        // Target is the next second: check it was not passed while arming.
+        //
+        res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+        if (res != Ok)
+        {
+            return res;
+        }
+        if (u32Now < u32Target)
+        {
+            return Ok;
+        }
+    }
+    return ErrorTimeout;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize the software alarms
+ **
+ ** Software alarms multiplex any number of deadlines (max.
+ ** #AMX8X5_SWALARM_MAX) onto the single hardware alarm. They are kept in a
+ ** min-heap and the hardware alarm is always armed with the earliest one.
+ **
+ ** \param  pstcSwAlarm    Software alarms, see #stc_amx8x5_swalarm_t
+ **
+ ** \param  enModeIrq      Interrupt mode of the hardware alarm
+ **
+ ** \param  enModePin      Interrupt pin of the hardware alarm
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SwAlarmInit(stc_amx8x5_swalarm_t* pstcSwAlarm, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin)
+{
+    if (pstcSwAlarm == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcSwAlarm,0,sizeof(stc_amx8x5_swalarm_t));
+    pstcSwAlarm->enModeIrq = enModeIrq;
+    pstcSwAlarm->enModePin = enModePin;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start (or restart) a software alarm
+ **
+ ** An alarm with the same ID is replaced. The hardware alarm is only
+ ** reprogrammed if the new alarm becomes the earliest one.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSwAlarm    Software alarms, see #stc_amx8x5_swalarm_t
+ **
+ ** \param  u8Id           Application defined ID
+ **
+ ** \param  u32Deadline    Deadline in seconds since 2000, see Amx8x5_TimeToSeconds()
+ **
+ ** \param  pfnCallback    Called by Amx8x5_SwAlarmService() when the deadline is reached
+ **
+ ** \return Ok on success, ErrorBufferFull if #AMX8X5_SWALARM_MAX alarms are active, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SwAlarmStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Id, uint32_t u32Deadline, pfn_amx8x5_swalarm_callback pfnCallback)
+{
+    uint32_t u32Now;
+    uint32_t u32Earliest = 0;
+    uint8_t i;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SwAlarmStart");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcSwAlarm == NULL) || (pfnCallback == NULL))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pstcSwAlarm->u8Count > 0)
+    {
+        u32Earliest = pstcSwAlarm->astcHeap[0].u32Deadline;
+    }
+
+    for(i = 0; i < pstcSwAlarm->u8Count; i++)
+    {
+        if (pstcSwAlarm->astcHeap[i].u8Id == u8Id)
+        {
+            Amx8x5_SwAlarmRemoveAt(pstcSwAlarm,i);
+            break;
+        }
+    }
+    if (pstcSwAlarm->u8Count >= AMX8X5_SWALARM_MAX)
+    {
+        return AMX8X5_FUNC_END(ErrorBufferFull);
+    }
+    i = pstcSwAlarm->u8Count++;
+    pstcSwAlarm->astcHeap[i].u32Deadline = u32Deadline;
+    pstcSwAlarm->astcHeap[i].pfnCallback = pfnCallback;
+    pstcSwAlarm->astcHeap[i].u8Id = u8Id;
+    Amx8x5_SwAlarmSiftUp(pstcSwAlarm,i);
+
+    if (pstcSwAlarm->bServicing)
+    {
+        //
+        // Called from a callback, Amx8x5_SwAlarmService() arms at the end.
+        //
+        return AMX8X5_FUNC_END(Ok);
+    }
+    if ((pstcSwAlarm->u32Armed != 0) && (pstcSwAlarm->astcHeap[0].u32Deadline == u32Earliest))
+    {
+        //
+        // Earliest deadline unchanged, hardware alarm still valid.
+        //
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_SwAlarmArm(pstcHandle,pstcSwAlarm,u32Now));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Stop a software alarm
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSwAlarm    Software alarms, see #stc_amx8x5_swalarm_t
+ **
+ ** \param  u8Id           ID used with Amx8x5_SwAlarmStart()
+ **
+ ** \return Ok on success, ErrorInvalidParameter if the alarm is not active, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SwAlarmStop(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Id)
+{
+    uint32_t u32Now;
+    uint8_t i;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SwAlarmStop");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcSwAlarm == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    for(i = 0; i < pstcSwAlarm->u8Count; i++)
+    {
+        if (pstcSwAlarm->astcHeap[i].u8Id == u8Id)
+        {
+            break;
+        }
+    }
+    if (i == pstcSwAlarm->u8Count)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    Amx8x5_SwAlarmRemoveAt(pstcSwAlarm,i);
+    if ((i != 0) || pstcSwAlarm->bServicing)
+    {
+        //
+        // Earliest deadline unchanged, or called from a callback and
+        // Amx8x5_SwAlarmService() arms at the end.
+        //
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_SwAlarmArm(pstcHandle,pstcSwAlarm,u32Now));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Fire all expired software alarms and rearm the hardware alarm
+ **
+ ** Call when the alarm interrupt occurred, e.g. from an
+ ** #AMx8x5IrqAlarm callback of the interrupt dispatcher. Expired alarms are
+ ** removed before their callback is called, so a callback can start its
+ ** alarm again. Only the alarms expired when the service starts are fired,
+ ** an alarm restarted with a deadline already passed fires with the next
+ ** service, one second later. Start and stop from a callback do not access
+ ** the bus, the hardware alarm is armed once at the end.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSwAlarm    Software alarms, see #stc_amx8x5_swalarm_t
+ **
+ ** \param  pu8Fired       returns the number of fired alarms, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SwAlarmService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t* pu8Fired)
+{
+    stc_amx8x5_swalarm_entry_t astcDue[AMX8X5_SWALARM_MAX];
+    stc_amx8x5_swalarm_entry_t stcEntry;
+    uint32_t u32Now;
+    uint8_t u8Due = 0;
+    uint8_t u8Fired = 0;
+    uint8_t i;
+    uint8_t j;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SwAlarmService");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcSwAlarm == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // Snapshot the due alarms in deadline order, alarms (re)started by the
+    // callbacks wait for the next service even if already due.
+    //
+    for(i = 0; i < pstcSwAlarm->u8Count; i++)
+    {
+        if (pstcSwAlarm->astcHeap[i].u32Deadline <= u32Now)
+        {
+            stcEntry = pstcSwAlarm->astcHeap[i];
+            for(j = u8Due; (j > 0) && (astcDue[j - 1].u32Deadline > stcEntry.u32Deadline); j--)
+            {
+                astcDue[j] = astcDue[j - 1];
+            }
+            astcDue[j] = stcEntry;
+            u8Due++;
+        }
+    }
+
+    //
+    // Start and stop only update the heap while the callbacks run,
+    // the hardware alarm is armed once at the end.
+    //
+    pstcSwAlarm->bServicing = true;
+    for(i = 0; i < u8Due; i++)
+    {
+        //
+        // Skip alarms stopped or restarted by an earlier callback.
+        //
+        for(j = 0; j < pstcSwAlarm->u8Count; j++)
+        {
+            if ((pstcSwAlarm->astcHeap[j].u8Id == astcDue[i].u8Id) && (pstcSwAlarm->astcHeap[j].u32Deadline == astcDue[i].u32Deadline) &&
+                (pstcSwAlarm->astcHeap[j].pfnCallback == astcDue[i].pfnCallback))
+            {
+                break;
+            }
+        }
+        if (j == pstcSwAlarm->u8Count)
+        {
+            continue;
+        }
+        Amx8x5_SwAlarmRemoveAt(pstcSwAlarm,j);
+        astcDue[i].pfnCallback(pstcHandle,astcDue[i].u8Id,astcDue[i].u32Deadline);
+        u8Fired++;
+    }
+    pstcSwAlarm->bServicing = false;
+    if (pu8Fired != NULL)
+    {
+        *pu8Fired = u8Fired;
+    }
+
+    return AMX8X5_FUNC_END(Amx8x5_SwAlarmArm(pstcHandle,pstcSwAlarm,u32Now));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Number of days of a month
+ **
+ ******************************************************************************/
+static uint8_t Amx8x5_DaysInMonth(uint8_t u8Year, uint8_t u8Month)
+{
+    if (u8Month == 12)
+    {
+        return 31;
+    }
+    if ((u8Month == 2) && ((u8Year & 0x3) == 0))
+    {
+        return 29;
+    }
+    return (uint8_t)(au16DaysBeforeMonth[u8Month] - au16DaysBeforeMonth[u8Month - 1]);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  First set bit of a mask in the range u8Start..u8End - 1
+ **
+ ** \return bit position, u8End if none is set
+ **
+ ******************************************************************************/
+static uint8_t Amx8x5_NextBit(uint64_t u64Mask, uint8_t u8Start, uint8_t u8End)
+{
+    u64Mask >>= u8Start;
+    while((u8Start < u8End) && ((u64Mask & 1) == 0))
+    {
+        u64Mask >>= 1;
+        u8Start++;
+    }
+    return u8Start;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a schedule to fire every minute
+ **
+ ** Narrow the fields afterwards, e.g. daily at 02:30:
+ ** @code
+ ** Amx8x5_ScheduleInit(&stcSchedule);
+ ** stcSchedule.u64Minute = 1ULL << 30;
+ ** stcSchedule.u32Hour = 1UL << 2;
+ ** @endcode
+ **
+ ** \param  pstcSchedule   Schedule, see #stc_amx8x5_schedule_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_ScheduleInit(stc_amx8x5_schedule_t* pstcSchedule)
+{
+    if (pstcSchedule == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    pstcSchedule->u64Minute = AMX8X5_SCHEDULE_MINUTE_ALL;
+    pstcSchedule->u32Hour = AMX8X5_SCHEDULE_HOUR_ALL;
+    pstcSchedule->u32Date = AMX8X5_SCHEDULE_DATE_ALL;
+    pstcSchedule->u16Month = AMX8X5_SCHEDULE_MONTH_ALL;
+    pstcSchedule->u8Weekday = AMX8X5_SCHEDULE_WEEKDAY_ALL;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Calculate the next fire time of a schedule
+ **
+ ** A time matches if minute, hour, date, month and weekday are all set in
+ ** the schedule. Each field is found by a bit scan from the current value:
+ ** the month in the month mask, the day in the date mask AND the weekday
+ ** mask shifted to the first weekday of that month, then hour and minute.
+ ** A field without a match carries into the next higher one, so the cost
+ ** does not depend on how far ahead the next match is.
+ **
+ ** \param  pstcSchedule   Schedule, see #stc_amx8x5_schedule_t
+ **
+ ** \param  u32Now         Current time in seconds since 2000
+ **
+ ** \param  pu32Next       returns the first matching time after u32Now (second 0)
+ **
+ ** \return Ok on success, ErrorInvalidParameter if nothing matches within #AMX8X5_SCHEDULE_MAX_DAYS, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_ScheduleNext(stc_amx8x5_schedule_t* pstcSchedule, uint32_t u32Now, uint32_t* pu32Next)
+{
+    stc_amx8x5_time_t stcTime;
+    uint64_t u64Weekdays;
+    uint32_t u32Dates;
+    uint16_t u16Days = 0;
+    uint8_t u8StartWeekday;
+    uint8_t u8DaysInMonth;
+    uint8_t u8First;
+    uint8_t u8Leap;
+    uint8_t u8Month;
+    uint8_t u8Date;
+    uint8_t u8Hour;
+    uint8_t u8Minute;
+    en_result_t res;
+
+    if ((pstcSchedule == NULL) || (pu32Next == NULL))
+    {
+        return ErrorInvalidParameter;
+    }
+    if (((pstcSchedule->u64Minute & AMX8X5_SCHEDULE_MINUTE_ALL) == 0) || ((pstcSchedule->u32Hour & AMX8X5_SCHEDULE_HOUR_ALL) == 0))
+    {
+        return ErrorInvalidParameter;
+    }
+
+    //
+    // Start at the next full minute, u16Days counts the days from there.
+    //
+    res = Amx8x5_SecondsToTime((u32Now / 60 + 1) * 60,&stcTime);
+    if (res != Ok)
+    {
+        return res;
+    }
+    u8StartWeekday = stcTime.u8Weekday;
+
+    while(u16Days < AMX8X5_SCHEDULE_MAX_DAYS)
+    {
+        //
+        // Month: skip to the next one in the mask, past December to the
+        // next year.
+        //
+        u8Leap = ((stcTime.u8Year & 0x3) == 0) ? 1 : 0;
+        u8Month = Amx8x5_NextBit(pstcSchedule->u16Month,stcTime.u8Month,13);
+        if (u8Month != stcTime.u8Month)
+        {
+            u16Days += ((u8Month > 12) ? (365 + u8Leap) : (au16DaysBeforeMonth[u8Month - 1] + ((u8Month > 2) ? u8Leap : 0))) -
+                       (au16DaysBeforeMonth[stcTime.u8Month - 1] + ((stcTime.u8Month > 2) ? u8Leap : 0) + stcTime.u8Date - 1);
+            stcTime.u8Date = 1;
+            stcTime.u8Hour = 0;
+            stcTime.u8Minute = 0;
+            if (u8Month > 12)
+            {
+                if (stcTime.u8Year == 99)
+                {
+                    break;
+                }
+                stcTime.u8Year++;
+                stcTime.u8Month = 1;
+                continue;
+            }
+            stcTime.u8Month = u8Month;
+        }
+
+        //
+        // Dates of this month with a matching weekday: the weekday mask
+        // rotated to the weekday of the 1st and repeated every 7 days.
+        //
+        u8DaysInMonth = Amx8x5_DaysInMonth(stcTime.u8Year,stcTime.u8Month);
+        u8First = (uint8_t)((u8StartWeekday + u16Days + 35 - (stcTime.u8Date - 1)) % 7);
+        u64Weekdays = pstcSchedule->u8Weekday & AMX8X5_SCHEDULE_WEEKDAY_ALL;
+        u64Weekdays = ((u64Weekdays >> u8First) | (u64Weekdays << (7 - u8First))) & 0x7F;
+        u64Weekdays |= u64Weekdays << 7;
+        u64Weekdays |= u64Weekdays << 14;
+        u64Weekdays |= u64Weekdays << 28;
+        u32Dates = pstcSchedule->u32Date & (uint32_t)(u64Weekdays << 1) & (uint32_t)((2ULL << u8DaysInMonth) - 2);
+
+        //
+        // Day, hour and minute, each carrying into the next when exhausted.
+        //
+        u8Date = Amx8x5_NextBit(u32Dates,stcTime.u8Date,u8DaysInMonth + 1);
+        u8Hour = 24;
+        u8Minute = 60;
+        if (u8Date == stcTime.u8Date)
+        {
+            u8Hour = Amx8x5_NextBit(pstcSchedule->u32Hour,stcTime.u8Hour,24);
+            if (u8Hour == stcTime.u8Hour)
+            {
+                u8Minute = Amx8x5_NextBit(pstcSchedule->u64Minute,stcTime.u8Minute,60);
+                if (u8Minute == 60)
+                {
+                    u8Hour = Amx8x5_NextBit(pstcSchedule->u32Hour,stcTime.u8Hour + 1,24);
+                }
+            }
+            if (u8Hour == 24)
+            {
+                u8Date = Amx8x5_NextBit(u32Dates,u8Date + 1,u8DaysInMonth + 1);
+            }
+        }
+        if (u8Date <= u8DaysInMonth)
+        {
+            if (u8Date != stcTime.u8Date)
+            {
+                u8Hour = Amx8x5_NextBit(pstcSchedule->u32Hour,0,24);
+            }
+            if ((u8Date != stcTime.u8Date) || (u8Hour != stcTime.u8Hour) || (u8Minute == 60))
+            {
+                u8Minute = Amx8x5_NextBit(pstcSchedule->u64Minute,0,60);
+            }
+            u16Days += u8Date - stcTime.u8Date;
+            if (u16Days >= AMX8X5_SCHEDULE_MAX_DAYS)
+            {
+                break;
+            }
+            stcTime.u8Date = u8Date;
+            stcTime.u8Hour = u8Hour;
+            stcTime.u8Minute = u8Minute;
+            stcTime.u8Second = 0;
+            stcTime.u8Mode = AMX8X5_24HR_MODE;
+            return Amx8x5_TimeToSeconds(&stcTime,pu32Next);
+        }
+
+        //
+        // No day left: 1st of the next month, 00:00.
+        //
+        u16Days += u8DaysInMonth - stcTime.u8Date + 1;
+        stcTime.u8Date = 1;
+        stcTime.u8Hour = 0;
+        stcTime.u8Minute = 0;
+        if (stcTime.u8Month < 12)
+        {
+            stcTime.u8Month++;
+            continue;
+        }
+        if (stcTime.u8Year == 99)
+        {
+            break;
+        }
+        stcTime.u8Year++;
+        stcTime.u8Month = 1;
+    }
+    return ErrorInvalidParameter;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Map a schedule onto a repeating hardware alarm
+ **
+ ** Possible if the schedule is "every minute", or one fixed minute per
+ ** hour, day (optionally one weekday), month or year.
+ **
+ ** \param  pstcSchedule   Schedule, see #stc_amx8x5_schedule_t
+ **
+ ** \param  pstcAlarm      returns the alarm time for Amx8x5_SetAlarm()
+ **
+ ** \param  penRepeat      returns the alarm repeat for Amx8x5_SetAlarm()
+ **
+ ** \return Ok on success, ErrorInvalidMode if the schedule has no hardware repeat, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_ScheduleToAlarm(stc_amx8x5_schedule_t* pstcSchedule, stc_amx8x5_time_t* pstcAlarm, en_amx8x5_alarm_repeat_t* penRepeat)
+{
+    uint64_t u64Minute;
+    uint32_t u32Hour;
+    uint32_t u32Date;
+    uint16_t u16Month;
+    uint8_t u8Weekday;
+    en_amx8x5_alarm_repeat_t enRepeat;
+
+    if ((pstcSchedule == NULL) || (pstcAlarm == NULL) || (penRepeat == NULL))
+    {
+        return ErrorInvalidParameter;
+    }
+
+    u64Minute = pstcSchedule->u64Minute & AMX8X5_SCHEDULE_MINUTE_ALL;
+    u32Hour = pstcSchedule->u32Hour & AMX8X5_SCHEDULE_HOUR_ALL;
+    u32Date = pstcSchedule->u32Date & AMX8X5_SCHEDULE_DATE_ALL;
+    u16Month = pstcSchedule->u16Month & AMX8X5_SCHEDULE_MONTH_ALL;
+    u8Weekday = pstcSchedule->u8Weekday & AMX8X5_SCHEDULE_WEEKDAY_ALL;
+
+    //
+    // Fields are either all (don't care) or a single value (match).
+    //
+    #define AMX8X5_IS_SINGLE(x) (((x) != 0) && (((x) & ((x) - 1)) == 0))
+    enRepeat = AMx8x5AlarmDisabled;
+    if ((u64Minute == AMX8X5_SCHEDULE_MINUTE_ALL) && (u32Hour == AMX8X5_SCHEDULE_HOUR_ALL) && (u32Date == AMX8X5_SCHEDULE_DATE_ALL) &&
+        (u16Month == AMX8X5_SCHEDULE_MONTH_ALL) && (u8Weekday == AMX8X5_SCHEDULE_WEEKDAY_ALL))
+    {
+        enRepeat = AMx8x5AlarmMinute;
+    }
+    else if (!AMX8X5_IS_SINGLE(u64Minute))
+    {
+        // no hardware repeat
+    }
+    else if ((u32Hour == AMX8X5_SCHEDULE_HOUR_ALL) && (u32Date == AMX8X5_SCHEDULE_DATE_ALL) &&
+             (u16Month == AMX8X5_SCHEDULE_MONTH_ALL) && (u8Weekday == AMX8X5_SCHEDULE_WEEKDAY_ALL))
+    {
+        enRepeat = AMx8x5AlarmHour;
+    }
+    else if (!AMX8X5_IS_SINGLE(u32Hour))
+    {
+        // no hardware repeat
+    }
+    else if ((u32Date == AMX8X5_SCHEDULE_DATE_ALL) && (u16Month == AMX8X5_SCHEDULE_MONTH_ALL))
+    {
+        if (u8Weekday == AMX8X5_SCHEDULE_WEEKDAY_ALL)
+        {
+            enRepeat = AMx8x5AlarmDay;
+        }
+        else if (AMX8X5_IS_SINGLE(u8Weekday))
+        {
+            enRepeat = AMx8x5AlarmWeek;
+        }
+    }
+    else if (AMX8X5_IS_SINGLE(u32Date) && (u8Weekday == AMX8X5_SCHEDULE_WEEKDAY_ALL))
+    {
+        if (u16Month == AMX8X5_SCHEDULE_MONTH_ALL)
+        {
+            enRepeat = AMx8x5AlarmMonth;
+        }
+        else if (AMX8X5_IS_SINGLE(u16Month))
+        {
+            enRepeat = AMx8x5AlarmYear;
+        }
+    }
+    #undef AMX8X5_IS_SINGLE
+
+    if (enRepeat == AMx8x5AlarmDisabled)
+    {
+        return ErrorInvalidMode;
+    }
+
+    memset(pstcAlarm,0,sizeof(stc_amx8x5_time_t));
+    pstcAlarm->u8Mode = AMX8X5_24HR_MODE;
+    pstcAlarm->u8Minute = Amx8x5_NextBit(u64Minute,0,60) % 60;
+    pstcAlarm->u8Hour = Amx8x5_NextBit(u32Hour,0,24) % 24;
+    pstcAlarm->u8Date = Amx8x5_NextBit(u32Date,1,32) % 32;
+    pstcAlarm->u8Month = Amx8x5_NextBit(u16Month,1,13) % 13;
+    pstcAlarm->u8Weekday = Amx8x5_NextBit(u8Weekday,0,7) % 7;
+    *penRepeat = enRepeat;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Arm the hardware alarm for a schedule
+ **
+ ** If the schedule maps onto a hardware repeat (see Amx8x5_ScheduleToAlarm())
+ ** the RTC re-fires on its own and *pbHardwareRepeat returns true. Otherwise
+ ** the alarm is armed once for the next fire time and this function has to
+ ** be called again from the alarm interrupt. Fire times more than
+ ** #AMX8X5_SWALARM_MAX_ARM seconds ahead are armed at that limit, compare
+ ** the time with *pu32Next before running the job.
+ **
+ ** \param  pstcHandle       RTC Handle
+ **
+ ** \param  pstcSchedule     Schedule, see #stc_amx8x5_schedule_t
+ **
+ ** \param  enModeIrq        Interrupt mode of the hardware alarm
+ **
+ ** \param  enModePin        Interrupt pin of the hardware alarm
+ **
+ ** \param  pu32Next         returns the next fire time in seconds since 2000, can be NULL
+ **
+ ** \param  pbHardwareRepeat returns true if the RTC repeats the alarm itself, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_ScheduleArm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_schedule_t* pstcSchedule, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin, uint32_t* pu32Next, bool* pbHardwareRepeat)
+{
+    stc_amx8x5_time_t stcAlarm;
+    en_amx8x5_alarm_repeat_t enRepeat;
+    uint32_t u32Now;
+    uint32_t u32Next;
+    bool bHardwareRepeat;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_ScheduleArm");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+
+    res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ScheduleNext(pstcSchedule,u32Now,&u32Next);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    bHardwareRepeat = (Amx8x5_ScheduleToAlarm(pstcSchedule,&stcAlarm,&enRepeat) == Ok);
+    if (!bHardwareRepeat)
+    {
+        enRepeat = AMx8x5AlarmYear;
+        res = Amx8x5_SecondsToTime(((u32Next - u32Now) > AMX8X5_SWALARM_MAX_ARM) ? (u32Now + AMX8X5_SWALARM_MAX_ARM) : u32Next,&stcAlarm);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+    res = Amx8x5_AlarmToHourMode(pstcHandle,&stcAlarm);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    res = Amx8x5_SetAlarm(pstcHandle,&stcAlarm,enRepeat,enModeIrq,enModePin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (pu32Next != NULL)
+    {
+        *pu32Next = u32Next;
+    }
+    if (pbHardwareRepeat != NULL)
+    {
+        *pbHardwareRepeat = bHardwareRepeat;
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start a periodic alarm with a period in hundredths of a second
+ **
+ ** The first match is u16Period hundredths from now. These periods are
+ ** repeated by the RTC itself:
+ ** - 1: ALARM_HUNDRS 0xFF, every hundredth
+ ** - 10: ALARM_HUNDRS 0xF0 + digit, every tenth
+ ** - 100: hundredths match once per second
+ ** - #AMX8X5_SUBSECOND_MAX: seconds and hundredths match once per minute
+ **
+ ** Any other period up to #AMX8X5_SUBSECOND_SOFTWARE_MAX is armed on
+ ** seconds and hundredths once per minute and moved on by
+ ** Amx8x5_SubSecondAlarmService() after every match. The hundredths counter
+ ** only runs with the XT oscillator.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcAlarm      Alarm, see #stc_amx8x5_subsecond_alarm_t
+ **
+ ** \param  u16Period      Period in hundredths of a second (1..#AMX8X5_SUBSECOND_SOFTWARE_MAX
+ **                        or #AMX8X5_SUBSECOND_MAX)
+ **
+ ** \param  enModeIrq      Interrupt mode of the hardware alarm
+ **
+ ** \param  enModePin      Interrupt pin of the hardware alarm
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SubSecondAlarmStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_subsecond_alarm_t* pstcAlarm, uint16_t u16Period, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin)
+{
+    uint8_t au8Now[AMX8X5_REG_SECONDS - AMX8X5_REG_HUNDREDTHS + 1];
+    stc_amx8x5_time_t stcAlarm;
+    en_amx8x5_alarm_repeat_t enRepeat;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SubSecondAlarmStart");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcAlarm == NULL) || (u16Period == 0) || ((u16Period > AMX8X5_SUBSECOND_SOFTWARE_MAX) && (u16Period != AMX8X5_SUBSECOND_MAX)))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,au8Now,sizeof(au8Now));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcAlarm->u16Period = u16Period;
+    pstcAlarm->u16Target = (AMX8X5_BCD_TO_DEC(au8Now[1] & 0x7F) * 100 + AMX8X5_BCD_TO_DEC(au8Now[0]) + u16Period) % AMX8X5_SUBSECOND_MAX;
+    pstcAlarm->bSoftware = false;
+
+    memset(&stcAlarm,0,sizeof(stcAlarm));
+    stcAlarm.u8Hundredth = pstcAlarm->u16Target % 100;
+    stcAlarm.u8Second = pstcAlarm->u16Target / 100;
+    stcAlarm.u8Mode = AMX8X5_24HR_MODE;
+    switch(u16Period)
+    {
+        case 1:
+            enRepeat = AMx8x5Alarm100thSecond;
+            break;
+        case 10:
+            enRepeat = AMx8x5Alarm10thSecond;
+            break;
+        case 100:
+            enRepeat = AMx8x5AlarmSecond;
+            break;
+        default:
+            enRepeat = AMx8x5AlarmMinute;
+            pstcAlarm->bSoftware = (u16Period != AMX8X5_SUBSECOND_MAX);
+            break;
+    }
+    res = Amx8x5_SetAlarm(pstcHandle,&stcAlarm,enRepeat,enModeIrq,enModePin);
+    if (res != Ok)
+    {
+        pstcAlarm->bSoftware = false;
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Move a sub-second alarm on to its next match
+ **
+ ** Call after every alarm interrupt, the ALM flag is left to the caller
+ ** (e.g. Amx8x5_IrqDispatch()). Without bus access if the RTC repeats the
+ ** period itself or the armed match is still ahead. Otherwise HUNDREDTHS and
+ ** SECONDS are read in one burst and the next match at least
+ ** #AMX8X5_SUBSECOND_GUARD hundredths ahead is written to ALARM_HUNDRS and
+ ** ALARM_SECONDS in one burst. Matches missed by a late call are skipped,
+ ** the grid of the first match is kept.
+ **
+ ** The match is taken as still ahead if it is at most one period after
+ ** now. With periods up to #AMX8X5_SUBSECOND_SOFTWARE_MAX this holds for
+ ** calls up to 30 s after the match, a later call would leave the alarm
+ ** silent until the same hundredth of the next minute.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcAlarm      Alarm started by Amx8x5_SubSecondAlarmStart()
+ **
+ ** \param  pbRearmed      Returns true if the alarm registers were written, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SubSecondAlarmService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_subsecond_alarm_t* pstcAlarm, bool* pbRearmed)
+{
+    uint8_t au8Reg[AMX8X5_REG_SECONDS - AMX8X5_REG_HUNDREDTHS + 1];
+    uint16_t u16Now;
+    uint16_t u16Target;
+    uint16_t u16Late;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SubSecondAlarmService");
+
+    if (pbRearmed != NULL) *pbRearmed = false;
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcAlarm == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (!pstcAlarm->bSoftware)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u16Now = AMX8X5_BCD_TO_DEC(au8Reg[1] & 0x7F) * 100 + AMX8X5_BCD_TO_DEC(au8Reg[0]);
+
+    //
+    // Called before the match: nothing to do. A period of at most half a
+    // minute keeps this apart from a call late by up to half a minute.
+    //
+    u16Target = (pstcAlarm->u16Target + AMX8X5_SUBSECOND_MAX - u16Now) % AMX8X5_SUBSECOND_MAX;
+    if ((u16Target != 0) && (u16Target <= pstcAlarm->u16Period))
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    //
+    // Next match on the grid after now, with room for the bus transfer.
+    //
+    u16Late = (u16Now + AMX8X5_SUBSECOND_MAX - pstcAlarm->u16Target) % AMX8X5_SUBSECOND_MAX;
+    u16Target = (uint16_t)((pstcAlarm->u16Target + (uint32_t)(u16Late / pstcAlarm->u16Period + 1) * pstcAlarm->u16Period) % AMX8X5_SUBSECOND_MAX);
+    if (((u16Target + AMX8X5_SUBSECOND_MAX - u16Now) % AMX8X5_SUBSECOND_MAX) < AMX8X5_SUBSECOND_GUARD)
+    {
+        u16Target = (u16Target + pstcAlarm->u16Period) % AMX8X5_SUBSECOND_MAX;
+    }
+
+    au8Reg[0] = AMX8X5_DEC_TO_BCD(u16Target % 100);
+    au8Reg[1] = AMX8X5_DEC_TO_BCD(u16Target / 100);
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_ALARM_HUNDRS,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcAlarm->u16Target = u16Target;
+    if (pbRearmed != NULL) *pbRearmed = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Prepare a countdown for fast (re)starts
+ **
+ ** Resolves the period to the TIMER and TIMER_CTRL bytes once for the
+ ** current oscillator mode, routes the interrupt pin and enables the
+ ** timer interrupt. The timer is not started. Amx8x5_CountdownStart()
+ ** does not read the registers again: prepare again after the oscillator
+ ** mode changed (also by the autoswitch to RC on an oscillator failure or
+ ** the #AMx8x5OscHealthPolicyFallbackXt policy) or the alarm repeat (RPT in
+ ** TIMER_CTRL).
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcCountdown  Prepared countdown, see #stc_amx8x5_countdown_t
+ **
+ ** \param  enRange        Periode range, see #en_amx8x5_periode_range_t
+ **
+ ** \param  iPeriod        Periode in us or seconds
+ **
+ ** \param  enRepeat       Interrupt output, see #en_amx8x5_countdown_interrupt_output_t
+ **
+ ** \param  enPin          Interrupt pin, see #en_amx8x5_countdown_interrupt_pin_t
+ **
+ ** \return Ok on success, ErrorInvalidParameter if the period does not fit the selected range, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_CountdownPrepare(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin)
+{
+    uint8_t au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL + 1];
+    en_amx8x5_calibration_mode_t enOMODE;
+    uint8_t u8Fields;
+    int32_t iTimer;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_CountdownPrepare");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcCountdown == NULL) || (enPin == AMx8x5CountdownInterruptPinDisable))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    //
+    // TIMER_CTRL (RPT) .. OSC_STATUS (OMODE) in one read.
+    //
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_TIMER_CTRL,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    enOMODE = (au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_OSC_STATUS_OMODE_MSK) ? AMx8x5ModeCalibrateRC : AMx8x5ModeCalibrateXT;
+
+    Amx8x5_CountdownEncode(enOMODE,enRange,iPeriod,enRepeat,enPin,&iTimer,&u8Fields);
+    if ((iTimer < 0) || (iTimer > 255))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_SetCountdownPin(pstcHandle,enPin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,AMX8X5_REG_INT_MASK_TIE_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    pstcCountdown->u8TimerCtrl = (au8Reg[0] & AMX8X5_REG_TIMER_CTRL_RPT_MSK) | u8Fields;
+    pstcCountdown->au8Timer[0] = (uint8_t)iTimer;
+    pstcCountdown->au8Timer[1] = (uint8_t)iTimer;
+    pstcCountdown->bStarted = false;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start or rearm a prepared countdown
+ **
+ ** The first start writes TIMER/TIMER_INITIAL and then TIMER_CTRL. While
+ ** the countdown is started, a rearm only reloads TIMER/TIMER_INITIAL with
+ ** one burst write and no read. The period stays encoded for the oscillator
+ ** mode at prepare time, see Amx8x5_CountdownPrepare().
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcCountdown  Countdown prepared by Amx8x5_CountdownPrepare()
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_CountdownStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown)
+{
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_CountdownStart");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcCountdown == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_TIMER,pstcCountdown->au8Timer,2);
+    if ((res != Ok) || (pstcCountdown->bStarted))
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,pstcCountdown->u8TimerCtrl);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcCountdown->bStarted = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Stop a prepared countdown
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcCountdown  Countdown prepared by Amx8x5_CountdownPrepare()
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_CountdownStop(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown)
+{
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_CountdownStop");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcCountdown == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,pstcCountdown->u8TimerCtrl & ~AMX8X5_REG_TIMER_CTRL_TE_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcCountdown->bStarted = false;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Convert intervals in us to TIMER values of the 4096 Hz range
+ **
+ ** \param  pu32Us         Intervals in us, 245..62500
+ **
+ ** \param  pu8Timer       returns the TIMER values (counts - 1)
+ **
+ ** \param  u16Length      Number of intervals
+ **
+ ** \return Ok on success, ErrorInvalidParameter if an interval is out of range
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SequenceEncode(const uint32_t* pu32Us, uint8_t* pu8Timer, uint16_t u16Length)
+{
+    uint32_t u32Counts;
+    uint16_t i;
+
+    if ((pu32Us == NULL) || (pu8Timer == NULL))
+    {
+        return ErrorInvalidParameter;
+    }
+    for(i = 0; i < u16Length; i++)
+    {
+        //
+        // Round to the nearest 1/4096 s.
+        //
+        u32Counts = (pu32Us[i] * 512UL + 62500UL) / 125000UL;
+        if ((pu32Us[i] > 62500UL) || (u32Counts == 0) || (u32Counts > 256))
+        {
+            return ErrorInvalidParameter;
+        }
+        pu8Timer[i] = (uint8_t)(u32Counts - 1);
+    }
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a timer sequence
+ **
+ ** \param  pstcSequence   Sequence, see #stc_amx8x5_sequence_t
+ **
+ ** \param  pu8Timer       TIMER values, see Amx8x5_SequenceEncode(), must stay valid while playing
+ **
+ ** \param  u16Length      Number of intervals
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SequenceInit(stc_amx8x5_sequence_t* pstcSequence, const uint8_t* pu8Timer, uint16_t u16Length)
+{
+    if ((pstcSequence == NULL) || (pu8Timer == NULL) || (u16Length == 0) || (u16Length == 0xFFFF))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcSequence,0,sizeof(stc_amx8x5_sequence_t));
+    pstcSequence->pu8Timer = pu8Timer;
+    pstcSequence->u16Length = u16Length;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start playing a timer sequence on the 4096 Hz countdown range
+ **
+ ** The first interval is loaded into TIMER and the second is staged in
+ ** TIMER_INITIAL with the repeat (TRPT) enabled, so the RTC reloads the next
+ ** interval by itself when the current one ends. Only available with the
+ ** XT oscillator.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSequence   Sequence, see Amx8x5_SequenceInit()
+ **
+ ** \param  enPin          Countdown interrupt pin
+ **
+ ** \return Ok on success, ErrorInvalidMode in RC oscillator mode, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SequenceStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_sequence_t* pstcSequence, en_amx8x5_countdown_interrupt_pin_t enPin)
+{
+    uint8_t au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL + 1];
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SequenceStart");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcSequence == NULL) || (pstcSequence->pu8Timer == NULL) || (enPin == AMx8x5CountdownInterruptPinDisable))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_TIMER_CTRL,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_OSC_STATUS_OMODE_MSK)
+    {
+        //
+        // TFS 0 is 128 Hz in RC mode.
+        //
+        return AMX8X5_FUNC_END(ErrorInvalidMode);
+    }
+
+    //
+    // Stop the timer, keep RPT.
+    //
+    pstcSequence->u8TimerCtrl = au8Reg[0] & AMX8X5_REG_TIMER_CTRL_RPT_MSK;
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,pstcSequence->u8TimerCtrl);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_SetCountdownPin(pstcHandle,enPin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_TIM_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,AMX8X5_REG_INT_MASK_TIE_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    au8Reg[1] = pstcSequence->pu8Timer[0];
+    if (pstcSequence->u16Length > 1)
+    {
+        //
+        // Stage the second interval, repeated short pulses.
+        //
+        au8Reg[2] = pstcSequence->pu8Timer[1];
+        pstcSequence->u8TimerCtrl |= AMX8X5_REG_TIMER_CTRL_TRPT_MSK;
+        pstcSequence->u16Next = 2;
+    }
+    else
+    {
+        //
+        // Single interval, single short pulse.
+        //
+        au8Reg[2] = au8Reg[1];
+        pstcSequence->u16Next = 2;
+    }
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_TIMER,&au8Reg[1],2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcSequence->u8TimerCtrl |= AMX8X5_REG_TIMER_CTRL_TE_MSK;
+    return AMX8X5_FUNC_END(Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,pstcSequence->u8TimerCtrl));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Stage the next interval, call on every countdown interrupt
+ **
+ ** When an interval ends the RTC has already reloaded the staged one from
+ ** TIMER_INITIAL, this function stages the interval after it with a single
+ ** byte write. It must complete before the running interval ends. While
+ ** the last interval runs the repeat is switched off instead, so the timer
+ ** halts after it.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcSequence   Sequence started by Amx8x5_SequenceStart()
+ **
+ ** \param  pbDone         returns true once the last interval ended, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SequenceService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_sequence_t* pstcSequence, bool* pbDone)
+{
+    en_result_t res = Ok;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SequenceService");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcSequence == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    if (pbDone != NULL)
+    {
+        *pbDone = (pstcSequence->u16Next > pstcSequence->u16Length);
+    }
+
+    if (pstcSequence->u16Next < pstcSequence->u16Length)
+    {
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_INITIAL,pstcSequence->pu8Timer[pstcSequence->u16Next]);
+    }
+    else if (pstcSequence->u16Next == pstcSequence->u16Length)
+    {
+        pstcSequence->u8TimerCtrl &= ~AMX8X5_REG_TIMER_CTRL_TRPT_MSK;
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,pstcSequence->u8TimerCtrl);
+    }
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (pstcSequence->u16Next <= pstcSequence->u16Length)
+    {
+        pstcSequence->u16Next++;
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Position in the current 1 Hz / 1/60 Hz count in 1/100 s
+ **
+ ** \param  pu8Reg         Registers read from HUNDREDTHS, at least up to SECONDS
+ **
+ ** \param  u16Period      Length of one count in 1/100 s, 100 or 6000
+ **
+ ** \return Hundredths since the last second (100) or minute (6000) rollover
+ **
+ ******************************************************************************/
+static uint16_t Amx8x5_TicklessPhase(const uint8_t* pu8Reg, uint16_t u16Period)
+{
+    uint16_t u16Phase = AMX8X5_BCD_TO_DEC(pu8Reg[AMX8X5_REG_HUNDREDTHS]);
+    if (u16Period > 100)
+    {
+        u16Phase += AMX8X5_BCD_TO_DEC(pu8Reg[AMX8X5_REG_SECONDS] & 0x7F) * 100;
+    }
+    return u16Phase;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize the tickless idle timebase
+ **
+ ** Routes the countdown timer interrupt to the pin and enables it, the
+ ** timer itself is started by Amx8x5_TicklessSleep().
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcTickless   Timebase, see #stc_amx8x5_tickless_t
+ **
+ ** \param  u32TickHz      OS tick frequency, e.g. configTICK_RATE_HZ
+ **
+ ** \param  enPin          Countdown interrupt pin waking the MCU
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TicklessInit(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t u32TickHz, en_amx8x5_countdown_interrupt_pin_t enPin)
+{
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TicklessInit");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcTickless == NULL) || (u32TickHz == 0) || (u32TickHz > 0xFFFF) || (enPin == AMx8x5CountdownInterruptPinDisable))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    memset(pstcTickless,0,sizeof(stc_amx8x5_tickless_t));
+    pstcTickless->u32TickHz = u32TickHz;
+
+    res = Amx8x5_SetCountdownPin(pstcHandle,enPin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_SetRegister(pstcHandle,AMX8X5_REG_INT_MASK,AMX8X5_REG_INT_MASK_TIE_MSK));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start the countdown timer for an idle period of the OS
+ **
+ ** Selects the finest countdown frequency (4096 Hz XT / 128 Hz RC, 64 Hz,
+ ** 1 Hz, 1/60 Hz) the sleep fits in and programs a single pulse
+ ** countdown not longer than the requested ticks. Sleeps longer than
+ ** 256 minutes are shortened, the OS sleeps again after the wakeup.
+ **
+ ** The 1 Hz and 1/60 Hz counts follow the second and minute rollover, so
+ ** the first count is shorter than a period. For these ranges HUNDREDTHS ..
+ ** TIMER is read in one burst after the start and Amx8x5_TicklessWake()
+ ** measures the sleep against the clock counters.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcTickless   Timebase, see #stc_amx8x5_tickless_t
+ **
+ ** \param  u32Ticks       Expected idle time in OS ticks
+ **
+ ** \param  pu32Ticks      returns the programmed sleep in OS ticks (rounded down), can be NULL
+ **
+ ** \return Ok on success, ErrorInvalidParameter if the sleep is shorter than one timer period, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TicklessSleep(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t u32Ticks, uint32_t* pu32Ticks)
+{
+    //
+    // Length of one count in 1/4096 s for TFS 0 (XT, RC), 1, 2, 3.
+    //
+    static const uint32_t au32Units[5] = {1, 32, 64, 4096, 245760UL};
+    uint8_t au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL + 1];
+    uint8_t au8Clock[AMX8X5_REG_TIMER - AMX8X5_REG_HUNDREDTHS + 1];
+    uint64_t u64Counts;
+    uint8_t u8Tfs;
+    uint8_t u8Unit;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TicklessSleep");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcTickless == NULL) || (pstcTickless->u32TickHz == 0))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    //
+    // TIMER_CTRL .. OSC_STATUS in one read: RPT bits and OMODE.
+    //
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_TIMER_CTRL,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    for(u8Tfs = 0; u8Tfs < 4; u8Tfs++)
+    {
+        u8Unit = u8Tfs + 1;
+        if ((u8Tfs == 0) && ((au8Reg[AMX8X5_REG_OSC_STATUS - AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_OSC_STATUS_OMODE_MSK) == 0))
+        {
+            u8Unit = 0;
+        }
+        u64Counts = ((uint64_t)u32Ticks * 4096) / ((uint64_t)pstcTickless->u32TickHz * au32Units[u8Unit]);
+        if (u64Counts <= 256)
+        {
+            break;
+        }
+    }
+    if (u8Tfs == 4)
+    {
+        u8Tfs = 3;
+        u64Counts = 256;
+    }
+    if (u64Counts == 0)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    //
+    // Stop the timer before reloading it.
+    //
+    if (au8Reg[0] & AMX8X5_REG_TIMER_CTRL_TE_MSK)
+    {
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,au8Reg[0] & AMX8X5_REG_TIMER_CTRL_RPT_MSK);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+    res = Amx8x5_ClearRegister(pstcHandle,AMX8X5_REG_STATUS,AMX8X5_REG_STATUS_TIM_MSK);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // TIMER and TIMER_INITIAL in one write, counts - 1.
+    //
+    au8Reg[1] = (uint8_t)(u64Counts - 1);
+    au8Reg[2] = au8Reg[1];
+    res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_TIMER,&au8Reg[1],2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // Single pulse countdown: TE, TM = 0, TRPT = 0, keep RPT.
+    //
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,AMX8X5_REG_TIMER_CTRL_TE_MSK | (au8Reg[0] & AMX8X5_REG_TIMER_CTRL_RPT_MSK) | u8Tfs);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    pstcTickless->u16Period = 0;
+    if (u8Tfs >= 2)
+    {
+        //
+        // Phase and TIMER in one burst, a count between the start and
+        // this read shows in TIMER.
+        //
+        res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,au8Clock,sizeof(au8Clock));
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        pstcTickless->u16Period = (u8Tfs == 2) ? 100 : 6000;
+        pstcTickless->u16Phase = Amx8x5_TicklessPhase(au8Clock,pstcTickless->u16Period);
+        pstcTickless->u8Start = au8Clock[AMX8X5_REG_TIMER - AMX8X5_REG_HUNDREDTHS];
+    }
+
+    pstcTickless->u32Units = au32Units[u8Unit];
+    pstcTickless->u8Timer = au8Reg[1];
+    pstcTickless->bArmed = true;
+    if (pu32Ticks != NULL)
+    {
+        *pu32Ticks = (uint32_t)((u64Counts * pstcTickless->u32Units * pstcTickless->u32TickHz) / 4096);
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Stop the countdown timer after wakeup and return the slept ticks
+ **
+ ** Reads STATUS .. TIMER in one burst. If the countdown expired the
+ ** complete sleep elapsed, on an early wake (other interrupt) the elapsed
+ ** counts are taken from TIMER. In the 1 Hz and 1/60 Hz range the burst
+ ** starts at HUNDREDTHS and the partial counts at both ends are added from
+ ** the clock, to 1/100 s. An expired sleep ends at the rollover of its last
+ ** count, the time from there to this call is not counted. The part of a
+ ** tick not yet reported is carried to the next call, so the OS tick count
+ ** does not drift.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcTickless   Timebase, see #stc_amx8x5_tickless_t
+ **
+ ** \param  pu32Ticks      returns the ticks to step the OS tick count by (e.g. vTaskStepTick())
+ **
+ ** \return Ok on success, ErrorNotReady if no sleep was started, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TicklessWake(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t* pu32Ticks)
+{
+    uint8_t au8Reg[AMX8X5_REG_TIMER - AMX8X5_REG_HUNDREDTHS + 1];
+    uint8_t u8First;
+    uint8_t u8TimerCtrl;
+    uint8_t u8Timer;
+    bool bExpired;
+    uint32_t u32Counts;
+    int32_t i32Hundredths;
+    uint64_t u64Elapsed;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TicklessWake");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcTickless == NULL) || (pu32Ticks == NULL))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    *pu32Ticks = 0;
+    if (!pstcTickless->bArmed)
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+
+    //
+    // Register addresses index au8Reg, the burst starts at STATUS unless
+    // the clock is needed.
+    //
+    u8First = (pstcTickless->u16Period != 0) ? AMX8X5_REG_HUNDREDTHS : AMX8X5_REG_STATUS;
+    res = Amx8x5_ReadBytes(pstcHandle,u8First,&au8Reg[u8First],sizeof(au8Reg) - u8First);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u8TimerCtrl = au8Reg[AMX8X5_REG_TIMER_CTRL];
+    u8Timer = au8Reg[AMX8X5_REG_TIMER];
+
+    //
+    // Expired: TIM set, or TE already cleared by the single countdown.
+    //
+    bExpired = ((au8Reg[AMX8X5_REG_STATUS] & AMX8X5_REG_STATUS_TIM_MSK) || ((u8TimerCtrl & AMX8X5_REG_TIMER_CTRL_TE_MSK) == 0));
+    if (!bExpired)
+    {
+        res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TIMER_CTRL,u8TimerCtrl & ~AMX8X5_REG_TIMER_CTRL_TE_MSK);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+    pstcTickless->bArmed = false;
+
+    if (pstcTickless->u16Period != 0)
+    {
+        //
+        // Counts since the phase read, minus the phase at the start, plus the
+        // phase now, in 1/100 s. An expired countdown ended exactly at a
+        // rollover, the time since then is wake latency, not sleep.
+        //
+        u32Counts = bExpired ? ((uint32_t)pstcTickless->u8Start + 1) : (uint32_t)(uint8_t)(pstcTickless->u8Start - u8Timer);
+        i32Hundredths = (int32_t)(u32Counts * pstcTickless->u16Period) - pstcTickless->u16Phase;
+        if (!bExpired)
+        {
+            i32Hundredths += Amx8x5_TicklessPhase(au8Reg,pstcTickless->u16Period);
+        }
+        if (i32Hundredths < 0)
+        {
+            i32Hundredths = 0;
+        }
+        u64Elapsed = ((uint64_t)i32Hundredths * 4096 * pstcTickless->u32TickHz) / 100 + pstcTickless->u16Fraction;
+    }
+    else
+    {
+        //
+        // Elapsed time in 1/4096 ticks, plus the carried fraction.
+        //
+        u32Counts = bExpired ? ((uint32_t)pstcTickless->u8Timer + 1) : (uint32_t)(pstcTickless->u8Timer - u8Timer);
+        u64Elapsed = (uint64_t)u32Counts * pstcTickless->u32Units * pstcTickless->u32TickHz + pstcTickless->u16Fraction;
+    }
+    *pu32Ticks = (uint32_t)(u64Elapsed >> 12);
+    pstcTickless->u16Fraction = (uint16_t)(u64Elapsed & 0xFFF);
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Check byte of a record in RTC RAM
+ **
+ ** \param  pu8Data        Record without the check byte
+ **
+ ** \param  u8Length       Length of the record without the check byte
+ **
+ ** \return Check byte, never matches an all zero or all 0xFF record
+ **
+ ******************************************************************************/
+static uint8_t Amx8x5_RecordCheck(const uint8_t* pu8Data, uint8_t u8Length)
+{
+    uint8_t u8Check = 0xA5;
+    uint8_t i;
+
+    for(i = 0; i < u8Length; i++)
+    {
+        u8Check = (uint8_t)((u8Check << 1) | (u8Check >> 7)) ^ pu8Data[i];
+    }
+    return u8Check;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Restart the drift fit with a first sample
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  u32RefSeconds  Reference time of the sample in s
+ **
+ ** \param  i32OffsetUs    RTC minus reference time in us
+ **
+ ******************************************************************************/
+static void Amx8x5_DriftRestart(stc_amx8x5_drift_t* pstcDrift, uint32_t u32RefSeconds, int32_t i32OffsetUs)
+{
+    pstcDrift->u32X0 = u32RefSeconds;
+    pstcDrift->i32Y0 = i32OffsetUs;
+    pstcDrift->i64Sx = 0;
+    pstcDrift->i64Sy = 0;
+    pstcDrift->i64Sxx = 0;
+    pstcDrift->i64Sxy = 0;
+    pstcDrift->u64Srr = 0;
+    pstcDrift->u8Count = 1;
+    pstcDrift->u8Residuals = 0;
+    pstcDrift->u8Rejected = 0;
+    pstcDrift->i32DriftPpb = 0;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Least squares slope of the accepted samples
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  pi64D          Returns n * Sum((x - mean(x))^2)
+ **
+ ** \return true if the samples span enough time for a slope
+ **
+ ******************************************************************************/
+static bool Amx8x5_DriftSlope(stc_amx8x5_drift_t* pstcDrift, int64_t* pi64D)
+{
+    int64_t i64N = pstcDrift->u8Count;
+    int64_t i64Ppb;
+
+    //
+    // The first sample is the origin, x = y = 0, it adds nothing but n.
+    //
+    *pi64D = i64N * pstcDrift->i64Sxx - pstcDrift->i64Sx * pstcDrift->i64Sx;
+    if (*pi64D < 1000000)
+    {
+        return false;
+    }
+
+    //
+    // us per s is ppm, the slope in ppb is limited to +/-2^24 to keep the
+    // prediction in 64 bit.
+    //
+    i64Ppb = (i64N * pstcDrift->i64Sxy - pstcDrift->i64Sx * pstcDrift->i64Sy) / (*pi64D / 1000);
+    if (i64Ppb > (1L << 24))
+    {
+        i64Ppb = (1L << 24);
+    }
+    else if (i64Ppb < -(1L << 24))
+    {
+        i64Ppb = -(1L << 24);
+    }
+    pstcDrift->i32DriftPpb = (int32_t)i64Ppb;
+    return true;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Write the drift record in one burst
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  i32Ppm         Applied correction
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_DriftWrite(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_drift_t* pstcDrift, int32_t i32Ppm)
+{
+    uint8_t au8Record[AMX8X5_DRIFT_SIZE];
+    uint8_t i;
+    en_result_t res;
+
+    for(i = 0; i < AMX8X5_DRIFT_SIZE - 1; i++)
+    {
+        au8Record[i] = (uint8_t)((uint32_t)i32Ppm >> (8 * i));
+    }
+    au8Record[AMX8X5_DRIFT_SIZE - 1] = Amx8x5_RecordCheck(au8Record,AMX8X5_DRIFT_SIZE - 1);
+
+    if (pstcDrift->u8Xadd == 0)
+    {
+        //
+        // Not restored before, the bank is looked up once.
+        //
+        res = Amx8x5_GetExtensionAddress(pstcHandle,pstcDrift->u8RamAddress,&pstcDrift->u8Xadd);
+        if (res != Ok)
+        {
+            return res;
+        }
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcDrift->u8Xadd);
+    if (res != Ok)
+    {
+        return res;
+    }
+    return Amx8x5_WriteBytes(pstcHandle,(pstcDrift->u8RamAddress & 0x3F) | 0x40,au8Record,AMX8X5_DRIFT_SIZE);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Rate change the registers really apply for a correction
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  i32Value       Correction in ppm, 1/16 ppm with pstcTempComp set
+ **
+ ** \return Correction in ppb after rounding to calibration steps
+ **
+ ******************************************************************************/
+static int32_t Amx8x5_DriftStepPpb(stc_amx8x5_drift_t* pstcDrift, int32_t i32Value)
+{
+    uint8_t au8Reg[2];
+
+    if (pstcDrift->pstcTempComp != NULL)
+    {
+        //
+        // Same rounding as Amx8x5_TempCompService().
+        //
+        i32Value = (i32Value < 0) ? ((i32Value * 1000 - 15256) / 30512) : ((i32Value * 1000 + 15256) / 30512);
+        return i32Value * 1907;
+    }
+    if (Amx8x5_CalibrationEncode(pstcDrift->enMode,i32Value,au8Reg) != Ok)
+    {
+        return 0;
+    }
+    return Amx8x5_CalibrationDecode(pstcDrift->enMode,au8Reg);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Check that a new correction reduces the drift
+ **
+ ** The correction is rounded to calibration steps, a drift near half a
+ ** step would only flip to the other sign and back with the next fit.
+ ** The drift must shrink by more than four standard errors.
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  i32Old         Applied correction, see Amx8x5_DriftStepPpb()
+ **
+ ** \param  i32New         New correction
+ **
+ ** \param  u64Se2         Squared standard error of the drift in ppb^2
+ **
+ ** \return true if the drift left after the new correction is smaller
+ **
+ ******************************************************************************/
+static bool Amx8x5_DriftImproves(stc_amx8x5_drift_t* pstcDrift, int32_t i32Old, int32_t i32New, uint64_t u64Se2)
+{
+    int64_t i64Left = (int64_t)pstcDrift->i32DriftPpb + Amx8x5_DriftStepPpb(pstcDrift,i32New) - Amx8x5_DriftStepPpb(pstcDrift,i32Old);
+    int64_t i64Now = pstcDrift->i32DriftPpb;
+
+    if (i64Left < 0) i64Left = -i64Left;
+    if (i64Now < 0) i64Now = -i64Now;
+    i64Now -= i64Left;
+    return (i64Now > 0) && ((uint64_t)(i64Now * i64Now) > 16 * u64Se2);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize the closed-loop drift estimator
+ **
+ ** \param  pstcDrift      Drift estimator
+ **
+ ** \param  enMode         Oscillator the correction is applied to
+ **
+ ** \param  i32AppliedPpm  Calibration currently set with Amx8x5_SetCalibrationValue()
+ **
+ ** \param  u8RamAddress   RTC RAM address of the record, e.g. #AMX8X5_RAM_DRIFT,
+ **                        the record must not cross a 64 byte bank
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_DriftInit(stc_amx8x5_drift_t* pstcDrift, en_amx8x5_calibration_mode_t enMode, int32_t i32AppliedPpm, uint8_t u8RamAddress)
+{
+    if ((pstcDrift == NULL) || ((u8RamAddress & 0x3F) > (0x40 - AMX8X5_DRIFT_SIZE)))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcDrift,0,sizeof(stc_amx8x5_drift_t));
+    pstcDrift->enMode = enMode;
+    pstcDrift->i32AppliedPpm = i32AppliedPpm;
+    pstcDrift->u8RamAddress = u8RamAddress;
+    pstcDrift->u32OutlierUs = AMX8X5_DRIFT_OUTLIER_US;
+    pstcDrift->u16ConfidencePpb = AMX8X5_DRIFT_CONFIDENCE_PPB;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Restore the applied calibration persisted by Amx8x5_DriftAddSample()
+ **
+ ** With pstcTempComp set the value is its i32OffsetPpm16, the temperature
+ ** compensation writes it with the next Amx8x5_TempCompService().
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcDrift      Drift estimator, initialized by Amx8x5_DriftInit()
+ **
+ ** \return Ok on success, ErrorNotReady if the RAM holds no valid record,
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_DriftRestore(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_drift_t* pstcDrift)
+{
+    uint8_t au8Record[AMX8X5_DRIFT_SIZE];
+    int32_t i32Ppm;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_DriftRestore");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcDrift == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetExtensionAddress(pstcHandle,pstcDrift->u8RamAddress,&pstcDrift->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcDrift->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ReadBytes(pstcHandle,(pstcDrift->u8RamAddress & 0x3F) | 0x40,au8Record,AMX8X5_DRIFT_SIZE);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (au8Record[AMX8X5_DRIFT_SIZE - 1] != Amx8x5_RecordCheck(au8Record,AMX8X5_DRIFT_SIZE - 1))
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+
+    //
+    // 24 bit two's complement.
+    //
+    i32Ppm = (int32_t)((uint32_t)au8Record[0] | ((uint32_t)au8Record[1] << 8) | ((uint32_t)au8Record[2] << 16));
+    if (i32Ppm & 0x800000L)
+    {
+        i32Ppm -= 0x1000000L;
+    }
+
+    if (pstcDrift->pstcTempComp != NULL)
+    {
+        if ((i32Ppm < AMX8X5_CALIBRATION_XT_MIN_PPM * 16) || (i32Ppm > AMX8X5_CALIBRATION_XT_MAX_PPM * 16))
+        {
+            return AMX8X5_FUNC_END(ErrorNotReady);
+        }
+        pstcDrift->pstcTempComp->i32OffsetPpm16 = i32Ppm;
+        pstcDrift->pstcTempComp->bWritten = false;
+        return AMX8X5_FUNC_END(Ok);
+    }
+    if ((pstcDrift->enMode == AMx8x5ModeCalibrateXT) ? ((i32Ppm < AMX8X5_CALIBRATION_XT_MIN_PPM) || (i32Ppm > AMX8X5_CALIBRATION_XT_MAX_PPM))
+                                                     : ((i32Ppm < AMX8X5_CALIBRATION_RC_MIN_PPM) || (i32Ppm > AMX8X5_CALIBRATION_RC_MAX_PPM)))
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+    pstcDrift->i32AppliedPpm = i32Ppm;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Add a (reference time, RTC time) sample to the drift estimator
+ **
+ ** The offset of the RTC against any reference (GPS, NTP, host clock via
+ ** Amx8x5_GetTimePrecise()) is fitted over the reference time with
+ ** incremental least squares, the slope in us/s is the drift in ppm.
+ ** Samples further than u32OutlierUs from the current fit are rejected,
+ ** #AMX8X5_DRIFT_MAX_REJECTS rejects in a row are taken as a time step and
+ ** restart the fit.
+ **
+ ** Once at least #AMX8X5_DRIFT_MIN_SAMPLES samples are checked against the
+ ** fit and the standard error of the slope is below u16ConfidencePpb, the
+ ** correction is applied with Amx8x5_SetCalibrationValue() if it changes by
+ ** at least 1 ppm and, rounded to calibration steps, reduces the drift by
+ ** more than four standard errors. It is persisted in RTC RAM and the fit
+ ** restarts at the new rate.
+ **
+ ** Combined with a temperature compensation (pstcTempComp set after
+ ** Amx8x5_DriftInit(), enMode XT) the drift is the error left by the
+ ** compensation: the correction is added to its i32OffsetPpm16 in 1/16 ppm
+ ** and persisted, the calibration registers are left to the next
+ ** Amx8x5_TempCompService(). Setting the XT calibration from both would
+ ** make each overwrite the other.
+ **
+ ** Limits: 255 samples, 2^22 s (48 days) and +/-2^23 us offset change per
+ ** fit, the fit restarts when exceeded.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcDrift      Drift estimator, initialized by Amx8x5_DriftInit()
+ **
+ ** \param  u32RefSeconds  Reference time in s, e.g. Amx8x5_TimeToSeconds()
+ **
+ ** \param  i32OffsetUs    RTC minus reference time in us
+ **
+ ** \param  pbApplied      Returns true if a new calibration was applied, may be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ** Example:
+ ** @code
+ ** // once per hour, u32Utc: reference time of the RTC reading
+ ** Amx8x5_DriftAddSample(&stcRtcConfig,&stcDrift,u32Utc,i32RtcMinusUtcUs,NULL);
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_DriftAddSample(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_drift_t* pstcDrift, uint32_t u32RefSeconds, int32_t i32OffsetUs, bool* pbApplied)
+{
+    int64_t i64X;
+    int64_t i64Y;
+    int64_t i64D;
+    int64_t i64R;
+    int64_t i64N;
+    uint64_t u64Limit;
+    uint64_t u64Se2;
+    int32_t i32Ppm;
+    int32_t i32Old;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_DriftAddSample");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcDrift == NULL) || ((pstcDrift->pstcTempComp != NULL) && (pstcDrift->enMode != AMx8x5ModeCalibrateXT)))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pbApplied != NULL) *pbApplied = false;
+
+    i64X = (int64_t)u32RefSeconds - pstcDrift->u32X0;
+    i64Y = (int64_t)i32OffsetUs - pstcDrift->i32Y0;
+    if ((pstcDrift->u8Count == 0) || (pstcDrift->u8Count == 255) || (i64X <= 0) || (i64X >= (1L << 22)) ||
+        (i64Y >= (1L << 23)) || (i64Y <= -(1L << 23)))
+    {
+        Amx8x5_DriftRestart(pstcDrift,u32RefSeconds,i32OffsetUs);
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    //
+    // Reject samples too far from the prediction of the current fit:
+    // 1000 * n * y' = 1000 * Sy + ppb * (n * x - Sx)
+    //
+    i64N = pstcDrift->u8Count;
+    if (Amx8x5_DriftSlope(pstcDrift,&i64D))
+    {
+        i64R = i64Y - (1000 * pstcDrift->i64Sy + pstcDrift->i32DriftPpb * (i64N * i64X - pstcDrift->i64Sx)) / (1000 * i64N);
+        if ((i64R > (int64_t)pstcDrift->u32OutlierUs) || (i64R < -(int64_t)pstcDrift->u32OutlierUs))
+        {
+            pstcDrift->u8Rejected++;
+            if (pstcDrift->u8Rejected >= AMX8X5_DRIFT_MAX_REJECTS)
+            {
+                Amx8x5_DriftRestart(pstcDrift,u32RefSeconds,i32OffsetUs);
+            }
+            return AMX8X5_FUNC_END(Ok);
+        }
+        pstcDrift->u64Srr += (uint64_t)(i64R * i64R);
+        pstcDrift->u8Residuals++;
+    }
+    pstcDrift->u8Rejected = 0;
+
+    pstcDrift->u8Count++;
+    pstcDrift->i64Sx += i64X;
+    pstcDrift->i64Sy += i64Y;
+    pstcDrift->i64Sxx += i64X * i64X;
+    pstcDrift->i64Sxy += i64X * i64Y;
+    i64N++;
+
+    if (!Amx8x5_DriftSlope(pstcDrift,&i64D) || (pstcDrift->u8Count < AMX8X5_DRIFT_MIN_SAMPLES) || (pstcDrift->u8Residuals < AMX8X5_DRIFT_MIN_SAMPLES))
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    //
+    // Standard error of the slope, from the prediction residuals:
+    // se^2 = 10^6 * s^2 * n / D [ppb^2], confident if se <= u16ConfidencePpb.
+    //
+    u64Limit = (uint64_t)pstcDrift->u16ConfidencePpb * pstcDrift->u16ConfidencePpb;
+    if (u64Limit == 0)
+    {
+        u64Limit = 1;
+    }
+    u64Se2 = (pstcDrift->u64Srr / pstcDrift->u8Residuals) * (uint64_t)i64N;
+    i64D /= 1000000;
+    if (u64Se2 / u64Limit > (uint64_t)i64D)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+    u64Se2 = (i64D > 0) ? (u64Se2 / (uint64_t)i64D) : u64Limit;
+
+    if (pstcDrift->pstcTempComp != NULL)
+    {
+        //
+        // Offset of the temperature compensation in 1/16 ppm, changed by at
+        // least 1 ppm. It writes the calibration with its next service.
+        //
+        i32Ppm = pstcDrift->i32DriftPpb * 16;
+        i32Ppm = pstcDrift->pstcTempComp->i32OffsetPpm16 - ((i32Ppm >= 0) ? (i32Ppm + 500) : (i32Ppm - 500)) / 1000;
+        if (i32Ppm < AMX8X5_CALIBRATION_XT_MIN_PPM * 16) i32Ppm = AMX8X5_CALIBRATION_XT_MIN_PPM * 16;
+        if (i32Ppm > AMX8X5_CALIBRATION_XT_MAX_PPM * 16) i32Ppm = AMX8X5_CALIBRATION_XT_MAX_PPM * 16;
+        i32Old = pstcDrift->pstcTempComp->i32OffsetPpm16;
+        if (((i32Ppm - i32Old < 16) && (i32Old - i32Ppm < 16)) || !Amx8x5_DriftImproves(pstcDrift,i32Old,i32Ppm,u64Se2))
+        {
+            return AMX8X5_FUNC_END(Ok);
+        }
+        pstcDrift->pstcTempComp->i32OffsetPpm16 = i32Ppm;
+        pstcDrift->pstcTempComp->bWritten = false;
+    }
+    else
+    {
+        //
+        // RTC fast (offset growing) needs a negative adjustment.
+        //
+        i32Ppm = pstcDrift->i32AppliedPpm - ((pstcDrift->i32DriftPpb >= 0) ? (pstcDrift->i32DriftPpb + 500) : (pstcDrift->i32DriftPpb - 500)) / 1000;
+        if (pstcDrift->enMode == AMx8x5ModeCalibrateXT)
+        {
+            if (i32Ppm < AMX8X5_CALIBRATION_XT_MIN_PPM) i32Ppm = AMX8X5_CALIBRATION_XT_MIN_PPM;
+            if (i32Ppm > AMX8X5_CALIBRATION_XT_MAX_PPM) i32Ppm = AMX8X5_CALIBRATION_XT_MAX_PPM;
+        }
+        else
+        {
+            if (i32Ppm < AMX8X5_CALIBRATION_RC_MIN_PPM) i32Ppm = AMX8X5_CALIBRATION_RC_MIN_PPM;
+            if (i32Ppm > AMX8X5_CALIBRATION_RC_MAX_PPM) i32Ppm = AMX8X5_CALIBRATION_RC_MAX_PPM;
+        }
+        if ((i32Ppm == pstcDrift->i32AppliedPpm) || !Amx8x5_DriftImproves(pstcDrift,pstcDrift->i32AppliedPpm,i32Ppm,u64Se2))
+        {
+            return AMX8X5_FUNC_END(Ok);
+        }
+
+        res = Amx8x5_SetCalibrationValue(pstcHandle,pstcDrift->enMode,i32Ppm);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        pstcDrift->i32AppliedPpm = i32Ppm;
+    }
+
+    res = Amx8x5_DriftWrite(pstcHandle,pstcDrift,i32Ppm);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // The rate changed, offsets from now on have a new slope.
+    //
+    Amx8x5_DriftRestart(pstcDrift,u32RefSeconds,i32OffsetUs);
+    if (pbApplied != NULL) *pbApplied = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize the temperature compensation of the XT oscillator
+ **
+ ** \param  pstcTempComp    Temperature compensation
+ **
+ ** \param  pi16Ppm         Crystal frequency deviation in 1/16 ppm at
+ **                         i8StartC + i * u8StepC degC, i = 0..u8Count-1
+ **
+ ** \param  u8Count         Table entries, min. 1
+ **
+ ** \param  i8StartC        Temperature of the first entry in degC
+ **
+ ** \param  u8StepC         Temperature step between entries in degC, min. 1
+ **
+ ** \param  pfnTemperature  Reads the temperature next to the crystal
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TempCompInit(stc_amx8x5_tempcomp_t* pstcTempComp, const int16_t* pi16Ppm, uint8_t u8Count, int8_t i8StartC, uint8_t u8StepC, pfn_amx8x5_temperature pfnTemperature)
+{
+    if ((pstcTempComp == NULL) || (pi16Ppm == NULL) || (u8Count == 0) || (u8StepC == 0) || (pfnTemperature == NULL))
+    {
+        return ErrorInvalidParameter;
+    }
+    pstcTempComp->pi16Ppm = pi16Ppm;
+    pstcTempComp->u8Count = u8Count;
+    pstcTempComp->i8StartC = i8StartC;
+    pstcTempComp->u8StepC = u8StepC;
+    pstcTempComp->pfnTemperature = pfnTemperature;
+    pstcTempComp->i32OffsetPpm16 = 0;
+    pstcTempComp->i16Steps = 0;
+    pstcTempComp->bWritten = false;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Crystal deviation at a temperature, linear between table entries
+ **
+ ** \param  pstcTempComp    Temperature compensation
+ **
+ ** \param  i16Temperature  Temperature in 1/16 degC
+ **
+ ** \return deviation in 1/16 ppm, the first / last entry outside the table
+ **
+ ******************************************************************************/
+int32_t Amx8x5_TempCompDeviation(stc_amx8x5_tempcomp_t* pstcTempComp, int16_t i16Temperature)
+{
+    int32_t i32Pos = (int32_t)i16Temperature - (int32_t)pstcTempComp->i8StartC * 16;
+    int32_t i32Step = (int32_t)pstcTempComp->u8StepC * 16;
+    int32_t i32Index;
+    const int16_t* pi16Ppm = pstcTempComp->pi16Ppm;
+
+    if (i32Pos <= 0)
+    {
+        return pi16Ppm[0];
+    }
+    i32Index = i32Pos / i32Step;
+    if (i32Index >= (int32_t)pstcTempComp->u8Count - 1)
+    {
+        return pi16Ppm[pstcTempComp->u8Count - 1];
+    }
+    i32Pos -= i32Index * i32Step;
+    return pi16Ppm[i32Index] + ((int32_t)(pi16Ppm[i32Index + 1] - pi16Ppm[i32Index]) * i32Pos) / i32Step;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Read the temperature and update the XT calibration if needed
+ **
+ ** The correction is the static offset i32OffsetPpm16 (e.g. from
+ ** Amx8x5_DriftAddSample() with stc_amx8x5_drift_t::pstcTempComp set) minus
+ ** the crystal deviation at the measured temperature, rounded to
+ ** calibration steps of 1.907 ppm. The calibration registers are only
+ ** written if the step differs from the last written one or bWritten was
+ ** cleared, so a stable temperature causes no bus traffic besides the sensor.
+ **
+ ** \param  pstcHandle      RTC Handle
+ **
+ ** \param  pstcTempComp    Temperature compensation
+ **
+ ** \param  pbWritten       Returns true if the calibration was written, may be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ** Example:
+ ** @code
+ ** // tuning fork crystal, -0.034 ppm/degC^2 around 25 degC, -40..85 degC
+ ** static const int16_t ai16Xt[] = {-2298,-1958,-1646,-1360,-1102,-870,-666,-490,-340,
+ **                                  -218,-122,-54,-14,0,-14,-54,-122,-218,-340,-490,
+ **                                  -666,-870,-1102,-1360,-1646,-1958};
+ ** Amx8x5_TempCompInit(&stcTempComp,ai16Xt,26,-40,5,ReadSensor);
+ ** Amx8x5_TempCompService(&stcRtcConfig,&stcTempComp,NULL); // e.g. every minute
+ ** @endcode
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TempCompService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tempcomp_t* pstcTempComp, bool* pbWritten)
+{
+    int16_t i16Temperature;
+    int32_t i32Ppm16;
+    int32_t i32Steps;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TempCompService");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcTempComp == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pbWritten != NULL) *pbWritten = false;
+
+    res = pstcTempComp->pfnTemperature(pstcHandle,&i16Temperature);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // Steps of 1.907 ppm: round(ppm16 * 1000 / (16 * 1907)).
+    //
+    i32Ppm16 = pstcTempComp->i32OffsetPpm16 - Amx8x5_TempCompDeviation(pstcTempComp,i16Temperature);
+    if (i32Ppm16 < 0)
+    {
+        i32Steps = (i32Ppm16 * 1000 - 15256) / 30512;
+    }
+    else
+    {
+        i32Steps = (i32Ppm16 * 1000 + 15256) / 30512;
+    }
+    if (i32Steps < -320) i32Steps = -320;
+    if (i32Steps > 127) i32Steps = 127;
+
+    if (pstcTempComp->bWritten && (i32Steps == pstcTempComp->i16Steps))
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    //
+    // Back to whole ppm that Amx8x5_SetCalibrationValue() rounds to the
+    // same step.
+    //
+    res = Amx8x5_SetCalibrationValue(pstcHandle,AMx8x5ModeCalibrateXT,(i32Steps * 1907 + ((i32Steps < 0) ? -500 : 500)) / 1000);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcTempComp->i16Steps = (int16_t)i32Steps;
+    pstcTempComp->bWritten = true;
+    if (pbWritten != NULL) *pbWritten = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize an oscillator health monitor
+ **
+ ** Attach it to the interrupt dispatcher via
+ ** stc_amx8x5_irq_dispatcher_t::pstcOscHealth and enable OFIE / ACIE, so
+ ** every Amx8x5_IrqDispatch() feeds it with the OSC_STATUS read anyway.
+ **
+ ** \param  pstcHealth     Monitor, see #stc_amx8x5_osc_health_t
+ **
+ ** \param  enPolicy       Action once u8Threshold autocalibration failures are counted
+ **
+ ** \param  u8Threshold    Autocalibration failures triggering enPolicy, 0 = never
+ **
+ ** \param  pfnAlert       Called on every new failure, can be NULL
+ **
+ ** \param  pfnClock       Timestamp source of the last failures in microseconds (e.g. micros), can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_OscHealthInit(stc_amx8x5_osc_health_t* pstcHealth, en_amx8x5_osc_health_policy_t enPolicy, uint8_t u8Threshold, pfn_amx8x5_osc_health_alert pfnAlert, pfn_amx8x5_micros pfnClock)
+{
+    if ((pstcHealth == NULL) || (enPolicy > AMx8x5OscHealthPolicyFallbackXt))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcHealth,0,sizeof(stc_amx8x5_osc_health_t));
+    pstcHealth->enPolicy = enPolicy;
+    pstcHealth->u8Threshold = u8Threshold;
+    pstcHealth->pfnAlert = pfnAlert;
+    pstcHealth->pfnClock = pfnClock;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Feed an OSC_STATUS value into the oscillator health monitor
+ **
+ ** Takes a value read anyway (interrupt dispatch, Amx8x5_SaveState()) and
+ ** counts OF and ACF flags not set in the previous sample.
+ ** The bus is only accessed when the policy is executed, once per monitor.
+ ** Flags must be cleared by the caller to see the next failure,
+ ** Amx8x5_IrqDispatch() does so for an attached monitor.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcHealth     Monitor, see #stc_amx8x5_osc_health_t
+ **
+ ** \param  u8OscStatus    OSC_STATUS register value
+ **
+ ** \param  pu8Failures    Returns the new failures as mask of OF and ACF, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_OscHealthSample(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_osc_health_t* pstcHealth, uint8_t u8OscStatus, uint8_t* pu8Failures)
+{
+    uint8_t u8New;
+    uint32_t u32Now;
+    en_result_t res = Ok;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_OscHealthSample");
+
+    if (pu8Failures != NULL) *pu8Failures = 0;
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcHealth == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    u8OscStatus &= (AMX8X5_REG_OSC_STATUS_OF_MSK | AMX8X5_REG_OSC_STATUS_ACF_MSK);
+    u8New = u8OscStatus & ~pstcHealth->u8Flags;
+    pstcHealth->u8Flags = u8OscStatus;
+    if (u8New == 0)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    u32Now = (pstcHealth->pfnClock != NULL) ? pstcHealth->pfnClock() : 0;
+    if (u8New & AMX8X5_REG_OSC_STATUS_OF_MSK)
+    {
+        if (pstcHealth->u16OfCount < 0xFFFF) pstcHealth->u16OfCount++;
+        pstcHealth->u32LastOf = u32Now;
+    }
+    if (u8New & AMX8X5_REG_OSC_STATUS_ACF_MSK)
+    {
+        if (pstcHealth->u16AcfCount < 0xFFFF) pstcHealth->u16AcfCount++;
+        pstcHealth->u32LastAcf = u32Now;
+    }
+
+    //
+    // Policy is executed once, a failed write is retried with the next failure.
+    //
+    if ((pstcHealth->u8Threshold != 0) && (!pstcHealth->bPolicyApplied) && (pstcHealth->u16AcfCount >= pstcHealth->u8Threshold))
+    {
+        switch(pstcHealth->enPolicy)
+        {
+            case AMx8x5OscHealthPolicyShortenAutocal:
+                res = Amx8x5_SetAutocalibration(pstcHandle,AMx8x5AutoCalibrationPeriodCycleSecods512);
+                break;
+            case AMx8x5OscHealthPolicyFallbackXt:
+                res = Amx8x5_SelectOscillatorMode(pstcHandle,AMx8x5Xt32KHzNoSwitch);
+                break;
+            default:
+                break;
+        }
+        pstcHealth->bPolicyApplied = (res == Ok);
+    }
+
+    if (pstcHealth->pfnAlert != NULL)
+    {
+        pstcHealth->pfnAlert(pstcHandle,u8New);
+    }
+    if (pu8Failures != NULL) *pu8Failures = u8New;
+    return AMX8X5_FUNC_END(res);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Estimate the battery voltage with the BREF comparator (AM18x5)
+ **
+ ** Binary search over the four BREF thresholds, starting with the one
+ ** currently set so the first probe needs no write. Every further probe
+ ** writes BREF and reads BBOD of ASTAT right after, BREF is restored at the
+ ** end if it was changed. At most three probes are needed.
+ **
+ ** The comparator has hysteresis, the bracket uses the falling voltage of
+ ** the highest threshold passed as lower and the rising voltage of the next
+ ** threshold as upper bound.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pu8Level       Returns the thresholds VBAT is above (0..4)
+ **
+ ** \param  pu16MinMv      Returns the lower bound in mV, can be NULL
+ **
+ ** \param  pu16MaxMv      Returns the upper bound in mV, #AMX8X5_BATTERY_UNKNOWN_MV above 3.0V, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_BatteryEstimate(stc_amx8x5_handle_t* pstcHandle, uint8_t* pu8Level, uint16_t* pu16MinMv, uint16_t* pu16MaxMv)
+{
+    uint8_t au8Reg[AMX8X5_REG_ASTAT - AMX8X5_REG_BREF_CTRL + 1];
+    uint8_t u8Bref;
+    uint8_t u8Current;
+    uint8_t u8Astat;
+    uint8_t u8Lo = 0;
+    uint8_t u8Hi = AMX8X5_BATTERY_LEVELS;
+    uint8_t u8Probe;
+    en_result_t res;
+    en_result_t resRestore;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_BatteryEstimate");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pu8Level == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    //
+    // BREF and ASTAT in one burst.
+    //
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_BREF_CTRL,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    u8Bref = au8Reg[0];
+    u8Current = u8Bref;
+    u8Astat = au8Reg[sizeof(au8Reg) - 1];
+
+    for(u8Probe = 0; u8Probe < AMX8X5_BATTERY_LEVELS; u8Probe++)
+    {
+        if (au8BatteryBref[u8Probe] == (u8Bref & AMX8X5_REG_BREF_CTRL_BREF_MSK)) break;
+    }
+    while(u8Lo < u8Hi)
+    {
+        if (u8Probe >= AMX8X5_BATTERY_LEVELS)
+        {
+            u8Probe = (u8Lo + u8Hi) / 2;
+            u8Current = au8BatteryBref[u8Probe] | (u8Bref & ~AMX8X5_REG_BREF_CTRL_BREF_MSK);
+            res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+            if (res == Ok) res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_BREF_CTRL,u8Current);
+            if (res == Ok) res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_ASTAT,&u8Astat);
+            if (res != Ok)
+            {
+                break;
+            }
+        }
+        if (u8Astat & AMX8X5_REG_ASTAT_BBOD_MSK)
+        {
+            u8Lo = u8Probe + 1;
+        }
+        else
+        {
+            u8Hi = u8Probe;
+        }
+        u8Probe = AMX8X5_BATTERY_LEVELS;
+    }
+
+    //
+    // Restore BREF, also after a failed probe.
+    //
+    if (u8Current != u8Bref)
+    {
+        resRestore = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+        if (resRestore == Ok) resRestore = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_BREF_CTRL,u8Bref);
+        if (res == Ok) res = resRestore;
+    }
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    *pu8Level = u8Lo;
+    if (pu16MinMv != NULL) *pu16MinMv = (u8Lo > 0) ? au16BatteryFallingMv[u8Lo - 1] : 0;
+    if (pu16MaxMv != NULL) *pu16MaxMv = (u8Lo < AMX8X5_BATTERY_LEVELS) ? au16BatteryRisingMv[u8Lo] : AMX8X5_BATTERY_UNKNOWN_MV;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a scheduled battery estimation
+ **
+ ** \param  pstcBattery    Estimation, see #stc_amx8x5_battery_t
+ **
+ ** \param  u32Period      Seconds between measurements
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_BatteryInit(stc_amx8x5_battery_t* pstcBattery, uint32_t u32Period)
+{
+    if (pstcBattery == NULL)
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcBattery,0,sizeof(stc_amx8x5_battery_t));
+    pstcBattery->u32Period = u32Period;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Run the battery estimation when its period elapsed
+ **
+ ** Without bus access until u32Period seconds passed since the last
+ ** measurement. The first measurement is reported directly, a different
+ ** level afterwards only when measured #AMX8X5_BATTERY_CONFIRM times in a
+ ** row, so a voltage on a threshold does not toggle the reported level.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcBattery    Estimation, see #stc_amx8x5_battery_t
+ **
+ ** \param  u32Now         Current time in seconds, e.g. Amx8x5_GetSeconds()
+ **
+ ** \param  pbChanged      Returns true if the reported level changed, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_BatteryService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_battery_t* pstcBattery, uint32_t u32Now, bool* pbChanged)
+{
+    uint8_t u8Level;
+    uint16_t u16MinMv;
+    uint16_t u16MaxMv;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_BatteryService");
+
+    if (pbChanged != NULL) *pbChanged = false;
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcBattery == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pstcBattery->bValid && ((u32Now - pstcBattery->u32Last) < pstcBattery->u32Period))
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    res = Amx8x5_BatteryEstimate(pstcHandle,&u8Level,&u16MinMv,&u16MaxMv);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcBattery->u32Last = u32Now;
+
+    if (pstcBattery->bValid)
+    {
+        if (u8Level == pstcBattery->u8Level)
+        {
+            pstcBattery->u8Confirm = 0;
+            return AMX8X5_FUNC_END(Ok);
+        }
+        if ((pstcBattery->u8Confirm == 0) || (u8Level != pstcBattery->u8Pending))
+        {
+            pstcBattery->u8Pending = u8Level;
+            pstcBattery->u8Confirm = 0;
+        }
+        pstcBattery->u8Confirm++;
+        if (pstcBattery->u8Confirm < AMX8X5_BATTERY_CONFIRM)
+        {
+            return AMX8X5_FUNC_END(Ok);
+        }
+    }
+    pstcBattery->u8Level = u8Level;
+    pstcBattery->u16MinMv = u16MinMv;
+    pstcBattery->u16MaxMv = u16MaxMv;
+    pstcBattery->u8Confirm = 0;
+    pstcBattery->bValid = true;
+    if (pbChanged != NULL) *pbChanged = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a trickle charger policy (AM18x5)
+ **
+ ** Defaults: schottky diode with 3K while boosting, schottky diode with 11K
+ ** when tapering. The fields can be changed afterwards.
+ **
+ ** \param  pstcPolicy       Policy, see #stc_amx8x5_trickle_policy_t
+ **
+ ** \param  u8FullLevel      Battery level charging stops at (1..4), see Amx8x5_BatteryEstimate()
+ **
+ ** \param  u32BoostSeconds  Max. charge time with the boost setting in seconds
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TrickleInit(stc_amx8x5_trickle_policy_t* pstcPolicy, uint8_t u8FullLevel, uint32_t u32BoostSeconds)
+{
+    if ((pstcPolicy == NULL) || (u8FullLevel == 0) || (u8FullLevel > AMX8X5_BATTERY_LEVELS))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcPolicy,0,sizeof(stc_amx8x5_trickle_policy_t));
+    pstcPolicy->u8FullLevel = u8FullLevel;
+    pstcPolicy->u32BoostSeconds = u32BoostSeconds;
+    pstcPolicy->enBoostDiode = AMx8x5TrickleDiodeSchottky;
+    pstcPolicy->enBoostResistor = AMx8x5TrickleResistor3K;
+    pstcPolicy->enTaperDiode = AMx8x5TrickleDiodeSchottky;
+    pstcPolicy->enTaperResistor = AMx8x5TrickleResistor11K;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Select the trickle charger setting for the battery level (AM18x5)
+ **
+ ** Off at u8FullLevel, taper setting one level below full or once charging
+ ** took u32BoostSeconds, boost setting otherwise. TRICKLE is written under
+ ** CONFIG_KEY only if the selected value differs from the one last written.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcPolicy     Policy, see #stc_amx8x5_trickle_policy_t
+ **
+ ** \param  u8Level        Battery level, e.g. stc_amx8x5_battery_t::u8Level
+ **
+ ** \param  u32Now         Current time in seconds, e.g. Amx8x5_GetSeconds()
+ **
+ ** \param  pbWritten      Returns true if TRICKLE was written, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TrickleService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_trickle_policy_t* pstcPolicy, uint8_t u8Level, uint32_t u32Now, bool* pbWritten)
+{
+    uint8_t u8Trickle;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TrickleService");
+
+    if (pbWritten != NULL) *pbWritten = false;
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcPolicy == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    if (u8Level >= pstcPolicy->u8FullLevel)
+    {
+        pstcPolicy->bCharging = false;
+        u8Trickle = 0;
+    }
+    else
+    {
+        if (!pstcPolicy->bCharging)
+        {
+            pstcPolicy->bCharging = true;
+            pstcPolicy->u32ChargeStart = u32Now;
+        }
+        if (((u8Level + 1) >= pstcPolicy->u8FullLevel) || ((u32Now - pstcPolicy->u32ChargeStart) >= pstcPolicy->u32BoostSeconds))
+        {
+            u8Trickle = Amx8x5_TrickleEncode(pstcPolicy->enTaperDiode,pstcPolicy->enTaperResistor,true);
+        }
+        else
+        {
+            u8Trickle = Amx8x5_TrickleEncode(pstcPolicy->enBoostDiode,pstcPolicy->enBoostResistor,true);
+        }
+    }
+
+    if (pstcPolicy->bWritten && (u8Trickle == pstcPolicy->u8Trickle))
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_CONFIG_KEY,AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_TRICKLE,u8Trickle);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcPolicy->u8Trickle = u8Trickle;
+    pstcPolicy->bWritten = true;
+    if (pbWritten != NULL) *pbWritten = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Arm the wake sources and enter sleep (AM18x5 only)
+ **
+ ** Reads HUNDREDTHS..TIMER_CTRL in one burst and builds the new register
+ ** image: the alarm at u32Deadline repeating once per year (GP bits kept), all
+ ** STATUS flags except CB cleared, INT_MASK enabling exactly the wake
+ ** sources, OUT2S set to SLEEP for PSW/nIRQ2 modes. Only the span of changed registers is written
+ ** in one burst, SLEEP_CTRL follows with SLP set and is read back.
+ **
+ ** The alarm hour follows the 12/24 bit of CONTROL_1. As the alarm matches
+ ** once per year, u32Deadline must be at least one second and at most
+ ** #AMX8X5_SWALARM_MAX_ARM seconds ahead of the RTC time read in the burst.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u32Deadline    Wakeup in seconds since 2000-01-01 00:00:00, 0 for no alarm
+ **
+ ** \param  u8WakeSources  Further wake sources as mask of (1 << #en_amx8x5_irq_source_t),
+ **                        AMx8x5IrqEx1 .. AMx8x5IrqBatteryLow
+ **
+ ** \param  u8Timeout      SLTO, 7.8 ms periods after SLP until sleep (0 to 7)
+ **
+ ** \param  enMode         Sleep mode, see Amx8x5_SetSleepMode()
+ **
+ ** \return Ok on sleep request accepted,
+ **         OperationInProgress on sleep request declined, interrupt is currently pending,
+ **         ErrorInvalidMode if no wake source is given,
+ **         ErrorInvalidParameter if u32Deadline is outside that window
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_SleepUntil(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Deadline, uint8_t u8WakeSources, uint8_t u8Timeout, en_amx8x5_sleep_mode_t enMode)
+{
+    uint8_t au8Read[AMX8X5_REG_TIMER_CTRL - AMX8X5_REG_HUNDREDTHS + 1];
+    uint8_t* pu8Old = &au8Read[AMX8X5_REG_ALARM_HUNDRS - AMX8X5_REG_HUNDREDTHS];
+    uint8_t au8New[AMX8X5_REG_TIMER_CTRL - AMX8X5_REG_ALARM_HUNDRS + 1];
+    static const uint8_t au8Gp[7] = {0x00, 0x80, 0x80, 0xC0, 0xC0, 0xE0, 0xF8}; // GP bits of the alarm registers
+    uint8_t au8Time[8];
+    uint8_t u8Sleep;
+    uint8_t u8First;
+    uint8_t u8Last;
+    uint8_t i;
+    uint32_t u32Now;
+    stc_amx8x5_time_t stcAlarm;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_SleepUntil");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pstcHandle->enRtcType != AMx8x5Type1805) && (pstcHandle->enRtcType != AMx8x5Type1815))
+    {
+        return AMX8X5_FUNC_END(Error);
+    }
+    if ((u8Timeout > AMX8X5_REG_SLEEP_CTRL_SLTO_MSK) || (enMode > AMx8x5nRstLoPswIrq2HighInSleep) || (u8WakeSources & ~0x1F))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if ((u32Deadline == 0) && (u8WakeSources == 0))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidMode);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,au8Read,sizeof(au8Read));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    memcpy(au8New,pu8Old,sizeof(au8New));
+
+    //
+    // Alarm registers hundredths..month and weekday keeping the GP bits,
+    // RPT once per year.
+    //
+    if (u32Deadline != 0)
+    {
+        //
+        // The alarm matches once per year: the deadline must be ahead of the
+        // counters read in the same burst and within a year.
+        //
+        memset(&stcAlarm,0,sizeof(stcAlarm));
+        stcAlarm.u8Second = AMX8X5_BCD_TO_DEC(au8Read[1] & 0x7F);
+        stcAlarm.u8Minute = AMX8X5_BCD_TO_DEC(au8Read[2] & 0x7F);
+        stcAlarm.u8Date = AMX8X5_BCD_TO_DEC(au8Read[4] & 0x3F);
+        stcAlarm.u8Month = AMX8X5_BCD_TO_DEC(au8Read[5] & 0x1F);
+        stcAlarm.u8Year = AMX8X5_BCD_TO_DEC(au8Read[6]);
+        if ((au8Read[AMX8X5_REG_CONTROL_1 - AMX8X5_REG_HUNDREDTHS] & AMX8X5_REG_CONTROL_1_12_24_MSK) == 0)
+        {
+            stcAlarm.u8Mode = AMX8X5_24HR_MODE;
+            stcAlarm.u8Hour = AMX8X5_BCD_TO_DEC(au8Read[3] & 0x3F);
+        }
+        else
+        {
+            stcAlarm.u8Mode = (au8Read[3] & 0x20) ? AMX8X5_12HR_MODE : 0;
+            stcAlarm.u8Hour = AMX8X5_BCD_TO_DEC(au8Read[3] & 0x1F);
+        }
+        res = Amx8x5_TimeToSeconds(&stcAlarm,&u32Now);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        if ((u32Deadline <= u32Now) || ((u32Deadline - u32Now) > AMX8X5_SWALARM_MAX_ARM))
+        {
+            return AMX8X5_FUNC_END(ErrorInvalidParameter);
+        }
+
+        res = Amx8x5_SecondsToTime(u32Deadline,&stcAlarm);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        if ((au8Read[AMX8X5_REG_CONTROL_1 - AMX8X5_REG_HUNDREDTHS] & AMX8X5_REG_CONTROL_1_12_24_MSK) != 0)
+        {
+            Amx8x5_TimeTo12Hour(&stcAlarm);
+        }
+        Amx8x5_TimeToRegisters(&stcAlarm,au8Time);
+        au8Time[6] = au8Time[7];
+        for(i = 0; i < 7; i++)
+        {
+            au8New[i] = (pu8Old[i] & au8Gp[i]) | au8Time[i];
+        }
+        au8New[AMX8X5_REG_TIMER_CTRL - AMX8X5_REG_ALARM_HUNDRS] = (pu8Old[AMX8X5_REG_TIMER_CTRL - AMX8X5_REG_ALARM_HUNDRS] & ~AMX8X5_REG_TIMER_CTRL_RPT_MSK) |
+                                                                  ((uint8_t)AMx8x5AlarmYear << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+        u8WakeSources |= AMX8X5_REG_INT_MASK_AIE_MSK;
+    }
+
+    //
+    // INT_MASK bits EX1E..BLIE map 1:1 to the sources AMx8x5IrqEx1..AMx8x5IrqBatteryLow.
+    //
+    au8New[AMX8X5_REG_STATUS - AMX8X5_REG_ALARM_HUNDRS] &= AMX8X5_REG_STATUS_CB_MSK;
+    au8New[AMX8X5_REG_INT_MASK - AMX8X5_REG_ALARM_HUNDRS] = (pu8Old[AMX8X5_REG_INT_MASK - AMX8X5_REG_ALARM_HUNDRS] & 0xE0) | u8WakeSources;
+    if (enMode != AMx8x5nRstLowInSleep)
+    {
+        au8New[AMX8X5_REG_CONTROL_2 - AMX8X5_REG_ALARM_HUNDRS] = (pu8Old[AMX8X5_REG_CONTROL_2 - AMX8X5_REG_ALARM_HUNDRS] & ~AMX8X5_REG_CONTROL_2_OUT2S_MSK) |
+                                                                 ((uint8_t)AMx8x5Out2Sleep << AMX8X5_REG_CONTROL_2_OUT2S_POS);
+    }
+
+    //
+    // SLEEP_CTRL is written last, inside the burst it keeps SLP cleared.
+    //
+    pu8Old[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_ALARM_HUNDRS] &= ~AMX8X5_REG_SLEEP_CTRL_SLP_MSK;
+    au8New[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_ALARM_HUNDRS] = pu8Old[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_ALARM_HUNDRS];
+    u8Sleep = (pu8Old[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_ALARM_HUNDRS] & (AMX8X5_REG_SLEEP_CTRL_EX2P_MSK | AMX8X5_REG_SLEEP_CTRL_EX1P_MSK)) |
+              AMX8X5_REG_SLEEP_CTRL_SLP_MSK | u8Timeout;
+    if (enMode != AMx8x5PswIrq2HighInSleep)
+    {
+        u8Sleep |= AMX8X5_REG_SLEEP_CTRL_SLRES_MSK;
+    }
+
+    u8First = sizeof(au8New);
+    u8Last = 0;
+    for(i = 0; i < sizeof(au8New); i++)
+    {
+        if (au8New[i] != pu8Old[i])
+        {
+            if (u8First == sizeof(au8New)) u8First = i;
+            u8Last = i;
+        }
+    }
+    if (u8First < sizeof(au8New))
+    {
+        res = Amx8x5_WriteBytes(pstcHandle,AMX8X5_REG_ALARM_HUNDRS + u8First,&au8New[u8First],u8Last - u8First + 1);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_SLEEP_CTRL,u8Sleep);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    //
+    // SLP stays 0 if an enabled interrupt is pending.
+    //
+    res = Amx8x5_ReadByte(pstcHandle,AMX8X5_REG_SLEEP_CTRL,&u8Sleep);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if ((u8Sleep & AMX8X5_REG_SLEEP_CTRL_SLP_MSK) == 0)
+    {
+        return AMX8X5_FUNC_END(OperationInProgress);
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Decode why the system is running again (AM18x5 only)
+ **
+ ** One burst read of STATUS..SLEEP_CTRL. Flags are not cleared, reading
+ ** SLEEP_CTRL clears SLST.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcReason     Returns the wake reason, see #stc_amx8x5_wake_reason_t
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_WakeReason(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_wake_reason_t* pstcReason)
+{
+    uint8_t au8Reg[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_STATUS + 1];
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_WakeReason");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcReason == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_STATUS,au8Reg,sizeof(au8Reg));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcReason->u8Sources = au8Reg[0] & 0x3F;
+    pstcReason->bBattery = (au8Reg[0] & AMX8X5_REG_STATUS_BAT_MSK) != 0;
+    pstcReason->bSlept = (au8Reg[AMX8X5_REG_SLEEP_CTRL - AMX8X5_REG_STATUS] & AMX8X5_REG_SLEEP_CTRL_SLST_MSK) != 0;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Write the power-fail record in one burst
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcPowerFail  Recorder, see #stc_amx8x5_powerfail_t
+ **
+ ** \param  pu8Start       Outage start, 8 time registers read from HUNDREDTHS
+ **
+ ** \param  u32Duration    Outage duration in seconds
+ **
+ ** \param  u8Flags        Record flags, e.g. #AMX8X5_POWERFAIL_OPEN
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_PowerFailWrite(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail, const uint8_t* pu8Start, uint32_t u32Duration, uint8_t u8Flags)
+{
+    uint8_t au8Record[AMX8X5_POWERFAIL_SIZE];
+    uint8_t i;
+    en_result_t res;
+
+    memcpy(au8Record,pu8Start,8);
+    for(i = 0; i < 4; i++)
+    {
+        au8Record[8 + i] = (uint8_t)(u32Duration >> (8 * i));
+    }
+    au8Record[12] = (uint8_t)(pstcPowerFail->u16Count & 0xFF);
+    au8Record[13] = (uint8_t)(pstcPowerFail->u16Count >> 8);
+    au8Record[14] = u8Flags;
+    au8Record[15] = Amx8x5_RecordCheck(au8Record,AMX8X5_POWERFAIL_SIZE - 1);
+
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcPowerFail->u8Xadd);
+    if (res != Ok)
+    {
+        return res;
+    }
+    return Amx8x5_WriteBytes(pstcHandle,(pstcPowerFail->u8RamAddress & 0x3F) | 0x40,au8Record,AMX8X5_POWERFAIL_SIZE);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a power-fail recorder
+ **
+ ** \param  pstcPowerFail  Recorder, see #stc_amx8x5_powerfail_t
+ **
+ ** \param  u8RamAddress   RTC RAM address of the record, e.g. #AMX8X5_RAM_POWERFAIL,
+ **                        the record must not cross a 64 byte bank
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_PowerFailInit(stc_amx8x5_powerfail_t* pstcPowerFail, uint8_t u8RamAddress)
+{
+    if ((pstcPowerFail == NULL) || ((u8RamAddress & 0x3F) > (0x40 - AMX8X5_POWERFAIL_SIZE)))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcPowerFail,0,sizeof(stc_amx8x5_powerfail_t));
+    pstcPowerFail->u8RamAddress = u8RamAddress;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Load the power-fail record and close an open outage
+ **
+ ** Call at boot and when main power returned. An outage recorded by
+ ** Amx8x5_PowerFailRecord() is closed with its duration up to the current
+ ** RTC time. A missing or corrupt record is replaced by an empty one.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcPowerFail  Recorder, initialized by Amx8x5_PowerFailInit()
+ **
+ ** \param  pstcOutage     Returns the last outage, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_PowerFailRecover(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail, stc_amx8x5_outage_t* pstcOutage)
+{
+    uint8_t au8Record[AMX8X5_POWERFAIL_SIZE];
+    uint32_t u32Start = 0;
+    uint32_t u32Duration = 0;
+    uint32_t u32Now;
+    uint8_t i;
+    bool bNew = false;
+    en_result_t res;
+    stc_amx8x5_time_t* pstcTime;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_PowerFailRecover");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcPowerFail == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetExtensionAddress(pstcHandle,pstcPowerFail->u8RamAddress,&pstcPowerFail->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcPowerFail->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ReadBytes(pstcHandle,(pstcPowerFail->u8RamAddress & 0x3F) | 0x40,au8Record,AMX8X5_POWERFAIL_SIZE);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    if (au8Record[AMX8X5_POWERFAIL_SIZE - 1] == Amx8x5_RecordCheck(au8Record,AMX8X5_POWERFAIL_SIZE - 1))
+    {
+        for(i = 0; i < 4; i++)
+        {
+            u32Duration |= (uint32_t)au8Record[8 + i] << (8 * i);
+        }
+        pstcPowerFail->u16Count = (uint16_t)au8Record[12] | ((uint16_t)au8Record[13] << 8);
+        bNew = (au8Record[14] & AMX8X5_POWERFAIL_OPEN) != 0;
+    }
+    else
+    {
+        //
+        // First start or RTC lost VBAT, start with an empty record.
+        //
+        memset(au8Record,0,sizeof(au8Record));
+        pstcPowerFail->u16Count = 0;
+        res = Amx8x5_PowerFailWrite(pstcHandle,pstcPowerFail,au8Record,0,0);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    if (pstcPowerFail->u16Count != 0)
+    {
+        //
+        // The interrupt stored the raw time registers, decode them with the
+        // current 12/24 hour mode and century.
+        //
+        res = Amx8x5_RegistersToTime(pstcHandle,au8Record);
+        if (res == Ok) res = Amx8x5_TimeToSeconds(&stcSysTime,&u32Start);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    if (bNew)
+    {
+        res = Amx8x5_GetTime(pstcHandle,&pstcTime);
+        if (res == Ok) res = Amx8x5_TimeToSeconds(pstcTime,&u32Now);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+        u32Duration = (u32Now > u32Start) ? (u32Now - u32Start) : 0;
+        res = Amx8x5_PowerFailWrite(pstcHandle,pstcPowerFail,au8Record,u32Duration,0);
+        if (res != Ok)
+        {
+            return AMX8X5_FUNC_END(res);
+        }
+    }
+
+    pstcPowerFail->bOpen = false;
+    pstcPowerFail->bReady = true;
+    if (pstcOutage != NULL)
+    {
+        pstcOutage->u32Start = u32Start;
+        pstcOutage->u32Duration = u32Duration;
+        pstcOutage->u16Count = pstcPowerFail->u16Count;
+        pstcOutage->bNew = bNew;
+    }
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Arm the battery low interrupt for power-fail recording (AM18x5)
+ **
+ ** Sets BREF and enables BLIE. Call Amx8x5_PowerFailRecord() from the
+ ** battery low interrupt, e.g. registered for #AMx8x5IrqBatteryLow with
+ ** Amx8x5_IrqDispatcherRegister().
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcPowerFail  Recorder, loaded by Amx8x5_PowerFailRecover()
+ **
+ ** \param  enBref         Threshold of the interrupt, see #en_amx8x5_bat_reference_t
+ **
+ ** \return Ok on success, ErrorNotReady if the record was not loaded,
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_PowerFailArm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail, en_amx8x5_bat_reference_t enBref)
+{
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_PowerFailArm");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcPowerFail == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (!pstcPowerFail->bReady)
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+
+    res = Amx8x5_SetBatteryReferenceVoltage(pstcHandle,enBref);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_EnableIrqBatteryLow(pstcHandle,true));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Record the start of an outage, called from the battery low interrupt
+ **
+ ** One burst read of the time registers and, after selecting the RAM bank,
+ ** one burst write of the record. The registers are stored raw and decoded
+ ** by Amx8x5_PowerFailRecover(). Further calls before Amx8x5_PowerFailRecover() do not
+ ** access the bus, so a bouncing supply is counted once.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcPowerFail  Recorder, loaded by Amx8x5_PowerFailRecover()
+ **
+ ** \return Ok on success, ErrorNotReady if the record was not loaded,
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_PowerFailRecord(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail)
+{
+    uint8_t au8Time[8];
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_PowerFailRecord");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcPowerFail == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (!pstcPowerFail->bReady)
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+    if (pstcPowerFail->bOpen)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    res = Amx8x5_ReadBytes(pstcHandle,AMX8X5_REG_HUNDREDTHS,au8Time,sizeof(au8Time));
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (pstcPowerFail->u16Count < 0xFFFF) pstcPowerFail->u16Count++;
+    res = Amx8x5_PowerFailWrite(pstcHandle,pstcPowerFail,au8Time,0,AMX8X5_POWERFAIL_OPEN);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcPowerFail->bOpen = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Write the heartbeat record from u8Offset in one burst
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcHeartbeat  Heartbeat, see #stc_amx8x5_heartbeat_t
+ **
+ ** \param  u8Offset       0 for the whole record, 4 for last alive time and check byte
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+static en_result_t Amx8x5_HeartbeatWrite(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_heartbeat_t* pstcHeartbeat, uint8_t u8Offset)
+{
+    uint8_t au8Record[AMX8X5_HEARTBEAT_SIZE];
+    uint8_t i;
+    en_result_t res;
+
+    for(i = 0; i < 4; i++)
+    {
+        au8Record[i] = (uint8_t)(pstcHeartbeat->u32Boot >> (8 * i));
+        au8Record[4 + i] = (uint8_t)(pstcHeartbeat->u32Last >> (8 * i));
+    }
+    au8Record[8] = Amx8x5_RecordCheck(au8Record,AMX8X5_HEARTBEAT_SIZE - 1);
+
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcHeartbeat->u8Xadd);
+    if (res != Ok)
+    {
+        return res;
+    }
+    return Amx8x5_WriteBytes(pstcHandle,((pstcHeartbeat->u8RamAddress + u8Offset) & 0x3F) | 0x40,&au8Record[u8Offset],AMX8X5_HEARTBEAT_SIZE - u8Offset);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a last alive heartbeat
+ **
+ ** \param  pstcHeartbeat  Heartbeat, see #stc_amx8x5_heartbeat_t
+ **
+ ** \param  u8RamAddress   RTC RAM address of the record, e.g. #AMX8X5_RAM_HEARTBEAT,
+ **                        the record must not cross a 64 byte bank
+ **
+ ** \param  u32Interval    Seconds between heartbeat writes, the downtime resolution
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_HeartbeatInit(stc_amx8x5_heartbeat_t* pstcHeartbeat, uint8_t u8RamAddress, uint32_t u32Interval)
+{
+    if ((pstcHeartbeat == NULL) || ((u8RamAddress & 0x3F) > (0x40 - AMX8X5_HEARTBEAT_SIZE)))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcHeartbeat,0,sizeof(stc_amx8x5_heartbeat_t));
+    pstcHeartbeat->u8RamAddress = u8RamAddress;
+    pstcHeartbeat->u32Interval = u32Interval;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Report the previous run from the heartbeat and start a new one
+ **
+ ** Call once at boot. Compares the heartbeat record of the previous run with
+ ** the RTC time, then writes a new record with the current time as boot and
+ ** last alive time.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcHeartbeat  Heartbeat, initialized by Amx8x5_HeartbeatInit()
+ **
+ ** \param  pstcInfo       Returns the previous run, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_LastShutdownInfo(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_heartbeat_t* pstcHeartbeat, stc_amx8x5_shutdown_info_t* pstcInfo)
+{
+    uint8_t au8Record[AMX8X5_HEARTBEAT_SIZE];
+    uint32_t u32Boot = 0;
+    uint32_t u32Last = 0;
+    uint32_t u32Now;
+    uint8_t i;
+    bool bValid;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_LastShutdownInfo");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcHeartbeat == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetExtensionAddress(pstcHandle,pstcHeartbeat->u8RamAddress,&pstcHeartbeat->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcHeartbeat->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ReadBytes(pstcHandle,(pstcHeartbeat->u8RamAddress & 0x3F) | 0x40,au8Record,AMX8X5_HEARTBEAT_SIZE);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_GetSeconds(pstcHandle,&u32Now);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    bValid = (au8Record[AMX8X5_HEARTBEAT_SIZE - 1] == Amx8x5_RecordCheck(au8Record,AMX8X5_HEARTBEAT_SIZE - 1));
+    if (bValid)
+    {
+        for(i = 0; i < 4; i++)
+        {
+            u32Boot |= (uint32_t)au8Record[i] << (8 * i);
+            u32Last |= (uint32_t)au8Record[4 + i] << (8 * i);
+        }
+        //
+        // A heartbeat ahead of the RTC (time set backwards) or before its
+        // boot time is not usable.
+        //
+        bValid = (u32Last >= u32Boot) && (u32Now >= u32Last);
+    }
+    if (pstcInfo != NULL)
+    {
+        memset(pstcInfo,0,sizeof(stc_amx8x5_shutdown_info_t));
+        if (bValid)
+        {
+            pstcInfo->u32Boot = u32Boot;
+            pstcInfo->u32LastAlive = u32Last;
+            pstcInfo->u32Uptime = u32Last - u32Boot;
+            pstcInfo->u32Downtime = u32Now - u32Last;
+            pstcInfo->bValid = true;
+        }
+    }
+
+    pstcHeartbeat->u32Boot = u32Now;
+    pstcHeartbeat->u32Last = u32Now;
+    res = Amx8x5_HeartbeatWrite(pstcHandle,pstcHeartbeat,0);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcHeartbeat->bReady = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Update the last alive time once per interval
+ **
+ ** Can be called as often as convenient, e.g. every loop with a time read
+ ** anyway. Without bus access until u32Interval seconds passed since the last
+ ** write, then the bank select and one burst of 5 bytes (last alive time and
+ ** check byte).
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcHeartbeat  Heartbeat, started by Amx8x5_LastShutdownInfo()
+ **
+ ** \param  u32Now         Current RTC time in seconds, e.g. Amx8x5_GetSeconds()
+ **
+ ** \param  pbWritten      Returns true if the heartbeat was written, can be NULL
+ **
+ ** \return Ok on success, ErrorNotReady before Amx8x5_LastShutdownInfo(),
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_HeartbeatService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_heartbeat_t* pstcHeartbeat, uint32_t u32Now, bool* pbWritten)
+{
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_HeartbeatService");
+
+    if (pbWritten != NULL) *pbWritten = false;
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcHeartbeat == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (!pstcHeartbeat->bReady)
+    {
+        return AMX8X5_FUNC_END(ErrorNotReady);
+    }
+    if ((u32Now - pstcHeartbeat->u32Last) < pstcHeartbeat->u32Interval)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    pstcHeartbeat->u32Last = u32Now;
+    res = Amx8x5_HeartbeatWrite(pstcHandle,pstcHeartbeat,4);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    if (pbWritten != NULL) *pbWritten = true;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Configure and start the watchdog, cache the WDT value for kicks
+ **
+ ** Runs Amx8x5_SetWatchdog() once (WDT flag cleared, pin routed) and keeps
+ ** the WDT register value, so Amx8x5_WatchdogKick() is a single byte write.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcWatchdog   Prepared watchdog, see #stc_amx8x5_watchdog_t
+ **
+ ** \param  u32Period      timeout period in ms (63 to 124,000)
+ **
+ ** \param  enPin          pin to generate the watchdog signal, not AMx8x5WatchdogInterruptPinDisable
+ **
+ ** \return Ok on success, ErrorInvalidParameter if the period or pin disables the watchdog,
+ **         else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_WatchdogPrepare(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_watchdog_t* pstcWatchdog, uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin)
+{
+    uint8_t u8Wdt;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_WatchdogPrepare");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    u8Wdt = Amx8x5_WatchdogEncode(u32Period,enPin);
+    if ((pstcWatchdog == NULL) || ((u8Wdt & AMX8X5_REG_WDT_BMB_MSK) == 0))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_SetWatchdog(pstcHandle,u32Period,enPin);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcWatchdog->u8Wdt = u8Wdt;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Restart a prepared watchdog
+ **
+ ** Writing WDT restarts the watchdog timer: one single byte write, no read.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcWatchdog   Watchdog prepared by Amx8x5_WatchdogPrepare()
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_WatchdogKick(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_watchdog_t* pstcWatchdog)
+{
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_WatchdogKick");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcWatchdog == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    return AMX8X5_FUNC_END(Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_WDT,pstcWatchdog->u8Wdt));
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Initialize a task watchdog without tasks
+ **
+ ** \param  pstcTaskWdt    Task watchdog, see #stc_amx8x5_taskwdt_t
+ **
+ ** \param  u8RamAddress   RTC RAM address of the 2 byte starved task record, e.g. #AMX8X5_RAM_TASKWDT,
+ **                        must not be the last byte of a 64 byte bank
+ **
+ ** \param  pfnClock       Time base of deadlines and kick interval (e.g. millis)
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtInit(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8RamAddress, pfn_amx8x5_micros pfnClock)
+{
+    if ((pstcTaskWdt == NULL) || (pfnClock == NULL) || ((u8RamAddress & 0x3F) == 0x3F))
+    {
+        return ErrorInvalidParameter;
+    }
+    memset(pstcTaskWdt,0,sizeof(stc_amx8x5_taskwdt_t));
+    pstcTaskWdt->pfnClock = pfnClock;
+    pstcTaskWdt->u8RamAddress = u8RamAddress;
+    pstcTaskWdt->u8Culprit = AMX8X5_TASKWDT_NONE;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Register a supervised task
+ **
+ ** \param  pstcTaskWdt    Task watchdog, initialized by Amx8x5_TaskWdtInit()
+ **
+ ** \param  u8Task         Task ID (0 .. #AMX8X5_TASKWDT_MAX - 1)
+ **
+ ** \param  u32Deadline    Max. time between two check-ins in pfnClock units, 0 = unregister
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtRegister(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8Task, uint32_t u32Deadline)
+{
+    if ((pstcTaskWdt == NULL) || (u8Task >= AMX8X5_TASKWDT_MAX))
+    {
+        return ErrorInvalidParameter;
+    }
+    pstcTaskWdt->au32Deadline[u8Task] = u32Deadline;
+    pstcTaskWdt->au32Last[u8Task] = pstcTaskWdt->pfnClock();
+    pstcTaskWdt->au8CheckIn[u8Task] = 0;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Start the RTC watchdog for the registered tasks (AM18x5)
+ **
+ ** Prepares the RTC watchdog to reset via nRST, see Amx8x5_WatchdogPrepare(),
+ ** and restarts the deadlines of all tasks.
+ **
+ ** \param  pstcHandle       RTC Handle
+ **
+ ** \param  pstcTaskWdt      Task watchdog with the tasks registered
+ **
+ ** \param  u32Period        RTC watchdog timeout in ms (63 to 124,000)
+ **
+ ** \param  u32KickInterval  Min. time between kicks in pfnClock units, well below u32Period
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_taskwdt_t* pstcTaskWdt, uint32_t u32Period, uint32_t u32KickInterval)
+{
+    uint32_t u32Now;
+    uint8_t i;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TaskWdtStart");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcTaskWdt == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetExtensionAddress(pstcHandle,pstcTaskWdt->u8RamAddress,&pstcTaskWdt->u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WatchdogPrepare(pstcHandle,&pstcTaskWdt->stcWatchdog,u32Period,AMx8x5WatchdogInterruptPinnRST);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+
+    u32Now = pstcTaskWdt->pfnClock();
+    for(i = 0; i < AMX8X5_TASKWDT_MAX; i++)
+    {
+        pstcTaskWdt->au32Last[i] = u32Now;
+        pstcTaskWdt->au8CheckIn[i] = 0;
+    }
+    pstcTaskWdt->u32KickInterval = u32KickInterval;
+    pstcTaskWdt->u32LastKick = u32Now;
+    pstcTaskWdt->u8Culprit = AMX8X5_TASKWDT_NONE;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Check in a task
+ **
+ ** A single byte store without bus access, can be called from any task or
+ ** ISR without locking.
+ **
+ ** \param  pstcTaskWdt    Task watchdog
+ **
+ ** \param  u8Task         Task ID
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtCheckIn(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8Task)
+{
+    if ((pstcTaskWdt == NULL) || (u8Task >= AMX8X5_TASKWDT_MAX))
+    {
+        return ErrorInvalidParameter;
+    }
+    pstcTaskWdt->au8CheckIn[u8Task] = 1;
+    return Ok;
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Collect the check-ins and kick the RTC watchdog if all tasks are alive
+ **
+ ** Call periodically from the supervising context. The RTC watchdog is
+ ** kicked with a single byte write at most once per u32KickInterval, and
+ ** only while every registered task checked in within its deadline. The
+ ** first starved task is written to RTC RAM (bank select and one 2 byte
+ ** burst), afterwards the watchdog is no longer kicked and resets the
+ ** system via nRST.
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  pstcTaskWdt    Task watchdog, started by Amx8x5_TaskWdtStart()
+ **
+ ** \param  pu8Culprit     Returns the starved task, #AMX8X5_TASKWDT_NONE if none, can be NULL
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t* pu8Culprit)
+{
+    uint8_t au8Record[2];
+    uint32_t u32Now;
+    uint8_t i;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TaskWdtService");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if (pstcTaskWdt == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+    if (pu8Culprit != NULL) *pu8Culprit = pstcTaskWdt->u8Culprit;
+    if (pstcTaskWdt->u8Culprit != AMX8X5_TASKWDT_NONE)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+
+    u32Now = pstcTaskWdt->pfnClock();
+    for(i = 0; i < AMX8X5_TASKWDT_MAX; i++)
+    {
+        if (pstcTaskWdt->au32Deadline[i] == 0)
+        {
+            continue;
+        }
+        if (pstcTaskWdt->au8CheckIn[i])
+        {
+            pstcTaskWdt->au8CheckIn[i] = 0;
+            pstcTaskWdt->au32Last[i] = u32Now;
+        }
+        else if ((u32Now - pstcTaskWdt->au32Last[i]) > pstcTaskWdt->au32Deadline[i])
+        {
+            //
+            // Record the culprit, the RTC resets the system at its timeout.
+            //
+            pstcTaskWdt->u8Culprit = i;
+            if (pu8Culprit != NULL) *pu8Culprit = i;
+            au8Record[0] = i;
+            au8Record[1] = (uint8_t)~i;
+            res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,pstcTaskWdt->u8Xadd);
+            if (res != Ok)
+            {
+                return AMX8X5_FUNC_END(res);
+            }
+            return AMX8X5_FUNC_END(Amx8x5_WriteBytes(pstcHandle,(pstcTaskWdt->u8RamAddress & 0x3F) | 0x40,au8Record,2));
+        }
+    }
+
+    if ((u32Now - pstcTaskWdt->u32LastKick) < pstcTaskWdt->u32KickInterval)
+    {
+        return AMX8X5_FUNC_END(Ok);
+    }
+    res = Amx8x5_WatchdogKick(pstcHandle,&pstcTaskWdt->stcWatchdog);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    pstcTaskWdt->u32LastKick = u32Now;
+    return AMX8X5_FUNC_END(Ok);
+}
+
+/**
+ ******************************************************************************
+ ** \brief  Read and clear the starved task recorded before the last reset
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u8RamAddress   RTC RAM address of the record, as passed to Amx8x5_TaskWdtInit()
+ **
+ ** \param  pu8Task        Returns the starved task, #AMX8X5_TASKWDT_NONE if none
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+en_result_t Amx8x5_TaskWdtCulprit(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, uint8_t* pu8Task)
+{
+    uint8_t au8Record[2];
+    uint8_t u8Xadd;
+    en_result_t res;
+
+    AMX8X5_DEBUG_FUNC_START("Amx8x5_TaskWdtCulprit");
+
+    if (pstcHandle == NULL)
+    {
+        return AMX8X5_FUNC_END(ErrorUninitialized);
+    }
+    if ((pu8Task == NULL) || ((u8RamAddress & 0x3F) == 0x3F))
+    {
+        return AMX8X5_FUNC_END(ErrorInvalidParameter);
+    }
+
+    res = Amx8x5_GetExtensionAddress(pstcHandle,u8RamAddress,&u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_WriteByte(pstcHandle,AMX8X5_REG_EXTENDED_ADDR,u8Xadd);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    res = Amx8x5_ReadBytes(pstcHandle,(u8RamAddress & 0x3F) | 0x40,au8Record,2);
+    if (res != Ok)
+    {
+        return AMX8X5_FUNC_END(res);
+    }
+    *pu8Task = AMX8X5_TASKWDT_NONE;
+    if ((au8Record[0] < AMX8X5_TASKWDT_MAX) && ((uint8_t)(au8Record[0] ^ au8Record[1]) == 0xFF))
+    {
+        *pu8Task = au8Record[0];
+        au8Record[0] = AMX8X5_TASKWDT_NONE;
+        au8Record[1] = AMX8X5_TASKWDT_NONE;
+        res = Amx8x5_WriteBytes(pstcHandle,(u8RamAddress & 0x3F) | 0x40,au8Record,2);
+    }
+    return AMX8X5_FUNC_END(res);
+}
+
+#ifdef __cplusplus
+    #if defined(ARDUINO)
+    #include <Arduino.h>
+
+    // -----------------------------------------------------------------------
+    // Platform capability detection
+    //
+    // AMX8X5_WIRE_AVAILABLE: Wire (I2C) is present on this platform.
+    //   Explicitly known platforms always have Wire. For unknown platforms
+    //   fall back to WIRE_INTERFACES_COUNT: include Wire when > 0 or when
+    //   the macro is not defined at all (conservative: assume available).
+    //
+    // AMX8X5_SPI_AVAILABLE: SPI is present on this platform.
+    //   Same logic as Wire. Additionally, if the user already included
+    //   <SPI.h> before this library, SPI is always considered available.
+    //
+    // Platforms with Wire and SPI always available:
+    //   AVR (Uno, Mega, Leonardo …), megaAVR (Nano Every),
+    //   ESP8266, ESP32 (all variants),
+    //   STM32 (Arduino_Core_STM32),
+    //   nRF52 (Adafruit / Arduino),
+    //   RP2040 (Arduino-Pico / Mbed),
+    //   SAMD (Zero, MKR …) — signalled by WIRE/SPI_INTERFACES_COUNT > 0
+    // -----------------------------------------------------------------------
+    #if defined(ARDUINO_ARCH_AVR)     || defined(ARDUINO_ARCH_MEGAAVR)  || \
+        defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)    || \
+        defined(ARDUINO_ARCH_STM32)   || defined(ARDUINO_ARCH_NRF52)    || \
+        defined(ARDUINO_ARCH_RP2040)  || defined(ARDUINO_ARCH_MBED_RP2040) || \
+        !defined(WIRE_INTERFACES_COUNT) || (WIRE_INTERFACES_COUNT > 0)
+      #define AMX8X5_WIRE_AVAILABLE 1
+    #endif
+
+    #if defined(ARDUINO_ARCH_AVR)     || defined(ARDUINO_ARCH_MEGAAVR)  || \
+        defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)    || \
+        defined(ARDUINO_ARCH_STM32)   || defined(ARDUINO_ARCH_NRF52)    || \
+        defined(ARDUINO_ARCH_RP2040)  || defined(ARDUINO_ARCH_MBED_RP2040) || \
+        (defined(SPI_INTERFACES_COUNT) && (SPI_INTERFACES_COUNT > 0))   || \
+        defined(SPI_H) || defined(_SPI_H_INCLUDED) || defined(SPI_H_)
+      #define AMX8X5_SPI_AVAILABLE 1
+    #endif
+    // -----------------------------------------------------------------------
+
+    #if defined(AMX8X5_WIRE_AVAILABLE)
+    #include <Wire.h>
+    static int i2cWrite(void* pHandle, uint32_t u32Address, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    {
+        for(int i = 0; i < u32Len;i++)
+        {
+            Wire.beginTransmission(u32Address);  	// Initialize the Tx buffer
+            Wire.write(u8Register+i);    		// Put slave register address in Tx buffer
+            Wire.write(*pu8Data);					// Put data in Tx buffer
+            pu8Data++;
+            Wire.endTransmission();				// Send the Tx buffer
+        }
+        
+        return Ok;
+    }
+
+    static int i2cRead(void* pHandle, uint32_t u32Address, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    {
+        for(int i = 0; i < u32Len;i++)
+        {
+            Wire.beginTransmission(u32Address);  	// Initialize the Tx buffer
+            Wire.write(u8Register+i);    		// Put slave register address in Tx buffer
+            Wire.endTransmission();				// Send the Tx buffer
+            Wire.requestFrom(u32Address,1);
+            *pu8Data = Wire.read();					// Get data in Rx buffer
+            pu8Data++;
+        }
+       
+        return Ok;
+    }
+    #endif // AMX8X5_WIRE_AVAILABLE
+
+    #if defined(AMX8X5_SPI_AVAILABLE)
+    #if !defined(SPI_H) && !defined(_SPI_H_INCLUDED) && !defined(SPI_H_)
+    #include <SPI.h>
+    #endif
+    static SPISettings spiSettings(2000000, MSBFIRST, SPI_MODE0);
+
+    static int spiWrite(void* pHandle, uint32_t u32ChipSelect, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    {
+        // AM08X5 SPI write: register byte with MSB=0 (write), then data bytes
+        SPI.beginTransaction(spiSettings);
+        digitalWrite((uint8_t)u32ChipSelect, LOW);
+        SPI.transfer(u8Register & 0x7F);
+        for (uint32_t i = 0; i < u32Len; i++)
+        {
+            SPI.transfer(pu8Data[i]);
+        }
+        digitalWrite((uint8_t)u32ChipSelect, HIGH);
+        SPI.endTransaction();
+        return Ok;
+    }
+
+    static int spiRead(void* pHandle, uint32_t u32ChipSelect, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+    {
+        // AM08X5 SPI read: register byte with MSB=1 (read), then receive data bytes
+        SPI.beginTransaction(spiSettings);
+        digitalWrite((uint8_t)u32ChipSelect, LOW);
+        SPI.transfer(u8Register | 0x80);
+        for (uint32_t i = 0; i < u32Len; i++)
+        {
+            pu8Data[i] = SPI.transfer(0x00);
+        }
+        digitalWrite((uint8_t)u32ChipSelect, HIGH);
+        SPI.endTransaction();
+        return Ok;
+    }
+    #endif // AMX8X5_SPI_AVAILABLE
+    #endif // ARDUINO
+
+    bool AMx8x5::begin(void)
+    {
+        #if defined(ARDUINO) && defined(AMX8X5_WIRE_AVAILABLE)
+        stcRtcConfig.pfnReadI2C = i2cRead;
+        stcRtcConfig.pfnWriteI2C = i2cWrite;
+        #endif
+        if (Amx8x5_Init(&stcRtcConfig) == Ok)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Initialise the RTC using the Arduino Wire library and detect a warm boot.
+     *
+     * Same as begin(), but the ID check is combined with the configuration
+     * fingerprint check of Amx8x5_CheckWarmBoot(). If @p pbWarmBoot returns
+     * true the RTC kept the configuration of the last saveConfigFingerprint()
+     * call and the application setup can be skipped.
+     *
+     * @param pbWarmBoot    returns true on a warm boot.
+     * @param u8RamAddress  RTC RAM address of the 2 byte fingerprint.
+     * @return true on success (ID registers verified), false otherwise.
+     */
+    bool AMx8x5::begin(bool* pbWarmBoot, uint8_t u8RamAddress)
+    {
+        #if defined(ARDUINO) && defined(AMX8X5_WIRE_AVAILABLE)
+        stcRtcConfig.pfnReadI2C = i2cRead;
+        stcRtcConfig.pfnWriteI2C = i2cWrite;
+        #endif
+        if (Amx8x5_CheckWarmBoot(&stcRtcConfig,u8RamAddress,pbWarmBoot) == Ok)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Initialise the RTC using the Arduino SPI library.
+     *
+     * Sets up the built-in SPI callbacks (2 MHz, SPI_MODE0) and configures
+     * the given pin as chip-select output.  Use this instead of begin() when
+     * the device type is a SPI variant (AM0815 / AM1815).
+     *
+     * Only available when <SPI.h> has been included before this library.
+     * On boards without SPI hardware simply omit <SPI.h> and this overload
+     * will not be compiled.
+     *
+     * @param u8CsPin  Arduino pin number connected to the RTC nCE/CS line.
+     * @return true on success (ID registers verified), false otherwise.
+     */
+    bool AMx8x5::begin(uint8_t u8CsPin)
+    {
+        #if defined(ARDUINO) && defined(AMX8X5_SPI_AVAILABLE)
+        pinMode(u8CsPin, OUTPUT);
+        digitalWrite(u8CsPin, HIGH);
+        SPI.begin();
+        stcRtcConfig.enMode        = AMx8x5ModeSPI;
+        stcRtcConfig.u32ChipSelect = (uint32_t)u8CsPin;
+        stcRtcConfig.pfnReadSpi    = spiRead;
+        stcRtcConfig.pfnWriteSpi   = spiWrite;
+        #endif
+        if (Amx8x5_Init(&stcRtcConfig) == Ok)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    en_result_t AMx8x5::init(AMx8x5::stcHandle* pstcHandle)
+    {
+        memcpy(&stcRtcConfig,pstcHandle,sizeof(stcRtcConfig));
+        return Ok;
+    }
+
+    /**
+     * @brief Reset the driver state kept in the object (called by the constructors).
+     */
+    void AMx8x5::initState(void)
+    {
+        Amx8x5_IrqDispatcherInit(&stcIrqDispatcher);
+        bIrqPending = false;
+        u8DeferredCount = 0;
+    }
+
+    AMx8x5::enResult AMx8x5::update(void)
+    {
+        AMx8x5::pfnServiceWork apfnWork[AMX8X5_DEFERRED_WORK_MAX];
+        uint8_t u8Count;
+        uint8_t i;
+        en_result_t res = Ok;
+
+        //
+        // Nothing to do: no bus access.
+        //
+        if ((bIrqPending == false) && (u8DeferredCount == 0))
+        {
+            return Ok;
+        }
+
+        //
+        // Clear the request before servicing, an interrupt raised
+        // meanwhile is handled by the next call. A failed dispatch keeps
+        // it pending, a pulse on the pin is not repeated.
+        //
+        if (bIrqPending)
+        {
+            bIrqPending = false;
+            res = Amx8x5_IrqDispatch(&stcRtcConfig,&stcIrqDispatcher,NULL);
+            if (res != Ok)
+            {
+                bIrqPending = true;
+            }
+        }
+
+        //
+        // Work items may defer themselves again.
+        //
+        u8Count = u8DeferredCount;
+        memcpy(apfnWork,apfnDeferred,u8Count * sizeof(AMx8x5::pfnServiceWork));
+        u8DeferredCount = 0;
+        for(i = 0; i < u8Count; i++)
+        {
+            apfnWork[i](this);
+        }
+        return res;
+    }
+
+    void AMx8x5::notifyInterrupt(void)
+    {
+        bIrqPending = true;
+    }
+
+    bool AMx8x5::defer(AMx8x5::pfnServiceWork pfnWork)
+    {
+        uint8_t i;
+        if (pfnWork == NULL)
+        {
+            return false;
+        }
+        for(i = 0; i < u8DeferredCount; i++)
+        {
+            if (apfnDeferred[i] == pfnWork)
+            {
+                //
+                // Already pending, run once.
+                //
+                return true;
+            }
+        }
+        if (u8DeferredCount >= AMX8X5_DEFERRED_WORK_MAX)
+        {
+            return false;
+        }
+        apfnDeferred[u8DeferredCount++] = pfnWork;
+        return true;
+    }
+
+    bool AMx8x5::end(void)
+    {
+        return true;
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  This function is reset the RTC
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     ** 
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::reset(void){
+        return Amx8x5_Reset(&stcRtcConfig);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  This function is getting the time of the RTC
+     **
+     ** \param  ppstcTime      returns the pointer of the time structure stc_amx8x5_time_t in a pointer of the pointer
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
      ** Example:
      ** @code
      ** AMx8x5::stcTime* pstcTime;
@@ -4200,6 +9796,34 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_GetTime(&stcRtcConfig,ppstcTime);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Get the time of the RTC together with the matching host time
+     **
+     ** see Amx8x5_GetTimePrecise()
+     **
+     ** \param  pstcPreciseTime  Returns time, host time and uncertainty
+     **
+     ** \param  pfnMicros        Host clock in us, e.g. micros()
+     **
+     ** \param  bWaitEdge        true to wait for the next hundredth edge
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ** Example:
+     ** @code
+     ** AMx8x5::stcTimePrecise stcNow;
+     **
+     ** rtc.getTimePrecise(&stcNow,micros,true);
+     ** // the RTC showed stcNow.stcTime at micros() == stcNow.u32HostUs
+     ** @endcode
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::getTimePrecise(AMx8x5::stcTimePrecise* pstcPreciseTime, AMx8x5::pfnMicros pfnMicros, bool bWaitEdge)
+    {
+        return Amx8x5_GetTimePrecise(&stcRtcConfig,pstcPreciseTime,pfnMicros,bWaitEdge);
+    }
+
     /**
      ** @brief Get Time - Hundredth
      ** 
@@ -4324,6 +9948,22 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_SetCalibrationValue(&stcRtcConfig,enMode,iAdjust);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Read the calibration currently set, see Amx8x5_GetCalibrationValue()
+     **
+     ** \param  enMode         AMx8x5ModeCalibrateXT or AMx8x5ModeCalibrateRC
+     **
+     ** \param  pi32Ppb        Returns the adjustment in ppb
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::getCalibrationValue(AMx8x5::enCalibrationMode enMode, int32_t* pi32Ppb)
+    {
+        return Amx8x5_GetCalibrationValue(&stcRtcConfig,enMode,pi32Ppb);
+    }
+
     /**
      ******************************************************************************
      ** \brief  Set the alarm value
@@ -4366,6 +10006,29 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_SetAlarm(&stcRtcConfig,pstcTime,enModeRepeat,enModeIrq,enModePin);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Set the alarm, writing only the alarm time if nothing else changed,
+     **         see Amx8x5_AlarmRearm()
+     **
+     ** \param  pstcConfig     Configuration of the last full call
+     **
+     ** \param  pstcTime       Time
+     **
+     ** \param  enModeRepeat   Repeat mode as defined in #en_amx8x5_alarm_repeat_t
+     **
+     ** \param  enModeIrq      Interrupt mode as defined in #en_amx8x5_interrupt_mode_t
+     **
+     ** \param  enModePin      Interrupt pin as defined in #en_amx8x5_interrupt_pin_t
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::alarmRearm(AMx8x5::stcAlarmConfig* pstcConfig, AMx8x5::stcTime* pstcTime, AMx8x5::enAlarmRepeat enModeRepeat, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin)
+    {
+        return Amx8x5_AlarmRearm(&stcRtcConfig,pstcConfig,pstcTime,enModeRepeat,enModeIrq,enModePin);
+    }
+
     /**
      ******************************************************************************
      ** \brief  This function is stopping / releasing stop of the RTC
@@ -4385,9 +10048,157 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
      ** @endcode
      **
      ******************************************************************************/
-    AMx8x5::enResult  AMx8x5::stop(bool bStop)
+    AMx8x5::enResult  AMx8x5::stop(bool bStop)
+    {
+        return Amx8x5_Stop(&stcRtcConfig,bStop);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Set the time of the RTC aligned to a reference second edge
+     **
+     ** see Amx8x5_SetTimePrecise()
+     **
+     ** \param  pstcTime       Time valid at the reference edge
+     **
+     ** \param  bProtect       false to leave counters writable, true to leave counters unwritable
+     **
+     ** \param  pfnWaitEdge    Blocks until the reference edge
+     **
+     ** \param  pfnMicros      Host clock in us, may be NULL
+     **
+     ** \param  pu32LatencyUs  Returns the measured single byte transfer time, may be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::setTimePrecise(AMx8x5::stcTime* pstcTime, bool bProtect, AMx8x5::pfnWaitEdge pfnWaitEdge, AMx8x5::pfnMicros pfnMicros, uint32_t* pu32LatencyUs)
+    {
+        return Amx8x5_SetTimePrecise(&stcRtcConfig,pstcTime,bProtect,pfnWaitEdge,pfnMicros,pu32LatencyUs);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Read the RTC time as seconds since 2000-01-01 00:00:00
+     **
+     ** \param  pu32Seconds    returns the seconds
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::getSeconds(uint32_t* pu32Seconds)
+    {
+        return Amx8x5_GetSeconds(&stcRtcConfig,pu32Seconds);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Start (or restart) a software alarm, see Amx8x5_SwAlarmStart()
+     **
+     ** \param  pstcSwAlarm    Software alarms, initialized by Amx8x5_SwAlarmInit()
+     **
+     ** \param  u8Id           Application defined ID
+     **
+     ** \param  u32Deadline    Deadline in seconds since 2000
+     **
+     ** \param  pfnCallback    Called by swAlarmService() when the deadline is reached
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::swAlarmStart(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t u8Id, uint32_t u32Deadline, AMx8x5::pfnSwAlarmCallback pfnCallback)
+    {
+        return Amx8x5_SwAlarmStart(&stcRtcConfig,pstcSwAlarm,u8Id,u32Deadline,pfnCallback);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Stop a software alarm, see Amx8x5_SwAlarmStop()
+     **
+     ** \param  pstcSwAlarm    Software alarms
+     **
+     ** \param  u8Id           ID used with swAlarmStart()
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::swAlarmStop(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t u8Id)
+    {
+        return Amx8x5_SwAlarmStop(&stcRtcConfig,pstcSwAlarm,u8Id);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Fire expired software alarms and rearm, see Amx8x5_SwAlarmService()
+     **
+     ** \param  pstcSwAlarm    Software alarms
+     **
+     ** \param  pu8Fired       returns the number of fired alarms, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::swAlarmService(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t* pu8Fired)
+    {
+        return Amx8x5_SwAlarmService(&stcRtcConfig,pstcSwAlarm,pu8Fired);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Arm the hardware alarm for a schedule, see Amx8x5_ScheduleArm()
+     **
+     ** \param  pstcSchedule     Schedule
+     **
+     ** \param  enModeIrq        Interrupt mode of the hardware alarm
+     **
+     ** \param  enModePin        Interrupt pin of the hardware alarm
+     **
+     ** \param  pu32Next         returns the next fire time in seconds since 2000, can be NULL
+     **
+     ** \param  pbHardwareRepeat returns true if the RTC repeats the alarm itself, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::scheduleArm(AMx8x5::stcSchedule* pstcSchedule, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin, uint32_t* pu32Next, bool* pbHardwareRepeat)
+    {
+        return Amx8x5_ScheduleArm(&stcRtcConfig,pstcSchedule,enModeIrq,enModePin,pu32Next,pbHardwareRepeat);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Start a periodic alarm in hundredths, see Amx8x5_SubSecondAlarmStart()
+     **
+     ** \param  pstcAlarm      Alarm
+     **
+     ** \param  u16Period      Period in hundredths of a second (1..3000 or 6000)
+     **
+     ** \param  enModeIrq      Interrupt mode of the hardware alarm
+     **
+     ** \param  enModePin      Interrupt pin of the hardware alarm
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::subSecondAlarmStart(AMx8x5::stcSubSecondAlarm* pstcAlarm, uint16_t u16Period, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin)
+    {
+        return Amx8x5_SubSecondAlarmStart(&stcRtcConfig,pstcAlarm,u16Period,enModeIrq,enModePin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Move a sub-second alarm on after its interrupt, see Amx8x5_SubSecondAlarmService()
+     **
+     ** \param  pstcAlarm      Alarm
+     **
+     ** \param  pbRearmed      returns true if the alarm registers were written, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::subSecondAlarmService(AMx8x5::stcSubSecondAlarm* pstcAlarm, bool* pbRearmed)
     {
-        return Amx8x5_Stop(&stcRtcConfig,bStop);
+        return Amx8x5_SubSecondAlarmService(&stcRtcConfig,pstcAlarm,pbRearmed);
     }
 
     /**
@@ -4722,106 +10533,385 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
 
     AMx8x5::enResult  AMx8x5::setBatmodeIO(bool bIoEnabled)
     {
-        return Amx8x5_SetBatmodeIO(&stcRtcConfig,bIoEnabled);
+        return Amx8x5_SetBatmodeIO(&stcRtcConfig,bIoEnabled);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  This function is controlling the behavior of the I/O pins under 
+     **         various power down conditions.
+     **
+     ** see also #AMX8X5_REG_OCTRL definition
+     **
+     ** \param  u8OutputMask   Mask of outputs to enable / disable as defined in #AMX8X5_REG_OCTRL
+     **
+     ** \param  bEnable        1 for enable, 0 for disable
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     ** 
+     ** Example:
+     ** @code
+     ** Amx8x5_EnableOutput(&stcRtcConfig,AMX8X5_REG_OCTRL_O1EN_MSK,true);  //set FOUT/nIRQ as output
+     **
+     ** Amx8x5_EnableOutput(&stcRtcConfig,AMX8X5_REG_OCTRL_O1EN_MSK,false); //dont use FOUT/nIRQ as output
+     ** @endcode
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::enableTrickleCharger(AMx8x5::enTrickleDiode enDiode, AMx8x5::enTrickleResistor enResistor, bool bEnabled)
+    {
+        return Amx8x5_EnableTrickleCharger(&stcRtcConfig,enDiode,enResistor,bEnabled);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  This function controls the Trickle Charger
+     **
+     ** see also #AMX8X5_REG_TRICKLE definition
+     **
+     ** \param  pstcHandle     RTC Handle
+     **
+     ** \param  enDiode        Diode Select.
+     **                        AMx8x5TrickleDiodeDisabled => disable the Trickle Charger.
+     **                        AMx8x5TrickleDiodeSchottky => inserts a schottky diode into the trickle charge circuit, with a voltage drop of 0.3V
+     **                        AMx8x5TrickleDiodeNormal => inserts a standard diode into the trickle charge circuit, with a voltage drop of 0.6V
+     ** 
+     ** \param  enResistor     Output Resistor.
+     **
+     ** \param  bEnable        true for enable, false for disable
+     **                        AMx8x5TrickleResistorDisabled = 0> disable the Trickle Charger.
+     **                        AMx8x5TrickleResistor3K => this selects 3K Ohm as the output resistor of the trickle charge circuit
+     **                        AMx8x5TrickleResistor6K => this selects 6K Ohm as the output resistor of the trickle charge circuit
+     **                        AMx8x5TrickleResistor11K => this selects 11K Ohm as the output resistor of the trickle charge circuit
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     ** 
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::setBatteryReferenceVoltage(AMx8x5::enBatReference enBref)
+    {
+        return Amx8x5_SetBatteryReferenceVoltage(&stcRtcConfig,enBref);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Estimate the battery voltage with the BREF comparator (AM18x5)
+     **
+     ** \param  pu8Level       Returns the BREF thresholds VBAT is above (0..4)
+     **
+     ** \param  pu16MinMv      Returns the lower bound in mV, can be NULL
+     **
+     ** \param  pu16MaxMv      Returns the upper bound in mV, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::batteryEstimate(uint8_t* pu8Level, uint16_t* pu16MinMv, uint16_t* pu16MaxMv)
+    {
+        return Amx8x5_BatteryEstimate(&stcRtcConfig,pu8Level,pu16MinMv,pu16MaxMv);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Run the battery estimation when its period elapsed
+     **
+     ** \param  pstcBattery    Estimation initialized by Amx8x5_BatteryInit()
+     **
+     ** \param  u32Now         Current time in seconds
+     **
+     ** \param  pbChanged      Returns true if the reported level changed, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::batteryService(AMx8x5::stcBattery* pstcBattery, uint32_t u32Now, bool* pbChanged)
+    {
+        return Amx8x5_BatteryService(&stcRtcConfig,pstcBattery,u32Now,pbChanged);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Select the trickle charger setting for the battery level (AM18x5)
+     **
+     ** \param  pstcPolicy     Policy initialized by Amx8x5_TrickleInit()
+     **
+     ** \param  u8Level        Battery level, e.g. stcBattery::u8Level
+     **
+     ** \param  u32Now         Current time in seconds
+     **
+     ** \param  pbWritten      Returns true if TRICKLE was written, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::trickleService(AMx8x5::stcTricklePolicy* pstcPolicy, uint8_t u8Level, uint32_t u32Now, bool* pbWritten)
+    {
+        return Amx8x5_TrickleService(&stcRtcConfig,pstcPolicy,u8Level,u32Now,pbWritten);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Load the power-fail record and close an open outage
+     **
+     ** \param  pstcPowerFail  Recorder initialized by Amx8x5_PowerFailInit()
+     **
+     ** \param  pstcOutage     Returns the last outage, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::powerFailRecover(AMx8x5::stcPowerFail* pstcPowerFail, AMx8x5::stcOutage* pstcOutage)
+    {
+        return Amx8x5_PowerFailRecover(&stcRtcConfig,pstcPowerFail,pstcOutage);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Arm the battery low interrupt for power-fail recording (AM18x5)
+     **
+     ** \param  pstcPowerFail  Recorder loaded by powerFailRecover()
+     **
+     ** \param  enBref         Threshold of the interrupt
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::powerFailArm(AMx8x5::stcPowerFail* pstcPowerFail, AMx8x5::enBatReference enBref)
+    {
+        return Amx8x5_PowerFailArm(&stcRtcConfig,pstcPowerFail,enBref);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Record the start of an outage, called from the battery low interrupt
+     **
+     ** \param  pstcPowerFail  Recorder loaded by powerFailRecover()
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::powerFailRecord(AMx8x5::stcPowerFail* pstcPowerFail)
+    {
+        return Amx8x5_PowerFailRecord(&stcRtcConfig,pstcPowerFail);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Report the previous run from the heartbeat and start a new one
+     **
+     ** \param  pstcHeartbeat  Heartbeat initialized by Amx8x5_HeartbeatInit()
+     **
+     ** \param  pstcInfo       Returns the previous run, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::lastShutdownInfo(AMx8x5::stcHeartbeat* pstcHeartbeat, AMx8x5::stcShutdownInfo* pstcInfo)
+    {
+        return Amx8x5_LastShutdownInfo(&stcRtcConfig,pstcHeartbeat,pstcInfo);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Update the last alive time once per interval
+     **
+     ** \param  pstcHeartbeat  Heartbeat started by lastShutdownInfo()
+     **
+     ** \param  u32Now         Current RTC time in seconds
+     **
+     ** \param  pbWritten      Returns true if the heartbeat was written, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::heartbeatService(AMx8x5::stcHeartbeat* pstcHeartbeat, uint32_t u32Now, bool* pbWritten)
+    {
+        return Amx8x5_HeartbeatService(&stcRtcConfig,pstcHeartbeat,u32Now,pbWritten);
+    }
+
+
+    AMx8x5::enResult AMx8x5::enableInterrupt(uint8_t u8IrqMask)
+    {
+        return Amx8x5_EnableInterrupt(&stcRtcConfig,u8IrqMask);
+    }
+    AMx8x5::enResult AMx8x5::disableInterrupt(uint8_t u8IrqMask)
+    {
+        return Amx8x5_DisableInterrupt(&stcRtcConfig,u8IrqMask);
+    }
+    AMx8x5::enResult AMx8x5::clearInterrupts(void)
+    {
+        return Amx8x5_ClearInterrupts(&stcRtcConfig);
+    }
+    AMx8x5::enResult AMx8x5::clearInterrupt(uint8_t u8IrqMask)
+    {
+        return Amx8x5_ClearInterrupt(&stcRtcConfig,u8IrqMask);
+    }
+    AMx8x5::enResult AMx8x5::getInterruptStatus(uint8_t* pu8Status)
+    {
+        return Amx8x5_GetInterruptStatus(&stcRtcConfig,pu8Status);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Register the callback of an interrupt source for dispatchInterrupts()
+     **
+     ** \param  enSource       Interrupt source
+     **
+     ** \param  pfnCallback    Callback, NULL to unregister
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult AMx8x5::onInterrupt(AMx8x5::enIrqSource enSource, AMx8x5::pfnIrqCallback pfnCallback)
+    {
+        return Amx8x5_IrqDispatcherRegister(&stcIrqDispatcher,enSource,pfnCallback);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Read STATUS once, clear the serviced flags and call their callbacks
+     **
+     ** \param  pu8Serviced    returns the serviced sources as mask of (1 << enIrqSource), can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult AMx8x5::dispatchInterrupts(uint8_t* pu8Serviced)
+    {
+        return Amx8x5_IrqDispatch(&stcRtcConfig,&stcIrqDispatcher,pu8Serviced);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Feed an oscillator health monitor from dispatchInterrupts()
+     **
+     ** \param  pstcHealth     Monitor initialized by Amx8x5_OscHealthInit(), NULL to detach
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult AMx8x5::monitorOscHealth(AMx8x5::stcOscHealth* pstcHealth)
+    {
+        stcIrqDispatcher.pstcOscHealth = pstcHealth;
+        return Ok;
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Drain an ISR event queue and service the interrupts once
+     **
+     ** \param  pstcQueue      Event queue filled by the ISR with Amx8x5_EventQueuePush()
+     **
+     ** \param  pu8Serviced    returns the serviced sources as mask of (1 << enIrqSource), can be NULL
+     **
+     ** \return Ok on success, ErrorNotReady if no event was queued, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult AMx8x5::dispatchEvents(AMx8x5::stcEventQueue* pstcQueue, uint8_t* pu8Serviced)
+    {
+        return Amx8x5_EventQueueDispatch(&stcRtcConfig,pstcQueue,&stcIrqDispatcher,NULL,pu8Serviced);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Configure and start the watchdog timer.
+     **
+     ** \param u32Period     timeout period in ms (65 to 124,000)
+     **
+     ** \param  enPin        pin to generate the watchdog signal
+     **                      AMx8x5WatchdogInterruptPinDisable => disable WDT
+     **                      AMx8x5WatchdogInterruptPinFOUTnIRQ => generate an interrupt on FOUT/nIRQ
+     **                      AMx8x5WatchdogInterruptPinPSWnIRQ2 => generate an interrupt on PSW/nIRQ2
+     **                      AMx8x5WatchdogInterruptPinnRST => generate a reset on nRST (AM18xx only)
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     ** 
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::setWatchdog(uint32_t u32Period, AMx8x5::enWatchdogInterruptPin enPin)
+    {
+        return Amx8x5_SetWatchdog(&stcRtcConfig,u32Period,enPin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Configure and start the watchdog, cache the WDT value for kicks
+     **
+     ** \param  pstcWatchdog   Prepared watchdog
+     **
+     ** \param  u32Period      timeout period in ms (63 to 124,000)
+     **
+     ** \param  enPin          pin to generate the watchdog signal, not disabled
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::watchdogPrepare(AMx8x5::stcWatchdog* pstcWatchdog, uint32_t u32Period, AMx8x5::enWatchdogInterruptPin enPin)
+    {
+        return Amx8x5_WatchdogPrepare(&stcRtcConfig,pstcWatchdog,u32Period,enPin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Restart a prepared watchdog with one single byte write
+     **
+     ** \param  pstcWatchdog   Watchdog prepared by watchdogPrepare()
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::watchdogKick(AMx8x5::stcWatchdog* pstcWatchdog)
+    {
+        return Amx8x5_WatchdogKick(&stcRtcConfig,pstcWatchdog);
     }
 
     /**
      ******************************************************************************
-     ** \brief  This function is controlling the behavior of the I/O pins under 
-     **         various power down conditions.
+     ** \brief  Start the RTC watchdog for the registered tasks (AM18x5)
      **
-     ** see also #AMX8X5_REG_OCTRL definition
+     ** \param  pstcTaskWdt      Task watchdog with the tasks registered
      **
-     ** \param  u8OutputMask   Mask of outputs to enable / disable as defined in #AMX8X5_REG_OCTRL
+     ** \param  u32Period        RTC watchdog timeout in ms (63 to 124,000)
      **
-     ** \param  bEnable        1 for enable, 0 for disable
+     ** \param  u32KickInterval  Min. time between kicks in pfnClock units
      **
      ** \return Ok on success, else the Error as en_result_t
-     ** 
-     ** Example:
-     ** @code
-     ** Amx8x5_EnableOutput(&stcRtcConfig,AMX8X5_REG_OCTRL_O1EN_MSK,true);  //set FOUT/nIRQ as output
-     **
-     ** Amx8x5_EnableOutput(&stcRtcConfig,AMX8X5_REG_OCTRL_O1EN_MSK,false); //dont use FOUT/nIRQ as output
-     ** @endcode
      **
      ******************************************************************************/
-    AMx8x5::enResult  AMx8x5::enableTrickleCharger(AMx8x5::enTrickleDiode enDiode, AMx8x5::enTrickleResistor enResistor, bool bEnabled)
+    AMx8x5::enResult  AMx8x5::taskWdtStart(AMx8x5::stcTaskWdt* pstcTaskWdt, uint32_t u32Period, uint32_t u32KickInterval)
     {
-        return Amx8x5_EnableTrickleCharger(&stcRtcConfig,enDiode,enResistor,bEnabled);
+        return Amx8x5_TaskWdtStart(&stcRtcConfig,pstcTaskWdt,u32Period,u32KickInterval);
     }
 
     /**
      ******************************************************************************
-     ** \brief  This function controls the Trickle Charger
-     **
-     ** see also #AMX8X5_REG_TRICKLE definition
+     ** \brief  Collect the check-ins and kick the RTC watchdog if all tasks are alive
      **
-     ** \param  pstcHandle     RTC Handle
-     **
-     ** \param  enDiode        Diode Select.
-     **                        AMx8x5TrickleDiodeDisabled => disable the Trickle Charger.
-     **                        AMx8x5TrickleDiodeSchottky => inserts a schottky diode into the trickle charge circuit, with a voltage drop of 0.3V
-     **                        AMx8x5TrickleDiodeNormal => inserts a standard diode into the trickle charge circuit, with a voltage drop of 0.6V
-     ** 
-     ** \param  enResistor     Output Resistor.
+     ** \param  pstcTaskWdt    Task watchdog started by taskWdtStart()
      **
-     ** \param  bEnable        true for enable, false for disable
-     **                        AMx8x5TrickleResistorDisabled = 0> disable the Trickle Charger.
-     **                        AMx8x5TrickleResistor3K => this selects 3K Ohm as the output resistor of the trickle charge circuit
-     **                        AMx8x5TrickleResistor6K => this selects 6K Ohm as the output resistor of the trickle charge circuit
-     **                        AMx8x5TrickleResistor11K => this selects 11K Ohm as the output resistor of the trickle charge circuit
+     ** \param  pu8Culprit     Returns the starved task, #AMX8X5_TASKWDT_NONE if none, can be NULL
      **
      ** \return Ok on success, else the Error as en_result_t
-     ** 
      **
      ******************************************************************************/
-    AMx8x5::enResult  AMx8x5::setBatteryReferenceVoltage(AMx8x5::enBatReference enBref)
-    {
-        return Amx8x5_SetBatteryReferenceVoltage(&stcRtcConfig,enBref);
-    }
-
-
-    AMx8x5::enResult AMx8x5::enableInterrupt(uint8_t u8IrqMask)
-    {
-        return Amx8x5_EnableInterrupt(&stcRtcConfig,u8IrqMask);
-    }
-    AMx8x5::enResult AMx8x5::disableInterrupt(uint8_t u8IrqMask)
-    {
-        return Amx8x5_DisableInterrupt(&stcRtcConfig,u8IrqMask);
-    }
-    AMx8x5::enResult AMx8x5::clearInterrupts(void)
-    {
-        return Amx8x5_ClearInterrupts(&stcRtcConfig);
-    }
-    AMx8x5::enResult AMx8x5::clearInterrupt(uint8_t u8IrqMask)
-    {
-        return Amx8x5_ClearInterrupt(&stcRtcConfig,u8IrqMask);
-    }
-    AMx8x5::enResult AMx8x5::getInterruptStatus(uint8_t* pu8Status)
+    AMx8x5::enResult  AMx8x5::taskWdtService(AMx8x5::stcTaskWdt* pstcTaskWdt, uint8_t* pu8Culprit)
     {
-        return Amx8x5_GetInterruptStatus(&stcRtcConfig,pu8Status);
+        return Amx8x5_TaskWdtService(&stcRtcConfig,pstcTaskWdt,pu8Culprit);
     }
 
     /**
      ******************************************************************************
-     ** \brief  Select an oscillator mode.
+     ** \brief  Read and clear the starved task recorded before the last reset
      **
-     ** \param u32Period     timeout period in ms (65 to 124,000)
+     ** \param  pu8Task        Returns the starved task, #AMX8X5_TASKWDT_NONE if none
      **
-     ** \param  enPin        pin to generate the watchdog signal
-     **                      AMx8x5WatchdogInterruptPinDisable => disable WDT
-     **                      AMx8x5WatchdogInterruptPinFOUTnIRQ => generate an interrupt on FOUT/nIRQ
-     **                      AMx8x5WatchdogInterruptPinPSWnIRQ2 => generate an interrupt on PSW/nIRQ2
-     **                      AMx8x5WatchdogInterruptPinnRST => generate a reset on nRST (AM18xx only)
+     ** \param  u8RamAddress   RTC RAM address of the record
      **
      ** \return Ok on success, else the Error as en_result_t
-     ** 
      **
      ******************************************************************************/
-    AMx8x5::enResult  AMx8x5::setWatchdog(uint32_t u32Period, AMx8x5::enWatchdogInterruptPin enPin)
+    AMx8x5::enResult  AMx8x5::taskWdtCulprit(uint8_t* pu8Task, uint8_t u8RamAddress)
     {
-        return Amx8x5_SetWatchdog(&stcRtcConfig,u32Period,enPin);
+        return Amx8x5_TaskWdtCulprit(&stcRtcConfig,u8RamAddress,pu8Task);
     }
 
     /**
@@ -4846,6 +10936,41 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_SetSleepMode(&stcRtcConfig,ui8Timeout,enMode);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Arm the wake sources and enter sleep (AM18x5 only)
+     **
+     ** \param  u32Deadline    Wakeup in seconds since 2000-01-01 00:00:00, 0 for no alarm
+     **
+     ** \param  u8WakeSources  Further wake sources as mask of (1 << enIrqSource)
+     **
+     ** \param  u8Timeout      7.8 ms periods after the request until sleep (0 to 7)
+     **
+     ** \param  enMode         Sleep mode, see setSleepMode()
+     **
+     ** \return Ok on sleep request accepted,
+     **         OperationInProgress on sleep request declined, interrupt is currently pending
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::sleepUntil(uint32_t u32Deadline, uint8_t u8WakeSources, uint8_t u8Timeout, AMx8x5::enSleepMode enMode)
+    {
+        return Amx8x5_SleepUntil(&stcRtcConfig,u32Deadline,u8WakeSources,u8Timeout,enMode);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Decode why the system is running again (AM18x5 only)
+     **
+     ** \param  pstcReason     Returns the wake reason
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::wakeReason(AMx8x5::stcWakeReason* pstcReason)
+    {
+        return Amx8x5_WakeReason(&stcRtcConfig,pstcReason);
+    }
+
     /**
      ******************************************************************************
      ** \brief  Gets the extension address for the AMx8x5.
@@ -4944,6 +11069,190 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_SetCountdown(&stcRtcConfig,enRange,iPeriod,enRepeat,enPin);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Prepare a countdown for fast (re)starts, see Amx8x5_CountdownPrepare()
+     **
+     ** \param  pstcCountdown  Prepared countdown
+     **
+     ** \param  enRange        Periode range
+     **
+     ** \param  iPeriod        Periode in us or seconds
+     **
+     ** \param  enRepeat       Interrupt output
+     **
+     ** \param  enPin          Interrupt pin
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::countdownPrepare(AMx8x5::stcCountdown* pstcCountdown, AMx8x5::enPeriodeRange enRange, int32_t iPeriod, AMx8x5::enCountdownInterruptOutput enRepeat, AMx8x5::enCountdownInterruptPin enPin)
+    {
+        return Amx8x5_CountdownPrepare(&stcRtcConfig,pstcCountdown,enRange,iPeriod,enRepeat,enPin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Start or rearm a prepared countdown, see Amx8x5_CountdownStart()
+     **
+     ** \param  pstcCountdown  Prepared countdown
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::countdownStart(AMx8x5::stcCountdown* pstcCountdown)
+    {
+        return Amx8x5_CountdownStart(&stcRtcConfig,pstcCountdown);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Stop a prepared countdown, see Amx8x5_CountdownStop()
+     **
+     ** \param  pstcCountdown  Prepared countdown
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::countdownStop(AMx8x5::stcCountdown* pstcCountdown)
+    {
+        return Amx8x5_CountdownStop(&stcRtcConfig,pstcCountdown);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Start playing a timer sequence, see Amx8x5_SequenceStart()
+     **
+     ** \param  pstcSequence   Sequence, see Amx8x5_SequenceInit()
+     **
+     ** \param  enPin          Countdown interrupt pin
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::sequenceStart(AMx8x5::stcSequence* pstcSequence, AMx8x5::enCountdownInterruptPin enPin)
+    {
+        return Amx8x5_SequenceStart(&stcRtcConfig,pstcSequence,enPin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Stage the next interval, see Amx8x5_SequenceService()
+     **
+     ** \param  pstcSequence   Sequence
+     **
+     ** \param  pbDone         returns true once the last interval ended, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::sequenceService(AMx8x5::stcSequence* pstcSequence, bool* pbDone)
+    {
+        return Amx8x5_SequenceService(&stcRtcConfig,pstcSequence,pbDone);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Initialize the tickless idle timebase, see Amx8x5_TicklessInit()
+     **
+     ** \param  pstcTickless   Timebase
+     **
+     ** \param  u32TickHz      OS tick frequency
+     **
+     ** \param  enPin          Countdown interrupt pin waking the MCU
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::ticklessInit(AMx8x5::stcTickless* pstcTickless, uint32_t u32TickHz, AMx8x5::enCountdownInterruptPin enPin)
+    {
+        return Amx8x5_TicklessInit(&stcRtcConfig,pstcTickless,u32TickHz,enPin);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Start the countdown for an idle period, see Amx8x5_TicklessSleep()
+     **
+     ** \param  pstcTickless   Timebase
+     **
+     ** \param  u32Ticks       Expected idle time in OS ticks
+     **
+     ** \param  pu32Ticks      returns the programmed sleep in OS ticks, can be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::ticklessSleep(AMx8x5::stcTickless* pstcTickless, uint32_t u32Ticks, uint32_t* pu32Ticks)
+    {
+        return Amx8x5_TicklessSleep(&stcRtcConfig,pstcTickless,u32Ticks,pu32Ticks);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Stop the countdown after wakeup, see Amx8x5_TicklessWake()
+     **
+     ** \param  pstcTickless   Timebase
+     **
+     ** \param  pu32Ticks      returns the slept OS ticks
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::ticklessWake(AMx8x5::stcTickless* pstcTickless, uint32_t* pu32Ticks)
+    {
+        return Amx8x5_TicklessWake(&stcRtcConfig,pstcTickless,pu32Ticks);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Restore the persisted calibration, see Amx8x5_DriftRestore()
+     **
+     ** \param  pstcDrift      Drift estimator
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::driftRestore(AMx8x5::stcDrift* pstcDrift)
+    {
+        return Amx8x5_DriftRestore(&stcRtcConfig,pstcDrift);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Add a drift sample, see Amx8x5_DriftAddSample()
+     **
+     ** \param  pstcDrift      Drift estimator
+     **
+     ** \param  u32RefSeconds  Reference time in s
+     **
+     ** \param  i32OffsetUs    RTC minus reference time in us
+     **
+     ** \param  pbApplied      Returns true if a new calibration was applied, may be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::driftAddSample(AMx8x5::stcDrift* pstcDrift, uint32_t u32RefSeconds, int32_t i32OffsetUs, bool* pbApplied)
+    {
+        return Amx8x5_DriftAddSample(&stcRtcConfig,pstcDrift,u32RefSeconds,i32OffsetUs,pbApplied);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Update the temperature compensation, see Amx8x5_TempCompService()
+     **
+     ** \param  pstcTempComp   Temperature compensation
+     **
+     ** \param  pbWritten      Returns true if the calibration was written, may be NULL
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::tempCompService(AMx8x5::stcTempComp* pstcTempComp, bool* pbWritten)
+    {
+        return Amx8x5_TempCompService(&stcRtcConfig,pstcTempComp,pbWritten);
+    }
+
     /**
      ******************************************************************************
      ** \brief  Set up autocalibration.
@@ -4995,6 +11304,64 @@ en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address,
         return Amx8x5_RamWrite(&stcRtcConfig,u8Address,u8Data);
     }
 
+    /**
+     ******************************************************************************
+     ** \brief  Capture the register set 0x00..0x30 with a single burst read.
+     **
+     ** \param  pstcState      Snapshot to fill
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::saveState(AMx8x5::stcState* pstcState)
+    {
+        return Amx8x5_SaveState(&stcRtcConfig,pstcState);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Restore the writable registers of a snapshot taken by saveState()
+     **
+     ** \param  pstcState      Snapshot to restore
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::restoreState(AMx8x5::stcState* pstcState)
+    {
+        return Amx8x5_RestoreState(&stcRtcConfig,pstcState);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Compare the current configuration with the stored fingerprint
+     **
+     ** \param  pbWarmBoot     returns true if the configuration is unchanged
+     **
+     ** \param  u8RamAddress   RTC RAM address of the 2 byte fingerprint
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::checkWarmBoot(bool* pbWarmBoot, uint8_t u8RamAddress)
+    {
+        return Amx8x5_CheckWarmBoot(&stcRtcConfig,u8RamAddress,pbWarmBoot);
+    }
+
+    /**
+     ******************************************************************************
+     ** \brief  Store the fingerprint of the current configuration in RTC RAM
+     **
+     ** \param  u8RamAddress   RTC RAM address of the 2 byte fingerprint
+     **
+     ** \return Ok on success, else the Error as en_result_t
+     **
+     ******************************************************************************/
+    AMx8x5::enResult  AMx8x5::saveConfigFingerprint(uint8_t u8RamAddress)
+    {
+        return Amx8x5_SaveConfigFingerprint(&stcRtcConfig,u8RamAddress);
+    }
+
     /**
      ******************************************************************************
      ** \brief  Clear bits in register
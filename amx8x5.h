@@ -73,6 +73,77 @@
  ** - Amx8x5_SetBatteryReferenceVoltage()
  ** - Amx8x5_RamRead()
  ** - Amx8x5_RamWrite()
+ ** - Amx8x5_SaveState()
+ ** - Amx8x5_RestoreState()
+ ** - Amx8x5_CheckWarmBoot()
+ ** - Amx8x5_SaveConfigFingerprint()
+ ** - Amx8x5_IrqDispatcherInit()
+ ** - Amx8x5_IrqDispatcherRegister()
+ ** - Amx8x5_IrqDispatch()
+ ** - Amx8x5_EventQueueInit()
+ ** - Amx8x5_EventQueuePush()
+ ** - Amx8x5_EventQueuePop()
+ ** - Amx8x5_EventQueueDispatch()
+ ** - Amx8x5_TimeToSeconds()
+ ** - Amx8x5_SecondsToTime()
+ ** - Amx8x5_GetSeconds()
+ ** - Amx8x5_AlarmInit()
+ ** - Amx8x5_AlarmRearm()
+ ** - Amx8x5_SwAlarmInit()
+ ** - Amx8x5_SwAlarmStart()
+ ** - Amx8x5_SwAlarmStop()
+ ** - Amx8x5_SwAlarmService()
+ ** - Amx8x5_ScheduleInit()
+ ** - Amx8x5_ScheduleNext()
+ ** - Amx8x5_ScheduleToAlarm()
+ ** - Amx8x5_ScheduleArm()
+ ** - Amx8x5_SubSecondAlarmStart()
+ ** - Amx8x5_SubSecondAlarmService()
+ ** - Amx8x5_CountdownPrepare()
+ ** - Amx8x5_CountdownStart()
+ ** - Amx8x5_CountdownStop()
+ ** - Amx8x5_SequenceEncode()
+ ** - Amx8x5_SequenceInit()
+ ** - Amx8x5_SequenceStart()
+ ** - Amx8x5_SequenceService()
+ ** - Amx8x5_TicklessInit()
+ ** - Amx8x5_TicklessSleep()
+ ** - Amx8x5_TicklessWake()
+ ** - Amx8x5_SetTimePrecise()
+ ** - Amx8x5_GetTimePrecise()
+ ** - Amx8x5_DriftInit()
+ ** - Amx8x5_DriftRestore()
+ ** - Amx8x5_DriftAddSample()
+ ** - Amx8x5_TempCompInit()
+ ** - Amx8x5_TempCompDeviation()
+ ** - Amx8x5_TempCompService()
+ ** - Amx8x5_CalibrationEncode()
+ ** - Amx8x5_CalibrationDecode()
+ ** - Amx8x5_GetCalibrationValue()
+ ** - Amx8x5_OscHealthInit()
+ ** - Amx8x5_OscHealthSample()
+ ** - Amx8x5_BatteryEstimate()
+ ** - Amx8x5_BatteryInit()
+ ** - Amx8x5_BatteryService()
+ ** - Amx8x5_TrickleInit()
+ ** - Amx8x5_TrickleService()
+ ** - Amx8x5_SleepUntil()
+ ** - Amx8x5_WakeReason()
+ ** - Amx8x5_PowerFailInit()
+ ** - Amx8x5_PowerFailRecover()
+ ** - Amx8x5_PowerFailArm()
+ ** - Amx8x5_PowerFailRecord()
+ ** - Amx8x5_HeartbeatInit()
+ ** - Amx8x5_LastShutdownInfo()
+ ** - Amx8x5_HeartbeatService()
+ ** - Amx8x5_WatchdogPrepare()
+ ** - Amx8x5_WatchdogKick()
+ ** - Amx8x5_TaskWdtInit()
+ ** - Amx8x5_TaskWdtRegister()
+ ** - Amx8x5_TaskWdtStart()
+ ** - Amx8x5_TaskWdtCheckIn()
+ ** - Amx8x5_TaskWdtService()
+ ** - Amx8x5_TaskWdtCulprit()
  ** - Amx8x5_CtrlOutB()
  ** - Amx8x5_CtrlOut()
  ** - Amx8x5_SetResetPolarity()
@@ -292,6 +363,22 @@
     
 #define AMX8X5_DEBUG                         0
 
+#if !defined(AMX8X5_EVENT_QUEUE_SIZE)
+#define AMX8X5_EVENT_QUEUE_SIZE              16 ///< slots of #stc_amx8x5_event_queue_t, power of two, max. 128
+#endif
+
+#if !defined(AMX8X5_SWALARM_MAX)
+#define AMX8X5_SWALARM_MAX                   8 ///< software alarms of #stc_amx8x5_swalarm_t, max. 255
+#endif
+
+#if !defined(AMX8X5_MEMORY_BARRIER)
+  #if defined(__GNUC__)
+    #define AMX8X5_MEMORY_BARRIER()          __sync_synchronize() ///< full memory barrier for the lock-free event queue
+  #else
+    #define AMX8X5_MEMORY_BARRIER()          ///< define for multi-core targets without GCC builtins
+  #endif
+#endif
+
 // see https://stackoverflow.com/questions/11697820/how-to-use-date-and-time-predefined-macros-in-as-two-integers-then-stri
 
 #define BUILD_YEAR_CH0 (__DATE__[ 7])
@@ -1542,6 +1629,19 @@
  **
  **/
 #define AMX8X5_REG_SLEEP_CTRL                0x17
+
+#define AMX8X5_REG_SLEEP_CTRL_SLP_POS        (7)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLP_MSK        (1 << AMX8X5_REG_SLEEP_CTRL_SLP_POS)  ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLRES_POS      (6)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLRES_MSK      (1 << AMX8X5_REG_SLEEP_CTRL_SLRES_POS)///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_EX2P_POS       (5)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_EX2P_MSK       (1 << AMX8X5_REG_SLEEP_CTRL_EX2P_POS) ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_EX1P_POS       (4)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_EX1P_MSK       (1 << AMX8X5_REG_SLEEP_CTRL_EX1P_POS) ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLST_POS       (3)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLST_MSK       (1 << AMX8X5_REG_SLEEP_CTRL_SLST_POS) ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLTO_POS       (0)                                   ///<see #AMX8X5_REG_SLEEP_CTRL for more information
+#define AMX8X5_REG_SLEEP_CTRL_SLTO_MSK       (0x7 << AMX8X5_REG_SLEEP_CTRL_SLTO_POS) ///<see #AMX8X5_REG_SLEEP_CTRL for more information
 //@}
     
 /**
@@ -1699,6 +1799,12 @@
  **
  **/
 #define AMX8X5_REG_WDT                       0x1B
+#define AMX8X5_REG_WDT_WDS_POS               (7)                               ///<see #AMX8X5_REG_WDT for more information
+#define AMX8X5_REG_WDT_WDS_MSK               (1 << AMX8X5_REG_WDT_WDS_POS)     ///<see #AMX8X5_REG_WDT for more information
+#define AMX8X5_REG_WDT_BMB_POS               (2)                               ///<see #AMX8X5_REG_WDT for more information
+#define AMX8X5_REG_WDT_BMB_MSK               (0x1F << AMX8X5_REG_WDT_BMB_POS)  ///<see #AMX8X5_REG_WDT for more information
+#define AMX8X5_REG_WDT_WRB_POS               (0)                               ///<see #AMX8X5_REG_WDT for more information
+#define AMX8X5_REG_WDT_WRB_MSK               (0x3 << AMX8X5_REG_WDT_WRB_POS)   ///<see #AMX8X5_REG_WDT for more information
 //@}
     
 /**
@@ -2006,6 +2112,12 @@
  **/
 //@{
 #define AMX8X5_REG_ASTAT                     0x2F ///< This register holds eight status bits which indicate the voltage levels of the VCC and VBAT power inputs.
+#define AMX8X5_REG_ASTAT_BBOD_POS            (7)                                  ///<see #AMX8X5_REG_ASTAT  for more information
+#define AMX8X5_REG_ASTAT_BBOD_MSK            (1 << AMX8X5_REG_ASTAT_BBOD_POS)     ///<VBAT is above the reference selected by BREF
+#define AMX8X5_REG_ASTAT_BMIN_POS            (6)                                  ///<see #AMX8X5_REG_ASTAT  for more information
+#define AMX8X5_REG_ASTAT_BMIN_MSK            (1 << AMX8X5_REG_ASTAT_BMIN_POS)     ///<VBAT is above the minimum operating voltage
+#define AMX8X5_REG_ASTAT_VINIT_POS           (1)                                  ///<see #AMX8X5_REG_ASTAT  for more information
+#define AMX8X5_REG_ASTAT_VINIT_MSK           (1 << AMX8X5_REG_ASTAT_VINIT_POS)    ///<VCC is above the power up voltage
 //@}     
      
 /**
@@ -2121,6 +2233,68 @@
 #define AMX8X5_12HR_MODE                 0x01 ///<12h mode value
 #define AMX8X5_24HR_MODE                 0x02 ///<24h mode value
 
+// Register snapshot
+#define AMX8X5_STATE_SIZE                (AMX8X5_REG_OCTRL + 1) ///<number of registers (0x00..0x30) captured by Amx8x5_SaveState()
+
+// Default RTC RAM locations
+#define AMX8X5_RAM_FINGERPRINT           0xFE ///<default RAM address of the 2 byte warm boot fingerprint (0xFE..0xFF)
+#define AMX8X5_RAM_DRIFT                 0xFA ///<default RAM address of the 4 byte drift record of Amx8x5_DriftAddSample() (0xFA..0xFD)
+#define AMX8X5_RAM_POWERFAIL             0xEA ///<default RAM address of the 16 byte power-fail record (0xEA..0xF9)
+#define AMX8X5_RAM_HEARTBEAT             0xE1 ///<default RAM address of the 9 byte heartbeat record (0xE1..0xE9)
+#define AMX8X5_RAM_TASKWDT               0xDF ///<default RAM address of the 2 byte starved task record (0xDF..0xE0)
+
+// Calibration limits of Amx8x5_SetCalibrationValue()
+#define AMX8X5_CALIBRATION_XT_MIN_PPM    (-610L)   ///<min. XT adjustment in ppm
+#define AMX8X5_CALIBRATION_XT_MAX_PPM    242L      ///<max. XT adjustment in ppm
+#define AMX8X5_CALIBRATION_RC_MIN_PPM    (-65536L) ///<min. RC adjustment in ppm
+#define AMX8X5_CALIBRATION_RC_MAX_PPM    65520L    ///<max. RC adjustment in ppm
+#define AMX8X5_CALIBRATION_RECIPROCAL    72070768UL ///<ceil(2^37 / 1907), x / 1907 == (x * this) >> 37 for x < 2^26
+
+// Service loop
+#define AMX8X5_DEFERRED_WORK_MAX         4    ///<number of work items AMx8x5::defer() can hold until the next AMx8x5::update()
+
+// Precise time
+#define AMX8X5_PRECISE_EDGE_TIMEOUT_US   20000 ///<max. us Amx8x5_GetTimePrecise() polls for a hundredth edge
+
+// Drift estimation
+#define AMX8X5_DRIFT_OUTLIER_US          20000 ///<default max. distance of a sample from the fit in us
+#define AMX8X5_DRIFT_CONFIDENCE_PPB      250   ///<default max. standard error of the drift before it is applied
+#define AMX8X5_DRIFT_MIN_SAMPLES         5     ///<min. samples checked against a fit before it is applied
+#define AMX8X5_DRIFT_MAX_REJECTS         3     ///<rejected samples in a row that restart the fit (time step)
+#define AMX8X5_DRIFT_SIZE                4     ///<bytes of the drift record in RTC RAM
+
+// Battery estimation
+#define AMX8X5_BATTERY_LEVELS            4      ///<BREF thresholds searched by Amx8x5_BatteryEstimate()
+#define AMX8X5_BATTERY_CONFIRM           2      ///<equal measurements before Amx8x5_BatteryService() reports a new level
+#define AMX8X5_BATTERY_UNKNOWN_MV        0xFFFF ///<upper bound of the bracket above the highest threshold
+
+// Power-fail record
+#define AMX8X5_POWERFAIL_SIZE            16     ///<bytes of the power-fail record in RTC RAM
+#define AMX8X5_POWERFAIL_OPEN            0x01   ///<record flag: outage recorded, not recovered yet
+
+// Heartbeat record
+#define AMX8X5_HEARTBEAT_SIZE            9      ///<bytes of the heartbeat record in RTC RAM
+
+// Task watchdog
+#define AMX8X5_TASKWDT_MAX               8      ///<tasks supervised by one #stc_amx8x5_taskwdt_t
+#define AMX8X5_TASKWDT_NONE              0xFF   ///<no starved task
+
+// Software alarms
+#define AMX8X5_SWALARM_MAX_ARM           (364UL * 86400UL) ///<max. seconds ahead the yearly hardware alarm is armed
+
+// Schedules
+#define AMX8X5_SCHEDULE_MINUTE_ALL       0x0FFFFFFFFFFFFFFFULL ///<minutes 0..59 of #stc_amx8x5_schedule_t
+#define AMX8X5_SCHEDULE_HOUR_ALL         0x00FFFFFFUL          ///<hours 0..23 of #stc_amx8x5_schedule_t
+#define AMX8X5_SCHEDULE_DATE_ALL         0xFFFFFFFEUL          ///<days of month 1..31 of #stc_amx8x5_schedule_t
+#define AMX8X5_SCHEDULE_MONTH_ALL        0x1FFE                ///<months 1..12 of #stc_amx8x5_schedule_t
+#define AMX8X5_SCHEDULE_WEEKDAY_ALL      0x7F                  ///<weekdays 0..6 of #stc_amx8x5_schedule_t
+#define AMX8X5_SCHEDULE_MAX_DAYS         2922                  ///<days Amx8x5_ScheduleNext() searches ahead (8 years)
+
+// Sub-second alarms
+#define AMX8X5_SUBSECOND_MAX             6000   ///<hundredths per minute, longest period of Amx8x5_SubSecondAlarmStart()
+#define AMX8X5_SUBSECOND_GUARD           2      ///<min. hundredths between rearm and the next match
+#define AMX8X5_SUBSECOND_SOFTWARE_MAX    3000   ///<longest period rearmed by Amx8x5_SubSecondAlarmService()
+
 /**
  *****************************************************************************
  ** \brief BCD format to decimal number conversion
@@ -2594,6 +2768,28 @@ typedef enum en_amx8x5_bat_reference
      AMx8x5BatReferenceFalling14V_Rising16V = 0xF, ///< VBAT Falling Voltage 1.4V, VBAT Rising Voltage 1.6V
 } en_amx8x5_bat_reference_t;
 
+/**
+ ******************************************************************************
+ ** \brief Interrupt sources handled by the interrupt dispatcher
+ **
+ ** AMx8x5IrqEx1..AMx8x5IrqWatchdog equal the flag positions in
+ ** #AMX8X5_REG_STATUS, oscillator and autocalibration fail are taken from
+ ** #AMX8X5_REG_OSC_STATUS
+ **
+ ******************************************************************************/
+typedef enum en_amx8x5_irq_source
+{
+    AMx8x5IrqEx1 = 0,              ///< external interrupt EXTI (EX1)
+    AMx8x5IrqEx2 = 1,              ///< external interrupt WDI (EX2)
+    AMx8x5IrqAlarm = 2,            ///< alarm (ALM)
+    AMx8x5IrqTimer = 3,            ///< countdown timer (TIM)
+    AMx8x5IrqBatteryLow = 4,       ///< battery low (BL)
+    AMx8x5IrqWatchdog = 5,         ///< watchdog (WDT)
+    AMx8x5IrqOscillatorFail = 6,   ///< oscillator fail (OF)
+    AMx8x5IrqAutocalibFail = 7,    ///< autocalibration fail (ACF)
+    AMx8x5IrqSourceCount = 8,      ///< number of sources
+} en_amx8x5_irq_source_t;
+
 /**
  ******************************************************************************
  ** \brief Function type for SPI write
@@ -2751,6 +2947,469 @@ typedef struct stc_amx8x5_time
     uint8_t u8Mode;      ///< Mode
 } stc_amx8x5_time_t;
 
+/**
+ ******************************************************************************
+ ** \brief RTC register snapshot
+ **
+ ** Raw image of the registers 0x00 (#AMX8X5_REG_HUNDREDTHS) up to 0x30
+ ** (#AMX8X5_REG_OCTRL), au8Register[n] holds register n.
+ ** Filled by Amx8x5_SaveState(), written back by Amx8x5_RestoreState().
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_state
+{
+    uint8_t au8Register[AMX8X5_STATE_SIZE]; ///< Register 0x00..0x30
+} stc_amx8x5_state_t;
+
+/**
+ ******************************************************************************
+ ** \brief Interrupt callback, called by Amx8x5_IrqDispatch()
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  enSource       Interrupt source
+ **
+ ******************************************************************************/
+typedef void (*pfn_amx8x5_irq_callback) (stc_amx8x5_handle_t* pstcHandle, en_amx8x5_irq_source_t enSource);
+
+/**
+ ******************************************************************************
+ ** \brief Host monotonic clock in microseconds, e.g. micros() on Arduino
+ **
+ ******************************************************************************/
+typedef uint32_t (*pfn_amx8x5_micros)(void);
+
+/**
+ ******************************************************************************
+ ** \brief Action of the oscillator health monitor, see Amx8x5_OscHealthSample()
+ **
+ ******************************************************************************/
+typedef enum en_amx8x5_osc_health_policy
+{
+    AMx8x5OscHealthPolicyAlert = 0,          ///< invoke the alert callback only
+    AMx8x5OscHealthPolicyShortenAutocal = 1, ///< autocalibrate every 512 seconds
+    AMx8x5OscHealthPolicyFallbackXt = 2,     ///< switch to the 32 KHz XT oscillator
+} en_amx8x5_osc_health_policy_t;
+
+/**
+ ******************************************************************************
+ ** \brief Oscillator health alert, called by Amx8x5_OscHealthSample()
+ **
+ ** \param  pstcHandle     RTC Handle
+ **
+ ** \param  u8Failures     New failures as mask of #AMX8X5_REG_OSC_STATUS_OF_MSK and #AMX8X5_REG_OSC_STATUS_ACF_MSK
+ **
+ ******************************************************************************/
+typedef void (*pfn_amx8x5_osc_health_alert) (stc_amx8x5_handle_t* pstcHandle, uint8_t u8Failures);
+
+/**
+ ******************************************************************************
+ ** \brief Oscillator health monitor, counts OF and ACF failures
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_osc_health
+{
+    en_amx8x5_osc_health_policy_t enPolicy;  ///< Action once u8Threshold ACF failures are counted
+    uint8_t u8Threshold;                     ///< ACF failures triggering enPolicy, 0 = never
+    pfn_amx8x5_osc_health_alert pfnAlert;    ///< Called on every new failure, can be NULL
+    pfn_amx8x5_micros pfnClock;              ///< Timestamp source of the last failures in microseconds (e.g. micros), can be NULL
+    uint8_t u8Flags;                         ///< OF and ACF of the last sample
+    uint16_t u16OfCount;                     ///< Oscillator failures counted
+    uint16_t u16AcfCount;                    ///< Autocalibration failures counted
+    uint32_t u32LastOf;                      ///< pfnClock at the last oscillator failure, in microseconds
+    uint32_t u32LastAcf;                     ///< pfnClock at the last autocalibration failure, in microseconds
+    bool bPolicyApplied;                     ///< enPolicy was executed
+} stc_amx8x5_osc_health_t;
+
+/**
+ ******************************************************************************
+ ** \brief Interrupt dispatcher, callbacks per interrupt source
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_irq_dispatcher
+{
+    pfn_amx8x5_irq_callback apfnCallback[AMx8x5IrqSourceCount]; ///< Callbacks, NULL if not registered
+    stc_amx8x5_osc_health_t* pstcOscHealth;                     ///< Fed with every OSC_STATUS read, can be NULL
+} stc_amx8x5_irq_dispatcher_t;
+
+/**
+ ******************************************************************************
+ ** \brief RTC interrupt event as queued by the ISR
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_event
+{
+    uint32_t u32Timestamp; ///< Timestamp taken by the ISR (e.g. micros())
+    uint8_t u8Pin;         ///< Application defined source (e.g. pin number)
+} stc_amx8x5_event_t;
+
+/**
+ ******************************************************************************
+ ** \brief Single producer / single consumer lock-free event queue
+ **
+ ** The ISR (producer) only writes u8Head and u8Dropped, the task
+ ** (consumer) only writes u8Tail. Both indices run freely, the fill level
+ ** is (uint8_t)(u8Head - u8Tail).
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_event_queue
+{
+    volatile uint8_t u8Head;       ///< Next slot to write, producer only
+    volatile uint8_t u8Tail;       ///< Next slot to read, consumer only
+    volatile uint8_t u8Dropped;    ///< Events dropped because the queue was full (saturating), producer only
+    volatile stc_amx8x5_event_t astcEvent[AMX8X5_EVENT_QUEUE_SIZE]; ///< Event slots
+} stc_amx8x5_event_queue_t;
+
+/**
+ ******************************************************************************
+ ** \brief Blocks until a reference edge, see Amx8x5_SetTimePrecise()
+ **
+ ** \param pstcHandle   RTC Handle
+ **
+ ******************************************************************************/
+typedef void (*pfn_amx8x5_wait_edge)(stc_amx8x5_handle_t* pstcHandle);
+
+/**
+ ******************************************************************************
+ ** \brief Time with host timestamp, see Amx8x5_GetTimePrecise()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_time_precise
+{
+    stc_amx8x5_time_t stcTime;   ///< RTC time
+    uint32_t u32HostUs;          ///< Host clock (pfn_amx8x5_micros) when the RTC showed stcTime
+    uint32_t u32UncertaintyUs;   ///< +/- bound of u32HostUs
+} stc_amx8x5_time_precise_t;
+
+/**
+ ******************************************************************************
+ ** \brief Temperature sensor callback, see Amx8x5_TempCompService()
+ **
+ ** \param pstcHandle      RTC Handle
+ ** \param pi16Temperature Returns the temperature in 1/16 degC
+ **
+ ** \return Ok on success, else the Error as en_result_t
+ **
+ ******************************************************************************/
+typedef en_result_t (*pfn_amx8x5_temperature)(stc_amx8x5_handle_t* pstcHandle, int16_t* pi16Temperature);
+
+/**
+ ******************************************************************************
+ ** \brief Temperature compensation of the XT oscillator
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_tempcomp
+{
+    const int16_t* pi16Ppm;    ///< Crystal deviation in 1/16 ppm per table entry
+    uint8_t u8Count;           ///< Table entries
+    int8_t i8StartC;           ///< Temperature of the first entry in degC
+    uint8_t u8StepC;           ///< Temperature step between entries in degC
+    pfn_amx8x5_temperature pfnTemperature; ///< Temperature sensor
+    int32_t i32OffsetPpm16;    ///< Static correction in 1/16 ppm added to the table
+    int16_t i16Steps;          ///< Calibration steps last written
+    bool bWritten;             ///< i16Steps was written
+} stc_amx8x5_tempcomp_t;
+
+/**
+ ******************************************************************************
+ ** \brief Closed-loop drift estimator, see Amx8x5_DriftAddSample()
+ **
+ ** x is the reference time in s, y the RTC offset in us, both relative to
+ ** the first sample of the fit.
+ **
+ ** RTC RAM record of #AMX8X5_DRIFT_SIZE bytes: applied correction (3)
+ ** little endian, check byte (1).
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_drift
+{
+    en_amx8x5_calibration_mode_t enMode; ///< Oscillator the correction is applied to
+    int32_t i32AppliedPpm;      ///< Calibration currently set
+    int32_t i32DriftPpb;        ///< Drift estimate of the current fit, RTC fast if positive
+    uint32_t u32OutlierUs;      ///< Max. distance of a sample from the fit
+    uint16_t u16ConfidencePpb;  ///< Max. standard error of the drift before it is applied
+    uint8_t u8RamAddress;       ///< RTC RAM address of the persisted correction
+    uint8_t u8Xadd;             ///< EXTENDED_ADDR value selecting the RAM bank of the record, 0 until read
+    uint8_t u8Count;            ///< Samples in the fit, incl. the first one
+    uint8_t u8Residuals;        ///< Prediction residuals in u64Srr
+    uint8_t u8Rejected;         ///< Rejected samples in a row
+    uint32_t u32X0;             ///< Reference time of the first sample
+    int32_t i32Y0;              ///< Offset of the first sample
+    int64_t i64Sx;              ///< Sum x
+    int64_t i64Sy;              ///< Sum y
+    int64_t i64Sxx;             ///< Sum x^2
+    int64_t i64Sxy;             ///< Sum x*y
+    uint64_t u64Srr;            ///< Sum of squared prediction residuals
+    stc_amx8x5_tempcomp_t* pstcTempComp; ///< If set, corrections go to its i32OffsetPpm16 instead of the XT calibration, can be NULL
+} stc_amx8x5_drift_t;
+
+/**
+ ******************************************************************************
+ ** \brief Scheduled battery estimation, see Amx8x5_BatteryService()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_battery
+{
+    uint32_t u32Period;        ///< Seconds between measurements
+    uint32_t u32Last;          ///< Time of the last measurement in seconds
+    uint8_t u8Level;           ///< Reported level, BREF thresholds VBAT is above (0..4)
+    uint8_t u8Pending;         ///< Level measured but not confirmed yet
+    uint8_t u8Confirm;         ///< Measurements of u8Pending in a row
+    uint16_t u16MinMv;         ///< Lower bound of VBAT at u8Level in mV
+    uint16_t u16MaxMv;         ///< Upper bound of VBAT at u8Level in mV, #AMX8X5_BATTERY_UNKNOWN_MV if none
+    bool bValid;               ///< A level was measured
+} stc_amx8x5_battery_t;
+
+/**
+ ******************************************************************************
+ ** \brief Trickle charger policy, see Amx8x5_TrickleService()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_trickle_policy
+{
+    uint8_t u8FullLevel;                         ///< Battery level (see Amx8x5_BatteryEstimate()) charging stops at
+    uint32_t u32BoostSeconds;                    ///< Max. charge time with the boost setting
+    en_amx8x5_trickle_diode_t enBoostDiode;      ///< Diode while far from full and within u32BoostSeconds
+    en_amx8x5_trickle_resistor_t enBoostResistor;///< Resistor while far from full and within u32BoostSeconds
+    en_amx8x5_trickle_diode_t enTaperDiode;      ///< Diode one level below full or after u32BoostSeconds
+    en_amx8x5_trickle_resistor_t enTaperResistor;///< Resistor one level below full or after u32BoostSeconds
+    uint32_t u32ChargeStart;                     ///< Time charging started in seconds
+    uint8_t u8Trickle;                           ///< TRICKLE value last written
+    bool bCharging;                              ///< Charger is enabled
+    bool bWritten;                               ///< u8Trickle was written
+} stc_amx8x5_trickle_policy_t;
+
+/**
+ ******************************************************************************
+ ** \brief Wake reason, see Amx8x5_WakeReason()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_wake_reason
+{
+    uint8_t u8Sources;         ///< Pending STATUS flags EX1..WDT as mask of (1 << #en_amx8x5_irq_source_t)
+    bool bSlept;               ///< SLST: the RTC entered sleep since SLEEP_CTRL was read last
+    bool bBattery;             ///< BAT: the RTC switched to VBAT since the flag was cleared
+} stc_amx8x5_wake_reason_t;
+
+/**
+ ******************************************************************************
+ ** \brief Power-fail recorder, see Amx8x5_PowerFailRecord()
+ **
+ ** RTC RAM record of #AMX8X5_POWERFAIL_SIZE bytes: outage start as time
+ ** registers HUNDREDTHS..WEEKDAY (8), duration (4) and count (2) little
+ ** endian, flags (1), check byte (1).
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_powerfail
+{
+    uint8_t u8RamAddress;      ///< RTC RAM address of the record, e.g. #AMX8X5_RAM_POWERFAIL
+    uint8_t u8Xadd;            ///< EXTENDED_ADDR value selecting the RAM bank of the record
+    uint16_t u16Count;         ///< Outages recorded
+    bool bOpen;                ///< An outage is recorded and not recovered yet
+    bool bReady;               ///< Record loaded by Amx8x5_PowerFailRecover()
+} stc_amx8x5_powerfail_t;
+
+/**
+ ******************************************************************************
+ ** \brief Last outage, see Amx8x5_PowerFailRecover()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_outage
+{
+    uint32_t u32Start;         ///< Seconds since 2000 when the outage was recorded, 0 if none
+    uint32_t u32Duration;      ///< Seconds until the outage was recovered
+    uint16_t u16Count;         ///< Outages recorded
+    bool bNew;                 ///< The outage was recovered by this call
+} stc_amx8x5_outage_t;
+
+/**
+ ******************************************************************************
+ ** \brief Last alive heartbeat, see Amx8x5_HeartbeatService()
+ **
+ ** RTC RAM record of #AMX8X5_HEARTBEAT_SIZE bytes, little endian:
+ ** boot time (4), last alive time (4), check byte (1).
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_heartbeat
+{
+    uint8_t u8RamAddress;      ///< RTC RAM address of the record, e.g. #AMX8X5_RAM_HEARTBEAT
+    uint8_t u8Xadd;            ///< EXTENDED_ADDR value selecting the RAM bank of the record
+    uint32_t u32Interval;      ///< Seconds between heartbeat writes
+    uint32_t u32Boot;          ///< Time of Amx8x5_LastShutdownInfo() in seconds
+    uint32_t u32Last;          ///< Time of the last heartbeat written in seconds
+    bool bReady;               ///< Record started by Amx8x5_LastShutdownInfo()
+} stc_amx8x5_heartbeat_t;
+
+/**
+ ******************************************************************************
+ ** \brief Previous run, see Amx8x5_LastShutdownInfo()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_shutdown_info
+{
+    uint32_t u32Boot;          ///< Start of the previous run in seconds since 2000
+    uint32_t u32LastAlive;     ///< Last heartbeat of the previous run in seconds since 2000
+    uint32_t u32Uptime;        ///< Seconds from start to last heartbeat of the previous run
+    uint32_t u32Downtime;      ///< Seconds from last heartbeat until now, up to one interval too long
+    bool bValid;               ///< The RAM held a heartbeat, else all times are 0
+} stc_amx8x5_shutdown_info_t;
+
+/**
+ ******************************************************************************
+ ** \brief Alarm configuration remembered by Amx8x5_AlarmRearm()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_alarm_config
+{
+    en_amx8x5_alarm_repeat_t enModeRepeat;  ///< Repeat mode of the last full call
+    en_amx8x5_interrupt_mode_t enModeIrq;   ///< Interrupt mode of the last full call
+    en_amx8x5_interrupt_pin_t enModePin;    ///< Interrupt pin of the last full call
+    bool bValid;                            ///< Configuration written, a rearm writes the alarm time only
+} stc_amx8x5_alarm_config_t;
+
+/**
+ ******************************************************************************
+ ** \brief Software alarm callback
+ **
+ ** \param pstcHandle   RTC Handle
+ ** \param u8Id         ID used with Amx8x5_SwAlarmStart()
+ ** \param u32Deadline  Deadline in seconds since 2000-01-01 00:00:00
+ **
+ ******************************************************************************/
+typedef void (*pfn_amx8x5_swalarm_callback)(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Id, uint32_t u32Deadline);
+
+/**
+ ******************************************************************************
+ ** \brief Software alarm entry
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_swalarm_entry
+{
+    uint32_t u32Deadline;                     ///< Seconds since 2000-01-01 00:00:00
+    pfn_amx8x5_swalarm_callback pfnCallback;  ///< Called when the deadline is reached
+    uint8_t u8Id;                             ///< Application defined ID
+} stc_amx8x5_swalarm_entry_t;
+
+/**
+ ******************************************************************************
+ ** \brief Software alarms multiplexed onto the hardware alarm
+ **
+ ** astcHeap is a min-heap ordered by deadline, astcHeap[0] is the earliest.
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_swalarm
+{
+    stc_amx8x5_swalarm_entry_t astcHeap[AMX8X5_SWALARM_MAX]; ///< Active alarms
+    uint8_t u8Count;                                         ///< Number of active alarms
+    uint32_t u32Armed;                                       ///< Target of the hardware alarm, 0 if disabled
+    en_amx8x5_interrupt_mode_t enModeIrq;                    ///< Interrupt mode of the hardware alarm
+    en_amx8x5_interrupt_pin_t enModePin;                     ///< Interrupt pin of the hardware alarm
+    stc_amx8x5_alarm_config_t stcConfig;                     ///< Hardware alarm configuration, see Amx8x5_AlarmRearm()
+    bool bServicing;                                         ///< Callbacks running, start / stop leave arming to Amx8x5_SwAlarmService()
+} stc_amx8x5_swalarm_t;
+
+/**
+ ******************************************************************************
+ ** \brief Cron-like schedule, bit n of a field set means value n matches
+ **
+ ** A time matches if all fields match (date and weekday are combined by
+ ** AND). Weekday 0 is Sunday, as set by Amx8x5_SecondsToTime().
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_schedule
+{
+    uint64_t u64Minute;  ///< Minutes 0..59
+    uint32_t u32Hour;    ///< Hours 0..23
+    uint32_t u32Date;    ///< Days of month 1..31
+    uint16_t u16Month;   ///< Months 1..12
+    uint8_t u8Weekday;   ///< Weekdays 0..6
+} stc_amx8x5_schedule_t;
+
+/**
+ ******************************************************************************
+ ** \brief Periodic alarm started by Amx8x5_SubSecondAlarmStart()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_subsecond_alarm
+{
+    uint16_t u16Period;   ///< Hundredths between matches
+    uint16_t u16Target;   ///< Armed match, hundredths within the minute (0..5999)
+    bool bSoftware;       ///< Rearmed by Amx8x5_SubSecondAlarmService(), else repeated by the RTC
+} stc_amx8x5_subsecond_alarm_t;
+
+/**
+ ******************************************************************************
+ ** \brief Countdown prepared by Amx8x5_CountdownPrepare()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_countdown
+{
+    uint8_t u8TimerCtrl;  ///< TIMER_CTRL incl. TE and the RPT bits at prepare time
+    uint8_t au8Timer[2];  ///< TIMER, TIMER_INITIAL
+    bool bStarted;        ///< Started by Amx8x5_CountdownStart(), rearm reloads TIMER only
+} stc_amx8x5_countdown_t;
+
+/**
+ ******************************************************************************
+ ** \brief Watchdog prepared by Amx8x5_WatchdogPrepare()
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_watchdog
+{
+    uint8_t u8Wdt;        ///< WDT register value written by every kick
+} stc_amx8x5_watchdog_t;
+
+/**
+ ******************************************************************************
+ ** \brief Task supervision on the RTC watchdog, see Amx8x5_TaskWdtService()
+ **
+ ** Check-ins are single byte stores, safe from any task or ISR without a lock.
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_taskwdt
+{
+    stc_amx8x5_watchdog_t stcWatchdog;               ///< RTC watchdog resetting via nRST
+    pfn_amx8x5_micros pfnClock;                      ///< Time base of deadlines and kick interval (e.g. millis)
+    uint32_t au32Deadline[AMX8X5_TASKWDT_MAX];       ///< Max. time between check-ins per task, 0 = not registered
+    uint32_t au32Last[AMX8X5_TASKWDT_MAX];           ///< Time the service saw the last check-in
+    volatile uint8_t au8CheckIn[AMX8X5_TASKWDT_MAX]; ///< Set by Amx8x5_TaskWdtCheckIn(), cleared by the service
+    uint32_t u32KickInterval;                        ///< Min. time between kicks
+    uint32_t u32LastKick;                            ///< Time of the last kick
+    uint8_t u8RamAddress;                            ///< RTC RAM address of the starved task record
+    uint8_t u8Xadd;                                  ///< EXTENDED_ADDR value selecting the RAM bank of the record
+    uint8_t u8Culprit;                               ///< Starved task, #AMX8X5_TASKWDT_NONE if none
+} stc_amx8x5_taskwdt_t;
+
+/**
+ ******************************************************************************
+ ** \brief Sequence of countdown intervals on the 4096 Hz range
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_sequence
+{
+    const uint8_t* pu8Timer;  ///< TIMER values (counts - 1), see Amx8x5_SequenceEncode()
+    uint16_t u16Length;       ///< Number of intervals
+    uint16_t u16Next;         ///< Next interval to stage, u16Length + 1 when done
+    uint8_t u8TimerCtrl;      ///< TIMER_CTRL while playing
+} stc_amx8x5_sequence_t;
+
+/**
+ ******************************************************************************
+ ** \brief Tickless idle timebase on the countdown timer
+ **
+ ******************************************************************************/
+typedef struct stc_amx8x5_tickless
+{
+    uint32_t u32TickHz;    ///< OS tick frequency
+    uint32_t u32Units;     ///< Length of one count of the armed sleep in 1/4096 s
+    uint16_t u16Fraction;  ///< Elapsed time not yet reported, in 1/4096 tick
+    uint16_t u16Period;    ///< 1 Hz / 1/60 Hz range: one count in 1/100 s, else 0
+    uint16_t u16Phase;     ///< 1 Hz / 1/60 Hz range: position in the count at sleep start in 1/100 s
+    uint8_t u8Timer;       ///< TIMER value of the armed sleep (counts - 1)
+    uint8_t u8Start;       ///< 1 Hz / 1/60 Hz range: TIMER at sleep start
+    bool bArmed;           ///< Sleep started, Amx8x5_TicklessWake() pending
+} stc_amx8x5_tickless_t;
+
 
 
 /*****************************************************************************/
@@ -2821,6 +3480,7 @@ extern stc_amx8x5_time_t stcSysTime;
 en_result_t Amx8x5_Init(stc_amx8x5_handle_t* pstcHandle);
 en_result_t Amx8x5_Reset(stc_amx8x5_handle_t* pstcHandle);
 en_result_t Amx8x5_GetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t** ppstcTime);
+en_result_t Amx8x5_GetTimePrecise(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_precise_t* pstcPreciseTime, pfn_amx8x5_micros pfnMicros, bool bWaitEdge);
 int16_t Amx8x5_GetHundredth(stc_amx8x5_handle_t* pstcHandle);
 int16_t Amx8x5_GetSecond(stc_amx8x5_handle_t* pstcHandle);
 int16_t Amx8x5_GetMinute(stc_amx8x5_handle_t* pstcHandle);
@@ -2830,11 +3490,30 @@ int16_t Amx8x5_GetWeekday(stc_amx8x5_handle_t* pstcHandle);
 int16_t Amx8x5_GetMonth(stc_amx8x5_handle_t* pstcHandle);
 int16_t Amx8x5_GetYear(stc_amx8x5_handle_t* pstcHandle);
 int16_t Amx8x5_GetCentury(stc_amx8x5_handle_t* pstcHandle);
+en_result_t Amx8x5_TimeToSeconds(stc_amx8x5_time_t* pstcTime, uint32_t* pu32Seconds);
+en_result_t Amx8x5_SecondsToTime(uint32_t u32Seconds, stc_amx8x5_time_t* pstcTime);
+en_result_t Amx8x5_GetSeconds(stc_amx8x5_handle_t* pstcHandle, uint32_t* pu32Seconds);
 
 en_result_t Amx8x5_SetTime(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, bool bProtect);
+en_result_t Amx8x5_SetTimePrecise(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, bool bProtect, pfn_amx8x5_wait_edge pfnWaitEdge, pfn_amx8x5_micros pfnMicros, uint32_t* pu32LatencyUs);
 en_result_t Amx8x5_SetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_calibration_mode_t enMode, int32_t iAdjust);
+en_result_t Amx8x5_CalibrationEncode(en_amx8x5_calibration_mode_t enMode, int32_t iAdjust, uint8_t* pu8Reg);
+int32_t Amx8x5_CalibrationDecode(en_amx8x5_calibration_mode_t enMode, const uint8_t* pu8Reg);
+en_result_t Amx8x5_GetCalibrationValue(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_calibration_mode_t enMode, int32_t* pi32Ppb);
 en_result_t Amx8x5_SetAlarm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin);
+en_result_t Amx8x5_AlarmInit(stc_amx8x5_alarm_config_t* pstcConfig);
+en_result_t Amx8x5_AlarmRearm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_alarm_config_t* pstcConfig, stc_amx8x5_time_t* pstcTime, en_amx8x5_alarm_repeat_t enModeRepeat, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin);
 en_result_t Amx8x5_Stop(stc_amx8x5_handle_t* pstcHandle, bool bStop);
+en_result_t Amx8x5_SwAlarmInit(stc_amx8x5_swalarm_t* pstcSwAlarm, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin);
+en_result_t Amx8x5_SwAlarmStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Id, uint32_t u32Deadline, pfn_amx8x5_swalarm_callback pfnCallback);
+en_result_t Amx8x5_SwAlarmStop(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t u8Id);
+en_result_t Amx8x5_SwAlarmService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_swalarm_t* pstcSwAlarm, uint8_t* pu8Fired);
+en_result_t Amx8x5_ScheduleInit(stc_amx8x5_schedule_t* pstcSchedule);
+en_result_t Amx8x5_ScheduleNext(stc_amx8x5_schedule_t* pstcSchedule, uint32_t u32Now, uint32_t* pu32Next);
+en_result_t Amx8x5_ScheduleToAlarm(stc_amx8x5_schedule_t* pstcSchedule, stc_amx8x5_time_t* pstcAlarm, en_amx8x5_alarm_repeat_t* penRepeat);
+en_result_t Amx8x5_ScheduleArm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_schedule_t* pstcSchedule, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin, uint32_t* pu32Next, bool* pbHardwareRepeat);
+en_result_t Amx8x5_SubSecondAlarmStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_subsecond_alarm_t* pstcAlarm, uint16_t u16Period, en_amx8x5_interrupt_mode_t enModeIrq, en_amx8x5_interrupt_pin_t enModePin);
+en_result_t Amx8x5_SubSecondAlarmService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_subsecond_alarm_t* pstcAlarm, bool* pbRearmed);
 
 en_result_t Amx8x5_CtrlOutB(stc_amx8x5_handle_t* pstcHandle, bool bOnOff);
 en_result_t Amx8x5_CtrlOut(stc_amx8x5_handle_t* pstcHandle, bool bOnOff);
@@ -2855,22 +3534,73 @@ en_result_t Amx8x5_GetAnalogStatus(stc_amx8x5_handle_t* pstcHandle, uint8_t* pu8
 en_result_t Amx8x5_SetBatmodeIO(stc_amx8x5_handle_t* pstcHandle, bool bIoEnabled);
 en_result_t Amx8x5_EnableTrickleCharger(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_trickle_diode_t enDiode, en_amx8x5_trickle_resistor_t enResistor, bool bEnable);
 en_result_t Amx8x5_SetBatteryReferenceVoltage(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_bat_reference_t enBref);
+en_result_t Amx8x5_BatteryEstimate(stc_amx8x5_handle_t* pstcHandle, uint8_t* pu8Level, uint16_t* pu16MinMv, uint16_t* pu16MaxMv);
+en_result_t Amx8x5_BatteryInit(stc_amx8x5_battery_t* pstcBattery, uint32_t u32Period);
+en_result_t Amx8x5_BatteryService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_battery_t* pstcBattery, uint32_t u32Now, bool* pbChanged);
+en_result_t Amx8x5_TrickleInit(stc_amx8x5_trickle_policy_t* pstcPolicy, uint8_t u8FullLevel, uint32_t u32BoostSeconds);
+en_result_t Amx8x5_TrickleService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_trickle_policy_t* pstcPolicy, uint8_t u8Level, uint32_t u32Now, bool* pbWritten);
+en_result_t Amx8x5_PowerFailInit(stc_amx8x5_powerfail_t* pstcPowerFail, uint8_t u8RamAddress);
+en_result_t Amx8x5_PowerFailRecover(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail, stc_amx8x5_outage_t* pstcOutage);
+en_result_t Amx8x5_PowerFailArm(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail, en_amx8x5_bat_reference_t enBref);
+en_result_t Amx8x5_PowerFailRecord(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_powerfail_t* pstcPowerFail);
+en_result_t Amx8x5_HeartbeatInit(stc_amx8x5_heartbeat_t* pstcHeartbeat, uint8_t u8RamAddress, uint32_t u32Interval);
+en_result_t Amx8x5_LastShutdownInfo(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_heartbeat_t* pstcHeartbeat, stc_amx8x5_shutdown_info_t* pstcInfo);
+en_result_t Amx8x5_HeartbeatService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_heartbeat_t* pstcHeartbeat, uint32_t u32Now, bool* pbWritten);
 
 en_result_t Amx8x5_EnableInterrupt(stc_amx8x5_handle_t* pstcHandle, uint8_t u8IrqMask);
 en_result_t Amx8x5_DisableInterrupt(stc_amx8x5_handle_t* pstcHandle, uint8_t u8IrqMask);
 en_result_t Amx8x5_ClearInterrupts(stc_amx8x5_handle_t* pstcHandle);
 en_result_t Amx8x5_ClearInterrupt(stc_amx8x5_handle_t* pstcHandle,uint8_t u8IrqMask);
 en_result_t Amx8x5_GetInterruptStatus(stc_amx8x5_handle_t* pstcHandle, uint8_t* pu8Status);
+en_result_t Amx8x5_IrqDispatcherInit(stc_amx8x5_irq_dispatcher_t* pstcDispatcher);
+en_result_t Amx8x5_IrqDispatcherRegister(stc_amx8x5_irq_dispatcher_t* pstcDispatcher, en_amx8x5_irq_source_t enSource, pfn_amx8x5_irq_callback pfnCallback);
+en_result_t Amx8x5_IrqDispatch(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_irq_dispatcher_t* pstcDispatcher, uint8_t* pu8Serviced);
+en_result_t Amx8x5_OscHealthInit(stc_amx8x5_osc_health_t* pstcHealth, en_amx8x5_osc_health_policy_t enPolicy, uint8_t u8Threshold, pfn_amx8x5_osc_health_alert pfnAlert, pfn_amx8x5_micros pfnClock);
+en_result_t Amx8x5_OscHealthSample(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_osc_health_t* pstcHealth, uint8_t u8OscStatus, uint8_t* pu8Failures);
+en_result_t Amx8x5_EventQueueInit(stc_amx8x5_event_queue_t* pstcQueue);
+en_result_t Amx8x5_EventQueuePush(stc_amx8x5_event_queue_t* pstcQueue, uint32_t u32Timestamp, uint8_t u8Pin);
+en_result_t Amx8x5_EventQueuePop(stc_amx8x5_event_queue_t* pstcQueue, stc_amx8x5_event_t* pstcEvent);
+en_result_t Amx8x5_EventQueueDispatch(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_event_queue_t* pstcQueue, stc_amx8x5_irq_dispatcher_t* pstcDispatcher, stc_amx8x5_event_t* pstcLastEvent, uint8_t* pu8Serviced);
 
 en_result_t Amx8x5_SetWatchdog(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin);
+en_result_t Amx8x5_WatchdogPrepare(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_watchdog_t* pstcWatchdog, uint32_t u32Period, en_amx8x5_watchdog_interrupt_pin_t enPin);
+en_result_t Amx8x5_WatchdogKick(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_watchdog_t* pstcWatchdog);
+en_result_t Amx8x5_TaskWdtInit(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8RamAddress, pfn_amx8x5_micros pfnClock);
+en_result_t Amx8x5_TaskWdtRegister(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8Task, uint32_t u32Deadline);
+en_result_t Amx8x5_TaskWdtStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_taskwdt_t* pstcTaskWdt, uint32_t u32Period, uint32_t u32KickInterval);
+en_result_t Amx8x5_TaskWdtCheckIn(stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t u8Task);
+en_result_t Amx8x5_TaskWdtService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_taskwdt_t* pstcTaskWdt, uint8_t* pu8Culprit);
+en_result_t Amx8x5_TaskWdtCulprit(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, uint8_t* pu8Task);
 en_result_t Amx8x5_SetSleepMode(stc_amx8x5_handle_t* pstcHandle, uint8_t ui8Timeout, en_amx8x5_sleep_mode_t enMode);
+en_result_t Amx8x5_SleepUntil(stc_amx8x5_handle_t* pstcHandle, uint32_t u32Deadline, uint8_t u8WakeSources, uint8_t u8Timeout, en_amx8x5_sleep_mode_t enMode);
+en_result_t Amx8x5_WakeReason(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_wake_reason_t* pstcReason);
 en_result_t Amx8x5_GetExtensionAddress(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address, uint8_t* pu8ExtensionAddress);
 en_result_t Amx8x5_SetSquareWaveOutput(stc_amx8x5_handle_t* pstcHandle, uint8_t u8SQFS, uint8_t u8PinMsk);
 en_result_t Amx8x5_SelectOscillatorMode(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_osc_select_t enSelect);
 en_result_t Amx8x5_SetCountdown(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin);
+en_result_t Amx8x5_CountdownPrepare(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown, en_amx8x5_periode_range_t enRange, int32_t iPeriod, en_amx8x5_countdown_interrupt_output_t enRepeat, en_amx8x5_countdown_interrupt_pin_t enPin);
+en_result_t Amx8x5_CountdownStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown);
+en_result_t Amx8x5_CountdownStop(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_countdown_t* pstcCountdown);
+en_result_t Amx8x5_SequenceEncode(const uint32_t* pu32Us, uint8_t* pu8Timer, uint16_t u16Length);
+en_result_t Amx8x5_SequenceInit(stc_amx8x5_sequence_t* pstcSequence, const uint8_t* pu8Timer, uint16_t u16Length);
+en_result_t Amx8x5_SequenceStart(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_sequence_t* pstcSequence, en_amx8x5_countdown_interrupt_pin_t enPin);
+en_result_t Amx8x5_SequenceService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_sequence_t* pstcSequence, bool* pbDone);
+en_result_t Amx8x5_TicklessInit(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t u32TickHz, en_amx8x5_countdown_interrupt_pin_t enPin);
+en_result_t Amx8x5_TicklessSleep(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t u32Ticks, uint32_t* pu32Ticks);
+en_result_t Amx8x5_TicklessWake(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tickless_t* pstcTickless, uint32_t* pu32Ticks);
+en_result_t Amx8x5_DriftInit(stc_amx8x5_drift_t* pstcDrift, en_amx8x5_calibration_mode_t enMode, int32_t i32AppliedPpm, uint8_t u8RamAddress);
+en_result_t Amx8x5_DriftRestore(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_drift_t* pstcDrift);
+en_result_t Amx8x5_DriftAddSample(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_drift_t* pstcDrift, uint32_t u32RefSeconds, int32_t i32OffsetUs, bool* pbApplied);
+en_result_t Amx8x5_TempCompInit(stc_amx8x5_tempcomp_t* pstcTempComp, const int16_t* pi16Ppm, uint8_t u8Count, int8_t i8StartC, uint8_t u8StepC, pfn_amx8x5_temperature pfnTemperature);
+int32_t Amx8x5_TempCompDeviation(stc_amx8x5_tempcomp_t* pstcTempComp, int16_t i16Temperature);
+en_result_t Amx8x5_TempCompService(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_tempcomp_t* pstcTempComp, bool* pbWritten);
 en_result_t Amx8x5_SetAutocalibration(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_autocalibration_period_t enPeriod);
 en_result_t Amx8x5_RamRead(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address, uint8_t* pu8Data);
 en_result_t Amx8x5_RamWrite(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Address, uint8_t u8Data);
+en_result_t Amx8x5_SaveState(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_state_t* pstcState);
+en_result_t Amx8x5_RestoreState(stc_amx8x5_handle_t* pstcHandle, stc_amx8x5_state_t* pstcState);
+en_result_t Amx8x5_CheckWarmBoot(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress, bool* pbWarmBoot);
+en_result_t Amx8x5_SaveConfigFingerprint(stc_amx8x5_handle_t* pstcHandle, uint8_t u8RamAddress);
 
 en_result_t Amx8x5_EnableOutput(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Mask, bool bEnable);
 en_result_t Amx8x5_ClearRegister(stc_amx8x5_handle_t*, uint8_t u8Address, uint8_t u8Mask);
@@ -2893,6 +3623,38 @@ class AMx8x5
   {
     public:
       typedef stc_amx8x5_time_t stcTime;
+      typedef stc_amx8x5_state_t stcState;
+      typedef en_amx8x5_irq_source_t enIrqSource;
+      typedef pfn_amx8x5_irq_callback pfnIrqCallback;
+      typedef stc_amx8x5_event_t stcEvent;
+      typedef stc_amx8x5_event_queue_t stcEventQueue;
+      typedef stc_amx8x5_alarm_config_t stcAlarmConfig;
+      typedef stc_amx8x5_swalarm_t stcSwAlarm;
+      typedef pfn_amx8x5_swalarm_callback pfnSwAlarmCallback;
+      typedef stc_amx8x5_schedule_t stcSchedule;
+      typedef stc_amx8x5_subsecond_alarm_t stcSubSecondAlarm;
+      typedef stc_amx8x5_countdown_t stcCountdown;
+      typedef stc_amx8x5_watchdog_t stcWatchdog;
+      typedef stc_amx8x5_taskwdt_t stcTaskWdt;
+      typedef stc_amx8x5_sequence_t stcSequence;
+      typedef stc_amx8x5_tickless_t stcTickless;
+      typedef pfn_amx8x5_micros pfnMicros;
+      typedef pfn_amx8x5_wait_edge pfnWaitEdge;
+      typedef stc_amx8x5_time_precise_t stcTimePrecise;
+      typedef stc_amx8x5_drift_t stcDrift;
+      typedef stc_amx8x5_tempcomp_t stcTempComp;
+      typedef pfn_amx8x5_temperature pfnTemperature;
+      typedef stc_amx8x5_osc_health_t stcOscHealth;
+      typedef en_amx8x5_osc_health_policy_t enOscHealthPolicy;
+      typedef pfn_amx8x5_osc_health_alert pfnOscHealthAlert;
+      typedef stc_amx8x5_battery_t stcBattery;
+      typedef stc_amx8x5_trickle_policy_t stcTricklePolicy;
+      typedef stc_amx8x5_wake_reason_t stcWakeReason;
+      typedef stc_amx8x5_powerfail_t stcPowerFail;
+      typedef stc_amx8x5_outage_t stcOutage;
+      typedef stc_amx8x5_heartbeat_t stcHeartbeat;
+      typedef stc_amx8x5_shutdown_info_t stcShutdownInfo;
+      typedef void (*pfnServiceWork)(AMx8x5* pRtc); ///< deferred work, see defer()
       typedef en_amx8x5_calibration_mode_t enCalibrationMode;
       typedef en_amx8x5_alarm_repeat_t enAlarmRepeat;
       typedef en_amx8x5_interrupt_mode_t enInterruptMode;
@@ -2920,6 +3682,7 @@ class AMx8x5
         stcRtcConfig.enRtcType = AMx8x5Type1805;
         stcRtcConfig.pHandle = (void*)-1;
         stcRtcConfig.u32Address = 0x69;
+        initState();
       }
 
       /**
@@ -2944,6 +3707,7 @@ class AMx8x5
         stcRtcConfig.enRtcType = enType;
         stcRtcConfig.pHandle = (void*)-1;
         stcRtcConfig.u32Address = 0x69;
+        initState();
       }
 
       /**
@@ -2969,6 +3733,7 @@ class AMx8x5
         stcRtcConfig.enRtcType = enType;
         stcRtcConfig.pHandle = pHandle;
         stcRtcConfig.u32Address = 0x69;
+        initState();
       }
 
       AMx8x5(AMx8x5::enCommunicationMode enMode)
@@ -2977,6 +3742,7 @@ class AMx8x5
         stcRtcConfig.enRtcType = AMx8x5Type1805;
         stcRtcConfig.pHandle = (void*)-1;
         stcRtcConfig.u32Address = 0x69;
+        initState();
       }
 
       /**
@@ -2984,6 +3750,13 @@ class AMx8x5
       * @return whether success.
       */
       bool begin(void);
+      /**
+      * @brief Enable RTC and detect a warm boot
+      * @param pbWarmBoot returns true if the RTC kept the configuration stored by saveConfigFingerprint()
+      * @param u8RamAddress RTC RAM address of the fingerprint
+      * @return whether success.
+      */
+      bool begin(bool* pbWarmBoot, uint8_t u8RamAddress = AMX8X5_RAM_FINGERPRINT);
       #if defined(AMX8X5_SPI_AVAILABLE) || defined(SPI_H) || defined(_SPI_H_INCLUDED) || defined(SPI_H_) || \
           defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_ARCH_MEGAAVR) || \
           defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32) || \
@@ -2995,11 +3768,31 @@ class AMx8x5
 
       bool end(void);
 
-      void update(void);
+      /**
+      * @brief Service routine, call from loop()
+      *
+      * Returns without bus access unless notifyInterrupt() was called or
+      * work was deferred. Otherwise dispatches pending interrupts to the
+      * callbacks registered with onInterrupt() and runs the deferred work.
+      * @return Ok, else the Error of the dispatch, the interrupt stays pending
+      */
+      AMx8x5::enResult update(void);
+
+      /**
+      * @brief Signal a pending RTC interrupt, safe to call from the nIRQ pin ISR
+      */
+      void notifyInterrupt(void);
+
+      /**
+      * @brief Run @p pfnWork once at the next update(), call from task context
+      * @return false if AMX8X5_DEFERRED_WORK_MAX work items are pending
+      */
+      bool defer(AMx8x5::pfnServiceWork pfnWork);
 
       AMx8x5::enResult init(AMx8x5::stcHandle* pstcHandle);
       AMx8x5::enResult reset(void);
       AMx8x5::enResult getTime(AMx8x5::stcTime** ppstcTime);
+      AMx8x5::enResult getTimePrecise(AMx8x5::stcTimePrecise* pstcPreciseTime, AMx8x5::pfnMicros pfnMicros, bool bWaitEdge = false);
       int16_t getHundredth(void);
       int16_t getSecond(void);
       int16_t getMinute(void);
@@ -3009,9 +3802,19 @@ class AMx8x5
       int16_t getMonth(void);
       int16_t getYear(void);
       AMx8x5::enResult setTime(AMx8x5::stcTime* pstcTime, bool bProtect);
+      AMx8x5::enResult setTimePrecise(AMx8x5::stcTime* pstcTime, bool bProtect, AMx8x5::pfnWaitEdge pfnWaitEdge, AMx8x5::pfnMicros pfnMicros, uint32_t* pu32LatencyUs = NULL);
       AMx8x5::enResult setCalibrationValue(AMx8x5::enCalibrationMode enMode, int32_t iAdjust);
+      AMx8x5::enResult getCalibrationValue(AMx8x5::enCalibrationMode enMode, int32_t* pi32Ppb);
       AMx8x5::enResult setAlarm(AMx8x5::stcTime* pstcTime, AMx8x5::enAlarmRepeat enModeRepeat, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin);
+      AMx8x5::enResult alarmRearm(AMx8x5::stcAlarmConfig* pstcConfig, AMx8x5::stcTime* pstcTime, AMx8x5::enAlarmRepeat enModeRepeat, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin);
       AMx8x5::enResult stop(bool bStop);
+      AMx8x5::enResult getSeconds(uint32_t* pu32Seconds);
+      AMx8x5::enResult swAlarmStart(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t u8Id, uint32_t u32Deadline, AMx8x5::pfnSwAlarmCallback pfnCallback);
+      AMx8x5::enResult swAlarmStop(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t u8Id);
+      AMx8x5::enResult swAlarmService(AMx8x5::stcSwAlarm* pstcSwAlarm, uint8_t* pu8Fired = NULL);
+      AMx8x5::enResult scheduleArm(AMx8x5::stcSchedule* pstcSchedule, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin, uint32_t* pu32Next = NULL, bool* pbHardwareRepeat = NULL);
+      AMx8x5::enResult subSecondAlarmStart(AMx8x5::stcSubSecondAlarm* pstcAlarm, uint16_t u16Period, AMx8x5::enInterruptMode enModeIrq, AMx8x5::enInterruptPin enModePin);
+      AMx8x5::enResult subSecondAlarmService(AMx8x5::stcSubSecondAlarm* pstcAlarm, bool* pbRearmed = NULL);
 
       AMx8x5::enResult ctrlOutB(bool bOnOff);
       AMx8x5::enResult ctrlOut(bool bOnOff);
@@ -3032,24 +3835,58 @@ class AMx8x5
       AMx8x5::enResult setBatmodeIO(bool bIoEnabled);
       AMx8x5::enResult enableTrickleCharger(AMx8x5::enTrickleDiode enDiode, AMx8x5::enTrickleResistor enResistor, bool bEnable);
       AMx8x5::enResult setBatteryReferenceVoltage(AMx8x5::enBatReference enBref);
+      AMx8x5::enResult batteryEstimate(uint8_t* pu8Level, uint16_t* pu16MinMv = NULL, uint16_t* pu16MaxMv = NULL);
+      AMx8x5::enResult batteryService(AMx8x5::stcBattery* pstcBattery, uint32_t u32Now, bool* pbChanged = NULL);
+      AMx8x5::enResult trickleService(AMx8x5::stcTricklePolicy* pstcPolicy, uint8_t u8Level, uint32_t u32Now, bool* pbWritten = NULL);
+      AMx8x5::enResult powerFailRecover(AMx8x5::stcPowerFail* pstcPowerFail, AMx8x5::stcOutage* pstcOutage);
+      AMx8x5::enResult powerFailArm(AMx8x5::stcPowerFail* pstcPowerFail, AMx8x5::enBatReference enBref);
+      AMx8x5::enResult powerFailRecord(AMx8x5::stcPowerFail* pstcPowerFail);
+      AMx8x5::enResult lastShutdownInfo(AMx8x5::stcHeartbeat* pstcHeartbeat, AMx8x5::stcShutdownInfo* pstcInfo);
+      AMx8x5::enResult heartbeatService(AMx8x5::stcHeartbeat* pstcHeartbeat, uint32_t u32Now, bool* pbWritten = NULL);
 
       AMx8x5::enResult enableInterrupt(uint8_t u8IrqMask);
       AMx8x5::enResult disableInterrupt(uint8_t u8IrqMask);
       AMx8x5::enResult clearInterrupts(void);
       AMx8x5::enResult clearInterrupt(uint8_t u8IrqMask);
       AMx8x5::enResult getInterruptStatus(uint8_t* pu8Status);
+      AMx8x5::enResult onInterrupt(AMx8x5::enIrqSource enSource, AMx8x5::pfnIrqCallback pfnCallback);
+      AMx8x5::enResult dispatchInterrupts(uint8_t* pu8Serviced = NULL);
+      AMx8x5::enResult monitorOscHealth(AMx8x5::stcOscHealth* pstcHealth);
+      AMx8x5::enResult dispatchEvents(AMx8x5::stcEventQueue* pstcQueue, uint8_t* pu8Serviced = NULL);
 
 
       AMx8x5::enResult setWatchdog(uint32_t u32Period, AMx8x5::enWatchdogInterruptPin enPin);
+      AMx8x5::enResult watchdogPrepare(AMx8x5::stcWatchdog* pstcWatchdog, uint32_t u32Period, AMx8x5::enWatchdogInterruptPin enPin);
+      AMx8x5::enResult watchdogKick(AMx8x5::stcWatchdog* pstcWatchdog);
+      AMx8x5::enResult taskWdtStart(AMx8x5::stcTaskWdt* pstcTaskWdt, uint32_t u32Period, uint32_t u32KickInterval);
+      AMx8x5::enResult taskWdtService(AMx8x5::stcTaskWdt* pstcTaskWdt, uint8_t* pu8Culprit = NULL);
+      AMx8x5::enResult taskWdtCulprit(uint8_t* pu8Task, uint8_t u8RamAddress = AMX8X5_RAM_TASKWDT);
       AMx8x5::enResult setSleepMode(uint8_t ui8Timeout, AMx8x5::enSleepMode enMode);
+      AMx8x5::enResult sleepUntil(uint32_t u32Deadline, uint8_t u8WakeSources, uint8_t u8Timeout, AMx8x5::enSleepMode enMode);
+      AMx8x5::enResult wakeReason(AMx8x5::stcWakeReason* pstcReason);
       AMx8x5::enResult getExtensionAddress(uint8_t u8Address, uint8_t* pu8ExtensionAddress);
       AMx8x5::enResult enableOutput(uint8_t u8Mask, bool bEnable);
       AMx8x5::enResult setSquareWaveOutput(uint8_t u8SQFS, uint8_t u8PinMsk);
       AMx8x5::enResult selectOscillatorMode(AMx8x5::enOscSelect enSelect);
       AMx8x5::enResult setCountdown(AMx8x5::enPeriodeRange enRange, int32_t iPeriod, AMx8x5::enCountdownInterruptOutput enRepeat, AMx8x5::enCountdownInterruptPin enPin);
+      AMx8x5::enResult countdownPrepare(AMx8x5::stcCountdown* pstcCountdown, AMx8x5::enPeriodeRange enRange, int32_t iPeriod, AMx8x5::enCountdownInterruptOutput enRepeat, AMx8x5::enCountdownInterruptPin enPin);
+      AMx8x5::enResult countdownStart(AMx8x5::stcCountdown* pstcCountdown);
+      AMx8x5::enResult countdownStop(AMx8x5::stcCountdown* pstcCountdown);
+      AMx8x5::enResult sequenceStart(AMx8x5::stcSequence* pstcSequence, AMx8x5::enCountdownInterruptPin enPin);
+      AMx8x5::enResult sequenceService(AMx8x5::stcSequence* pstcSequence, bool* pbDone = NULL);
+      AMx8x5::enResult ticklessInit(AMx8x5::stcTickless* pstcTickless, uint32_t u32TickHz, AMx8x5::enCountdownInterruptPin enPin);
+      AMx8x5::enResult ticklessSleep(AMx8x5::stcTickless* pstcTickless, uint32_t u32Ticks, uint32_t* pu32Ticks = NULL);
+      AMx8x5::enResult ticklessWake(AMx8x5::stcTickless* pstcTickless, uint32_t* pu32Ticks);
+      AMx8x5::enResult driftRestore(AMx8x5::stcDrift* pstcDrift);
+      AMx8x5::enResult driftAddSample(AMx8x5::stcDrift* pstcDrift, uint32_t u32RefSeconds, int32_t i32OffsetUs, bool* pbApplied = NULL);
+      AMx8x5::enResult tempCompService(AMx8x5::stcTempComp* pstcTempComp, bool* pbWritten = NULL);
       AMx8x5::enResult setAutocalibration(AMx8x5::enAutocalibrationPeriod enPeriod);
       AMx8x5::enResult ramRead(uint8_t u8Address, uint8_t* pu8Data);
       AMx8x5::enResult ramWrite(uint8_t u8Address, uint8_t u8Data);
+      AMx8x5::enResult saveState(AMx8x5::stcState* pstcState);
+      AMx8x5::enResult restoreState(AMx8x5::stcState* pstcState);
+      AMx8x5::enResult checkWarmBoot(bool* pbWarmBoot, uint8_t u8RamAddress = AMX8X5_RAM_FINGERPRINT);
+      AMx8x5::enResult saveConfigFingerprint(uint8_t u8RamAddress = AMX8X5_RAM_FINGERPRINT);
       AMx8x5::enResult clearRegister(uint8_t u8Address, uint8_t u8Mask);
       AMx8x5::enResult setRegister(uint8_t u8Address, uint8_t u8Mask);
       AMx8x5::enResult readByte(uint8_t u8Register, uint8_t* pu8Value);
@@ -3058,7 +3895,13 @@ class AMx8x5
       AMx8x5::enResult writeBytes(uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Length);
 
     private:
+      void initState(void);
+
       AMx8x5::stcHandle stcRtcConfig;
+      stc_amx8x5_irq_dispatcher_t stcIrqDispatcher;
+      volatile bool bIrqPending;
+      uint8_t u8DeferredCount;
+      AMx8x5::pfnServiceWork apfnDeferred[AMX8X5_DEFERRED_WORK_MAX];
   };
 
 
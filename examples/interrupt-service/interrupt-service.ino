@@ -0,0 +1,75 @@
+#include <amx8x5.h>
+#include <Wire.h>
+
+// This example services RTC interrupts from loop() without polling the bus.
+// The FOUT/nIRQ pin of the RTC is connected to an MCU interrupt pin, the ISR
+// only calls rtc.notifyInterrupt(). rtc.update() in loop() returns without
+// any I2C transfer until the ISR fired, then reads STATUS once, clears the
+// flags and calls the registered callbacks.
+//
+// Pin assignment (adapt to your board):
+//   FOUT/nIRQ -> RTC_IRQ_PIN (open drain, internal pull-up enabled)
+
+#define RTC_IRQ_PIN   2    // <-- adapt to your board
+
+AM1805 rtc;
+stc_amx8x5_time_t* pMyTime;
+
+void rtcIsr(void)
+{
+    rtc.notifyInterrupt();
+}
+
+void onAlarm(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_irq_source_t enSource)
+{
+    rtc.getTime(&pMyTime);
+    Serial.printf("Alarm: %02d:%02d:%02d\n", pMyTime->u8Hour, pMyTime->u8Minute, pMyTime->u8Second);
+}
+
+void printUptime(AMx8x5* pRtc)
+{
+    Serial.printf("Uptime: %lu ms\n", millis());
+}
+
+void setup () {
+    Wire.begin();
+
+    Serial.begin(115200);
+    while (!rtc.begin())
+    {
+        Serial.println("RTC not initialized...");
+        delay(1000);
+    }
+
+    rtc.onInterrupt(AMx8x5IrqAlarm, onAlarm);
+
+    // alarm every second, short pulse on FOUT/nIRQ
+    rtc.getTime(&pMyTime);
+    en_result_t res = rtc.setAlarm(pMyTime,
+                                   AMx8x5::enAlarmRepeat::AMx8x5AlarmSecond,
+                                   AMx8x5::enInterruptMode::AMx8x5InterruptModePulseShort,
+                                   AMx8x5::enInterruptPin::AMx8x5InterruptIrq);
+    if (res != Ok)
+    {
+        Serial.printf("Error: Could not set the alarm... reason: %d\n", res);
+        while (1);
+    }
+
+    pinMode(RTC_IRQ_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(RTC_IRQ_PIN), rtcIsr, FALLING);
+}
+
+void loop(void)
+{
+    static unsigned long ulLast = 0;
+
+    // no bus access unless the RTC signalled an interrupt or work is deferred
+    rtc.update();
+
+    // deferred work runs with the next update() call
+    if (millis() - ulLast >= 10000)
+    {
+        ulLast = millis();
+        rtc.defer(printUptime);
+    }
+}
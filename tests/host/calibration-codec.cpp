@@ -0,0 +1,81 @@
+// AMX8X5 calibration codec test — runs on the build host, not on a board.
+//
+// Every valid XT (-610..242 ppm) and RC (-65536..65520 ppm) adjustment is
+// encoded with Amx8x5_CalibrationEncode(), decoded with
+// Amx8x5_CalibrationDecode() and compared against a double precision
+// reference of the *1000/1907 rounding and the register band step sizes.
+//
+// Build and run:
+//   make host-tests          (in tests/)
+//   ./calibration-codec
+
+// The driver is built as C (amx8x5.c), without the Arduino class.
+extern "C" {
+#include <amx8x5.h>
+}
+#include <math.h>
+#include <stdio.h>
+
+// round(ppm / 1.907) steps, truncated to the step size of the register band
+// (2^CMDR for RC, 2 with CMDX for XT), back in ppb
+static int32_t calibrationReference(en_amx8x5_calibration_mode_t enMode, int32_t iAdjust)
+{
+    double dSteps = (double)iAdjust * 1000.0 / 1907.0;
+    int32_t i32Steps = (int32_t)((dSteps < 0) ? -floor(-dSteps + 0.5) : floor(dSteps + 0.5));
+    double dUnit = 1.0;
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        if ((i32Steps > 63) || (i32Steps < -256)) dUnit = 2.0;
+    }
+    else
+    {
+        if ((i32Steps > 32767) || (i32Steps < -32768)) dUnit = 8.0;
+        else if ((i32Steps > 16383) || (i32Steps < -16384)) dUnit = 4.0;
+        else if ((i32Steps > 8191) || (i32Steps < -8192)) dUnit = 2.0;
+    }
+    return (int32_t)(floor(i32Steps / dUnit) * dUnit) * 1907;
+}
+
+static uint32_t checkRange(en_amx8x5_calibration_mode_t enMode, const char* pcName, int32_t i32Min, int32_t i32Max)
+{
+    uint8_t au8Reg[2];
+    uint32_t u32Mismatch = 0;
+    for (int32_t a = i32Min; a <= i32Max; a++)
+    {
+        if (Amx8x5_CalibrationEncode(enMode, a, au8Reg) != Ok)
+        {
+            if (u32Mismatch++ < 10) printf("FAIL: %s %ld ppm rejected\n", pcName, (long)a);
+            continue;
+        }
+        int32_t i32Ppb = Amx8x5_CalibrationDecode(enMode, au8Reg);
+        int32_t i32Ref = calibrationReference(enMode, a);
+        if (i32Ppb != i32Ref)
+        {
+            if (u32Mismatch++ < 10) printf("FAIL: %s %ld ppm: %ld ppb, expected %ld ppb\n", pcName, (long)a, (long)i32Ppb, (long)i32Ref);
+        }
+    }
+    // Just outside the limits
+    if ((Amx8x5_CalibrationEncode(enMode, i32Min - 1, au8Reg) != ErrorInvalidParameter) ||
+        (Amx8x5_CalibrationEncode(enMode, i32Max + 1, au8Reg) != ErrorInvalidParameter))
+    {
+        printf("FAIL: %s out of range value accepted\n", pcName);
+        u32Mismatch++;
+    }
+    return u32Mismatch;
+}
+
+int main()
+{
+    uint32_t u32Mismatch = 0;
+    u32Mismatch += checkRange(AMx8x5ModeCalibrateXT, "XT", AMX8X5_CALIBRATION_XT_MIN_PPM, AMX8X5_CALIBRATION_XT_MAX_PPM);
+    u32Mismatch += checkRange(AMx8x5ModeCalibrateRC, "RC", AMX8X5_CALIBRATION_RC_MIN_PPM, AMX8X5_CALIBRATION_RC_MAX_PPM);
+    if (u32Mismatch != 0)
+    {
+        printf("FAIL: %lu mismatches\n", (unsigned long)u32Mismatch);
+        return 1;
+    }
+    printf("OK: %ld XT and %ld RC adjustments match the double reference\n",
+           (long)(AMX8X5_CALIBRATION_XT_MAX_PPM - AMX8X5_CALIBRATION_XT_MIN_PPM + 1),
+           (long)(AMX8X5_CALIBRATION_RC_MAX_PPM - AMX8X5_CALIBRATION_RC_MIN_PPM + 1));
+    return 0;
+}
@@ -0,0 +1,173 @@
+// AMX8X5 drift estimator test — runs on the build host, not on a board.
+//
+// A synthetic RTC with a known frequency error is sampled against a perfect
+// reference (XT hourly, RC every minute), with +/-2 ms reading noise and
+// injected outliers. The RTC runs at its error plus the calibration decoded
+// from the CAL_XT / CAL_RC registers Amx8x5_DriftAddSample() wrote, so the
+// loop is closed through the real register encoding.
+//
+// For each error the applied correction must converge to the nearest whole
+// ppm within a few steps, the remaining rate must be within one calibration
+// step and the outliers must never be applied. An error below half a step
+// is left alone. The persisted record is restored at the end.
+//
+// The errors stay clear of a half step after rounding, there either step is
+// as good and the choice is up to the noise.
+//
+// Build and run:
+//   make host-tests          (in tests/)
+//   ./drift-fit
+
+// The driver is built as C (amx8x5.c), without the Arduino class.
+extern "C" {
+#include <amx8x5.h>
+}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t au8Regs[256];
+
+static int fakeWrite(void*, uint32_t, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+{
+    for (uint32_t i = 0; i < u32Len; i++) au8Regs[(u8Register + i) & 0xFF] = pu8Data[i];
+    return 0;
+}
+
+static int fakeRead(void*, uint32_t, uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
+{
+    for (uint32_t i = 0; i < u32Len; i++) pu8Data[i] = au8Regs[(u8Register + i) & 0xFF];
+    return 0;
+}
+
+// Deterministic noise in [-u32Range, u32Range]
+static uint32_t u32NoiseState = 12345;
+static int32_t noise(uint32_t u32Range)
+{
+    u32NoiseState = u32NoiseState * 1103515245UL + 12345;
+    return (int32_t)((u32NoiseState >> 8) % (2 * u32Range + 1)) - (int32_t)u32Range;
+}
+
+// Calibration the driver wrote to the registers, in ppb
+static int32_t calibrationPpb(en_amx8x5_calibration_mode_t enMode)
+{
+    uint8_t au8Reg[2];
+    if (enMode == AMx8x5ModeCalibrateXT)
+    {
+        au8Reg[0] = au8Regs[AMX8X5_REG_CAL_XT];
+        au8Reg[1] = au8Regs[AMX8X5_REG_OSC_STATUS] >> 6;
+    }
+    else
+    {
+        au8Reg[0] = au8Regs[AMX8X5_REG_CAL_RC_HI];
+        au8Reg[1] = au8Regs[AMX8X5_REG_CAL_RC_LOW];
+    }
+    return Amx8x5_CalibrationDecode(enMode, au8Reg);
+}
+
+static int runOne(en_amx8x5_calibration_mode_t enMode, int32_t i32ErrorPpb)
+{
+    const char* pcMode = (enMode == AMx8x5ModeCalibrateXT) ? "XT" : "RC";
+    stc_amx8x5_handle_t stcHandle;
+    stc_amx8x5_drift_t stcDrift;
+    uint32_t u32Applied = 0;
+    const uint32_t u32Interval = (enMode == AMx8x5ModeCalibrateXT) ? 3600 : 60;
+    const uint32_t u32Samples = (enMode == AMx8x5ModeCalibrateXT) ? 60 * 24 : 2 * 24 * 60;
+    const bool bExpectApplied = (i32ErrorPpb > 1907 / 2) || (i32ErrorPpb < -1907 / 2);
+    int64_t i64OffsetNs = 250000000LL;   // RTC 250 ms ahead at the start
+    int32_t i32RatePpb = 0;
+    bool bApplied;
+
+    memset(au8Regs, 0, sizeof(au8Regs));
+    au8Regs[AMX8X5_REG_ID0] = 0x18;
+    au8Regs[AMX8X5_REG_ID1] = 0x05;
+    memset(&stcHandle, 0, sizeof(stcHandle));
+    stcHandle.enMode = AMx8x5ModeI2C;
+    stcHandle.enRtcType = AMx8x5Type1805;
+    stcHandle.u32Address = 0x69;
+    stcHandle.pfnWriteI2C = fakeWrite;
+    stcHandle.pfnReadI2C = fakeRead;
+    if (Amx8x5_Init(&stcHandle) != Ok)
+    {
+        printf("FAIL: init\n");
+        return 1;
+    }
+    Amx8x5_DriftInit(&stcDrift, enMode, 0, AMX8X5_RAM_DRIFT);
+
+    for (uint32_t u32Sample = 1; u32Sample <= u32Samples; u32Sample++)
+    {
+        i32RatePpb = i32ErrorPpb + calibrationPpb(enMode);
+        i64OffsetNs += (int64_t)i32RatePpb * u32Interval;
+        int32_t i32SampleUs = (int32_t)(i64OffsetNs / 1000) + noise(2000);
+        if ((u32Sample % 37) == 0)
+        {
+            // Bad reference reading, e.g. a delayed NTP reply
+            i32SampleUs += ((u32Sample & 1) ? 300000 : -300000);
+        }
+        bApplied = false;
+        if (Amx8x5_DriftAddSample(&stcHandle, &stcDrift, 1000000UL + u32Sample * u32Interval, i32SampleUs, &bApplied) != Ok)
+        {
+            printf("FAIL: %s %ld ppb: AddSample failed at sample %lu\n", pcMode, (long)i32ErrorPpb, (unsigned long)u32Sample);
+            return 1;
+        }
+        if (bApplied) u32Applied++;
+    }
+    i32RatePpb = i32ErrorPpb + calibrationPpb(enMode);
+
+    // Correction rounded to whole ppm, the register rounds to 1.907 ppm steps
+    int32_t i32Expected = -((i32ErrorPpb >= 0) ? (i32ErrorPpb + 500) : (i32ErrorPpb - 500)) / 1000;
+    int iFail = 0;
+    if (!bExpectApplied)
+    {
+        i32Expected = 0;
+    }
+    if ((stcDrift.i32AppliedPpm < i32Expected - 1) || (stcDrift.i32AppliedPpm > i32Expected + 1))
+    {
+        printf("FAIL: %s %ld ppb: applied %ld ppm, expected %ld ppm\n", pcMode, (long)i32ErrorPpb, (long)stcDrift.i32AppliedPpm, (long)i32Expected);
+        iFail = 1;
+    }
+    if ((i32RatePpb > 1907) || (i32RatePpb < -1907))
+    {
+        printf("FAIL: %s %ld ppb: remaining rate %ld ppb\n", pcMode, (long)i32ErrorPpb, (long)i32RatePpb);
+        iFail = 1;
+    }
+    if (bExpectApplied ? ((u32Applied == 0) || (u32Applied > 3)) : (u32Applied != 0))
+    {
+        printf("FAIL: %s %ld ppb: %lu corrections applied\n", pcMode, (long)i32ErrorPpb, (unsigned long)u32Applied);
+        iFail = 1;
+    }
+
+    // Persisted record survives a restart
+    int32_t i32Persisted = stcDrift.i32AppliedPpm;
+    Amx8x5_DriftInit(&stcDrift, enMode, 0, AMX8X5_RAM_DRIFT);
+    if (bExpectApplied ? ((Amx8x5_DriftRestore(&stcHandle, &stcDrift) != Ok) || (stcDrift.i32AppliedPpm != i32Persisted))
+                       : (Amx8x5_DriftRestore(&stcHandle, &stcDrift) != ErrorNotReady))
+    {
+        printf("FAIL: %s %ld ppb: restore\n", pcMode, (long)i32ErrorPpb);
+        iFail = 1;
+    }
+    if (!iFail)
+    {
+        printf("  %s %+8.3f ppm: applied %+ld ppm in %lu step(s), remaining %+6.3f ppm\n", pcMode, i32ErrorPpb / 1000.0,
+               (long)stcDrift.i32AppliedPpm, (unsigned long)u32Applied, i32RatePpb / 1000.0);
+    }
+    return iFail;
+}
+
+int main()
+{
+    static const int32_t ai32XtPpb[] = {7300, -23600, 55100, -150450, 900, 0};
+    static const int32_t ai32RcPpb[] = {1200000, -800300, 35500};
+    int iFail = 0;
+
+    for (size_t i = 0; i < sizeof(ai32XtPpb) / sizeof(ai32XtPpb[0]); i++)
+        iFail |= runOne(AMx8x5ModeCalibrateXT, ai32XtPpb[i]);
+    for (size_t i = 0; i < sizeof(ai32RcPpb) / sizeof(ai32RcPpb[0]); i++)
+        iFail |= runOne(AMx8x5ModeCalibrateRC, ai32RcPpb[i]);
+    if (iFail)
+    {
+        return 1;
+    }
+    printf("OK: drift estimator converged for all synthetic clocks\n");
+    return 0;
+}
@@ -1,13 +1,15 @@
 #!/usr/bin/env bash
 # run_tests.sh — AMX8X5 Arduino Test Runner
 #
-# Runs two kinds of checks without uploading to hardware:
+# Runs three kinds of checks without uploading to hardware:
 #   1. Compilation tests  — compile every example sketch for each enabled board
 #   2. Unit tests         — compile the AUnit test sketch for each enabled board
+#   3. Host tests         — build and run the host tests (threads, exhaustive checks)
 #
 # Requirements:
 #   arduino-cli  https://arduino.github.io/arduino-cli/latest/installation/
 #   AUnit        arduino-cli lib install AUnit
+#   gcc, g++     host tests only, skipped if not installed
 #
 # Usage:
 #   ./run_tests.sh               # all boards
@@ -26,6 +28,8 @@ SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 REPO_ROOT="$(cd "${SCRIPT_DIR}/.." && pwd)"
 BUILD_DIR="/tmp/amx8x5/build"
 UNIT_TEST_DIR="${SCRIPT_DIR}/unit-tests"
+HOST_TEST_DIR="${SCRIPT_DIR}/host"
+HOST_TESTS=(event-queue-stress calibration-codec drift-fit)
 LIB_PATH="${REPO_ROOT}"
 
 # Board configurations: name -> FQBN
@@ -52,6 +56,7 @@ EXAMPLES=(
     examples/output-pin-config/output-pin-config.ino
     examples/oscillator-fail-reset/oscillator-fail-reset.ino
     examples/iot-power-management/iot-power-management.ino
+    examples/interrupt-service/interrupt-service.ino
 )
 
 # ---------------------------------------------------------------------------
@@ -187,6 +192,37 @@ for board in "${AUNIT_BOARDS[@]}"; do
     fi
 done
 
+# ---------------------------------------------------------------------------
+# Run host tests
+# The driver is built as C, the tests are C++.
+# ---------------------------------------------------------------------------
+
+section "Host tests"
+if ! command -v gcc &>/dev/null || ! command -v g++ &>/dev/null; then
+    printf "  ${YELLOW}WARN${NC} gcc / g++ not found, host tests skipped.\n"
+else
+    build_out="${BUILD_DIR}/host"
+    mkdir -p "${build_out}"
+    log="${build_out}/build.log"
+
+    if gcc -std=c99 -O2 -Wall -Wextra -I"${LIB_PATH}" -c -o "${build_out}/amx8x5.o" "${LIB_PATH}/amx8x5.c" >"${log}" 2>&1; then
+        for test in "${HOST_TESTS[@]}"; do
+            log="${build_out}/${test}.log"
+            if g++ -std=gnu++11 -O2 -Wall -Wextra -pthread -I"${LIB_PATH}" -o "${build_out}/${test}" \
+                   "${HOST_TEST_DIR}/${test}.cpp" "${build_out}/amx8x5.o" >"${log}" 2>&1 && \
+               "${build_out}/${test}" >>"${log}" 2>&1; then
+                ok "[host] ${test}"
+            else
+                fail "[host] ${test}"
+                sed -n 'p' "${log}" | tail -10 | sed 's/^/      /'
+            fi
+        done
+    else
+        fail "[host] amx8x5.c"
+        sed -n 'p' "${log}" | tail -10 | sed 's/^/      /'
+    fi
+fi
+
 # ---------------------------------------------------------------------------
 # Summary
 # ---------------------------------------------------------------------------
@@ -15,6 +15,34 @@
 //   4. Alarm        – SetAlarm register content
 //   5. RAM          – RamWrite / RamRead round-trip
 //   6. Enum sanity  – I2C/SPI bit encoding in en_amx8x5_rtc_type_t
+//   7. State        – SaveState / RestoreState snapshot and CONFIG_KEY order
+//   8. Warm boot    – configuration fingerprint in RTC RAM
+//   9. Dispatcher   – single STATUS read, batched clear, callbacks
+//  10. Service loop – AMx8x5::update() idle path, interrupt and deferred work
+//  11. Event queue  – SPSC ring ordering, overflow accounting, dispatch
+//  12. Sw alarms    – seconds conversion, 12-hour mode, heap order,
+//                     hardware alarm rearm
+//  13. Schedule     – next fire time, hardware repeat mapping
+//  14. Tickless     – countdown range selection, fake OS tick compensation
+//  15. Countdown    – prepared encoding, single write rearm
+//  16. Sequence     – 4096 Hz interval encoding, TIMER_INITIAL staging
+//  17. Precise time – counters held until the reference edge, latency,
+//                     host timestamped reads
+//  18. Drift        – least squares fit, outliers, calibration applied
+//  19. Temp comp    – ppm table interpolation, write on step change only
+//  20. Calibration  – codec limits, read back (exhaustive check: host test)
+//  21. Osc health   – OF / ACF counted from the dispatcher burst, policy once
+//  22. Battery      – BREF binary search, restore, scheduled with hysteresis
+//  23. Trickle      – boost / taper / off by level and time, write on change
+//  24. Sleep        – register delta in one burst, deadline window,
+//                     12-hour alarm, wake reason in one read
+//  25. Power fail   – outage record in one burst, recovery with duration
+//  26. Heartbeat    – rate limited last alive burst, downtime at boot
+//  27. Watchdog     – WDT written by SetWatchdog, single byte kick,
+//                     task supervision with the culprit in RTC RAM
+//  28. Sub-second   – hardware repeat patterns, software rearm in one burst
+//  29. Alarm rearm  – level mode and internal pin, alarm time in one burst,
+//                     full SetAlarm on configuration change
 
 #include <AUnit.h>
 #include <amx8x5.h>
@@ -26,9 +54,39 @@
 // Simulated RTC register space (256 bytes, byte-addressed)
 static uint8_t mockRegs[256];
 
+// Write transaction log: start register and first data byte of each
+// mockWrite() call, used to check write order (e.g. CONFIG_KEY unlocks)
+static uint8_t  mockLogReg[64];
+static uint8_t  mockLogVal[64];
+static uint32_t mockLogLen;
+static uint32_t mockReadCalls;
+static bool     mockReadFail;    // mockRead() reports a bus error
+
+// Simulated battery in mV: BBOD of ASTAT follows the BREF falling voltage (0 = off)
+static uint16_t mockVbatMv;
+
+static void mockComparator()
+{
+    uint16_t u16Mv;
+    switch (mockRegs[AMX8X5_REG_BREF_CTRL] >> 4)
+    {
+        case 0x7: u16Mv = 2500; break;
+        case 0xB: u16Mv = 2100; break;
+        case 0xD: u16Mv = 1800; break;
+        default:  u16Mv = 1400; break;
+    }
+    mockRegs[AMX8X5_REG_ASTAT] = (mockVbatMv >= u16Mv) ? AMX8X5_REG_ASTAT_BBOD_MSK : 0;
+}
+
 static int mockWrite(void* pHandle, uint32_t u32Address,
                      uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
 {
+    if (mockLogLen < sizeof(mockLogReg))
+    {
+        mockLogReg[mockLogLen] = u8Register;
+        mockLogVal[mockLogLen] = pu8Data[0];
+        mockLogLen++;
+    }
     for (uint32_t i = 0; i < u32Len; i++)
         mockRegs[(u8Register + i) & 0xFF] = pu8Data[i];
     return 0;
@@ -37,6 +95,9 @@ static int mockWrite(void* pHandle, uint32_t u32Address,
 static int mockRead(void* pHandle, uint32_t u32Address,
                     uint8_t u8Register, uint8_t* pu8Data, uint32_t u32Len)
 {
+    mockReadCalls++;
+    if (mockReadFail) return -1;
+    if (mockVbatMv != 0) mockComparator();
     for (uint32_t i = 0; i < u32Len; i++)
         pu8Data[i] = mockRegs[(u8Register + i) & 0xFF];
     return 0;
@@ -46,6 +107,18 @@ static int mockRead(void* pHandle, uint32_t u32Address,
 static void resetMock()
 {
     memset(mockRegs, 0, sizeof(mockRegs));
+    mockLogLen = 0;
+    mockReadCalls = 0;
+    mockReadFail = false;
+    mockVbatMv = 0;
+}
+
+// Index of the first logged write transaction starting at u8Register, or -1
+static int mockLogFind(uint8_t u8Register)
+{
+    for (uint32_t i = 0; i < mockLogLen; i++)
+        if (mockLogReg[i] == u8Register) return (int)i;
+    return -1;
 }
 
 // Pre-populate the two ID registers (0x28/0x29) with the correct chip ID
@@ -328,6 +401,1902 @@ test(enum_aliases_match_canonical_values)
     assertEqual((int)AMx8x5TypeSPIPowerManagement, (int)AMx8x5Type1815);
 }
 
+// ---------------------------------------------------------------------------
+// 6. Register snapshot: SaveState / RestoreState
+// ---------------------------------------------------------------------------
+
+test(save_state_captures_register_image)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    for (int i = 0; i < AMX8X5_STATE_SIZE; i++) mockRegs[i] = (uint8_t)(0x80 + i);
+
+    stc_amx8x5_state_t st;
+    assertEqual((int)Amx8x5_SaveState(&h, &st), (int)Ok);
+    for (int i = 0; i < AMX8X5_STATE_SIZE; i++)
+    {
+        assertEqual((int)st.au8Register[i], 0x80 + i);
+    }
+}
+
+test(restore_state_writes_config_not_counters)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_state_t st;
+    memset(&st, 0x5A, sizeof(st));
+    st.au8Register[AMX8X5_REG_TIMER_INITIAL] = 0x20;
+    st.au8Register[AMX8X5_REG_SLEEP_CTRL]    = 0x87;
+    mockRegs[AMX8X5_REG_OSC_STATUS]          = AMX8X5_REG_OSC_STATUS_OF_MSK;
+
+    assertEqual((int)Amx8x5_RestoreState(&h, &st), (int)Ok);
+
+    // Counters and status are untouched
+    for (int i = AMX8X5_REG_HUNDREDTHS; i <= AMX8X5_REG_WEEKDAY; i++)
+    {
+        assertEqual((int)mockRegs[i], 0);
+    }
+    assertEqual(mockLogFind(AMX8X5_REG_HUNDREDTHS), -1);
+    assertEqual(mockLogFind(AMX8X5_REG_STATUS), -1);
+    assertEqual((int)mockRegs[AMX8X5_REG_ID0], 0x18);
+
+    // Alarm and control registers restored
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x5A);
+    assertEqual((int)mockRegs[AMX8X5_REG_CONTROL_1], 0x5A);
+    assertEqual((int)mockRegs[AMX8X5_REG_WDT], 0x5A);
+    assertEqual((int)mockRegs[AMX8X5_REG_OCTRL], 0x5A);
+
+    // SLP/SLST not repeated, countdown reloaded from TIMER_INITIAL
+    assertEqual((int)mockRegs[AMX8X5_REG_SLEEP_CTRL], 0x07);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 0x20);
+
+    // XTCAL/LKO2 restored, OF written as 1 so the pending flag survives
+    assertEqual((int)(mockRegs[AMX8X5_REG_OSC_STATUS] & 0xE0), 0x40);
+    assertTrue((mockRegs[AMX8X5_REG_OSC_STATUS] & AMX8X5_REG_OSC_STATUS_OF_MSK) != 0);
+}
+
+test(restore_state_unlocks_protected_registers)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_state_t st;
+    memset(&st, 0, sizeof(st));
+    st.au8Register[AMX8X5_REG_TRICKLE]    = 0xA5;
+    st.au8Register[AMX8X5_REG_BREF_CTRL]  = 0xB0;
+    st.au8Register[AMX8X5_REG_BATMODE_IO] = 0x80;
+
+    assertEqual((int)Amx8x5_RestoreState(&h, &st), (int)Ok);
+
+    int iOsc = mockLogFind(AMX8X5_REG_OSC_CONTROL);
+    assertMore(iOsc, 0);
+    assertEqual((int)mockLogReg[iOsc - 1], AMX8X5_REG_CONFIG_KEY);
+    assertEqual((int)mockLogVal[iOsc - 1], AMX8X5_REG_CONFIG_KEY_VAL_OSC);
+
+    const uint8_t au8Protected[] = { AMX8X5_REG_TRICKLE, AMX8X5_REG_BREF_CTRL, AMX8X5_REG_BATMODE_IO };
+    for (unsigned i = 0; i < sizeof(au8Protected); i++)
+    {
+        int iReg = mockLogFind(au8Protected[i]);
+        assertMore(iReg, 0);
+        assertEqual((int)mockLogReg[iReg - 1], AMX8X5_REG_CONFIG_KEY);
+        assertEqual((int)mockLogVal[iReg - 1], AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+    }
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], 0xA5);
+    assertEqual((int)mockRegs[AMX8X5_REG_BREF_CTRL], 0xB0);
+    assertEqual((int)mockRegs[AMX8X5_REG_BATMODE_IO], 0x80);
+}
+
+test(restore_state_skips_power_registers_on_am0805)
+{
+    stc_amx8x5_handle_t h = initedHandle(AMx8x5Type0805);
+    stc_amx8x5_state_t st;
+    memset(&st, 0xFF, sizeof(st));
+
+    assertEqual((int)Amx8x5_RestoreState(&h, &st), (int)Ok);
+    assertEqual(mockLogFind(AMX8X5_REG_TRICKLE), -1);
+    assertEqual(mockLogFind(AMX8X5_REG_BREF_CTRL), -1);
+}
+
+// ---------------------------------------------------------------------------
+// 7. Warm boot: CheckWarmBoot / SaveConfigFingerprint
+// ---------------------------------------------------------------------------
+
+test(warm_boot_cold_start_not_detected)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    bool bWarm = true;
+    assertEqual((int)Amx8x5_CheckWarmBoot(&h, AMX8X5_RAM_FINGERPRINT, &bWarm), (int)Ok);
+    assertFalse(bWarm);
+}
+
+test(warm_boot_detected_after_fingerprint_saved)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    mockRegs[AMX8X5_REG_INT_MASK] = 0xE4;
+    mockRegs[AMX8X5_REG_OCTRL]    = 0x21;
+    assertEqual((int)Amx8x5_SaveConfigFingerprint(&h, AMX8X5_RAM_FINGERPRINT), (int)Ok);
+
+    // Counters and flags may change between boots
+    mockRegs[AMX8X5_REG_TIMER]  = 0x33;
+    mockRegs[AMX8X5_REG_STATUS] = 0xFF;
+    mockReadCalls = 0;
+
+    bool bWarm = false;
+    assertEqual((int)Amx8x5_CheckWarmBoot(&h, AMX8X5_RAM_FINGERPRINT, &bWarm), (int)Ok);
+    assertTrue(bWarm);
+    // One burst for ID/control registers, one for the fingerprint
+    assertEqual((int)mockReadCalls, 2);
+}
+
+test(warm_boot_config_change_detected)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    assertEqual((int)Amx8x5_SaveConfigFingerprint(&h, 0x10), (int)Ok);
+    mockRegs[AMX8X5_REG_OSC_CONTROL] = 0x05;
+
+    bool bWarm = true;
+    assertEqual((int)Amx8x5_CheckWarmBoot(&h, 0x10, &bWarm), (int)Ok);
+    assertFalse(bWarm);
+}
+
+test(warm_boot_kept_after_calibration_change)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    assertEqual((int)Amx8x5_SaveConfigFingerprint(&h, AMX8X5_RAM_FINGERPRINT), (int)Ok);
+
+    // Drift correction, alarm / timer use since the fingerprint was saved
+    assertEqual((int)Amx8x5_SetCalibrationValue(&h, AMx8x5ModeCalibrateXT, -7), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_CAL_XT], 0x7C);
+    mockRegs[AMX8X5_REG_INT_MASK] |= AMX8X5_REG_INT_MASK_TIE_MSK | AMX8X5_REG_INT_MASK_AIE_MSK;
+    mockRegs[AMX8X5_REG_TIMER_CTRL] = AMX8X5_REG_TIMER_CTRL_TE_MSK | 2;
+    mockRegs[AMX8X5_REG_TIMER_INITIAL] = 99;
+
+    bool bWarm = false;
+    assertEqual((int)Amx8x5_CheckWarmBoot(&h, AMX8X5_RAM_FINGERPRINT, &bWarm), (int)Ok);
+    assertTrue(bWarm);
+}
+
+test(warm_boot_wrong_id_returns_error)
+{
+    resetMock();
+    stc_amx8x5_handle_t h = makeHandle(AMx8x5Type1805);
+    bool bWarm = true;
+    assertEqual((int)Amx8x5_CheckWarmBoot(&h, AMX8X5_RAM_FINGERPRINT, &bWarm), (int)ErrorInvalidMode);
+    assertFalse(bWarm);
+}
+
+// ---------------------------------------------------------------------------
+// 8. Interrupt dispatcher
+// ---------------------------------------------------------------------------
+
+static uint8_t irqCalls;
+static uint8_t irqStatusSeen;
+
+static void irqRecord(stc_amx8x5_handle_t* pstcHandle, en_amx8x5_irq_source_t enSource)
+{
+    irqCalls |= (1 << enSource);
+    // Flags are cleared before the callbacks run
+    irqStatusSeen = mockRegs[AMX8X5_REG_STATUS];
+}
+
+test(irq_dispatch_clears_serviced_flags_in_one_write)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_irq_dispatcher_t d;
+    Amx8x5_IrqDispatcherInit(&d);
+    Amx8x5_IrqDispatcherRegister(&d, AMx8x5IrqAlarm, irqRecord);
+    Amx8x5_IrqDispatcherRegister(&d, AMx8x5IrqTimer, irqRecord);
+    irqCalls = 0;
+
+    // CB (century) set, alarm + timer + EX1 pending; EX1 has no callback
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_CB_MSK | AMX8X5_REG_STATUS_ALM_MSK |
+                                  AMX8X5_REG_STATUS_TIM_MSK | AMX8X5_REG_STATUS_EX1_MSK;
+    mockReadCalls = 0;
+
+    uint8_t u8Serviced = 0;
+    assertEqual((int)Amx8x5_IrqDispatch(&h, &d, &u8Serviced), (int)Ok);
+    assertEqual((int)u8Serviced, (1 << AMx8x5IrqAlarm) | (1 << AMx8x5IrqTimer));
+    assertEqual((int)irqCalls, (int)u8Serviced);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 1);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_STATUS);
+    // Serviced flags written 0, all others 1 (keeps new / unhandled flags), CB kept
+    assertEqual((int)mockLogVal[0], 0xFF & ~(AMX8X5_REG_STATUS_ALM_MSK | AMX8X5_REG_STATUS_TIM_MSK));
+    assertEqual((int)irqStatusSeen, (int)mockLogVal[0]);
+}
+
+test(irq_dispatch_nothing_pending_no_write)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_irq_dispatcher_t d;
+    Amx8x5_IrqDispatcherInit(&d);
+    Amx8x5_IrqDispatcherRegister(&d, AMx8x5IrqAlarm, irqRecord);
+    irqCalls = 0;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_EX2_MSK;
+
+    uint8_t u8Serviced = 0xFF;
+    assertEqual((int)Amx8x5_IrqDispatch(&h, &d, &u8Serviced), (int)Ok);
+    assertEqual((int)u8Serviced, 0);
+    assertEqual((int)irqCalls, 0);
+    assertEqual((int)mockLogLen, 0);
+}
+
+test(irq_dispatch_oscillator_fail)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_irq_dispatcher_t d;
+    Amx8x5_IrqDispatcherInit(&d);
+    Amx8x5_IrqDispatcherRegister(&d, AMx8x5IrqOscillatorFail, irqRecord);
+    irqCalls = 0;
+    mockRegs[AMX8X5_REG_OSC_STATUS] = 0x40 | AMX8X5_REG_OSC_STATUS_OF_MSK | AMX8X5_REG_OSC_STATUS_ACF_MSK;
+
+    uint8_t u8Serviced = 0;
+    assertEqual((int)Amx8x5_IrqDispatch(&h, &d, &u8Serviced), (int)Ok);
+    assertEqual((int)u8Serviced, 1 << AMx8x5IrqOscillatorFail);
+    assertEqual((int)irqCalls, 1 << AMx8x5IrqOscillatorFail);
+    // XTCAL kept, OF cleared, ACF (no callback) written as 1
+    assertEqual((int)mockRegs[AMX8X5_REG_OSC_STATUS], 0x40 | AMX8X5_REG_OSC_STATUS_ACF_MSK);
+}
+
+// ---------------------------------------------------------------------------
+// 9. Service loop: AMx8x5::update()
+// ---------------------------------------------------------------------------
+
+static uint8_t workCalls;
+
+static void countWork(AMx8x5* pRtc)
+{
+    workCalls++;
+}
+
+test(update_idle_has_no_bus_access)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    AMx8x5 rtc;
+    rtc.init(&h);
+    mockReadCalls = 0;
+    for (int i = 0; i < 100; i++) rtc.update();
+    assertEqual((int)mockReadCalls, 0);
+    assertEqual((int)mockLogLen, 0);
+}
+
+test(update_dispatches_notified_interrupt_once)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    AMx8x5 rtc;
+    rtc.init(&h);
+    rtc.onInterrupt(AMx8x5IrqAlarm, irqRecord);
+    irqCalls = 0;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_ALM_MSK;
+
+    rtc.notifyInterrupt();
+    rtc.update();
+    assertEqual((int)irqCalls, 1 << AMx8x5IrqAlarm);
+
+    mockReadCalls = 0;
+    rtc.update();
+    assertEqual((int)mockReadCalls, 0);
+}
+
+test(update_keeps_interrupt_pending_on_bus_error)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    AMx8x5 rtc;
+    rtc.init(&h);
+    rtc.onInterrupt(AMx8x5IrqAlarm, irqRecord);
+    irqCalls = 0;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_ALM_MSK;
+
+    rtc.notifyInterrupt();
+    mockReadFail = true;
+    assertEqual((int)rtc.update(), (int)Error);
+    assertEqual((int)irqCalls, 0);
+
+    // Retried without a new notification
+    mockReadFail = false;
+    assertEqual((int)rtc.update(), (int)Ok);
+    assertEqual((int)irqCalls, 1 << AMx8x5IrqAlarm);
+}
+
+test(update_runs_deferred_work_once)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    AMx8x5 rtc;
+    rtc.init(&h);
+    workCalls = 0;
+
+    assertTrue(rtc.defer(countWork));
+    assertTrue(rtc.defer(countWork)); // coalesced
+    rtc.update();
+    assertEqual((int)workCalls, 1);
+    rtc.update();
+    assertEqual((int)workCalls, 1);
+}
+
+// ---------------------------------------------------------------------------
+// 10. ISR event queue
+// ---------------------------------------------------------------------------
+
+// Producer and consumer interleaved in pseudo-random bursts, far beyond the
+// 8-bit index wrap-around: every accepted event is received exactly once and
+// in order, every rejected one is counted as dropped. Concurrent producer
+// and consumer threads are covered by tests/host/event-queue-stress.cpp.
+test(event_queue_interleaved_no_loss_no_duplicates)
+{
+    static stc_amx8x5_event_queue_t q;
+    Amx8x5_EventQueueInit(&q);
+
+    uint32_t u32Seed = 12345;
+    uint32_t u32Produced = 0, u32Rejected = 0, u32Consumed = 0;
+    stc_amx8x5_event_t e;
+    for (int iRound = 0; iRound < 2000; iRound++)
+    {
+        u32Seed = u32Seed * 1103515245UL + 12345UL;
+        int iPush = (u32Seed >> 16) % (AMX8X5_EVENT_QUEUE_SIZE + 4);
+        int iPop  = (u32Seed >> 8) % (AMX8X5_EVENT_QUEUE_SIZE + 2);
+        for (int i = 0; i < iPush; i++)
+        {
+            if (Amx8x5_EventQueuePush(&q, u32Produced, (uint8_t)u32Produced) == Ok) u32Produced++;
+            else u32Rejected++;
+        }
+        for (int i = 0; i < iPop; i++)
+        {
+            if (Amx8x5_EventQueuePop(&q, &e) != Ok) break;
+            assertEqual((uint32_t)e.u32Timestamp, u32Consumed);
+            assertEqual((int)e.u8Pin, (int)(uint8_t)u32Consumed);
+            u32Consumed++;
+        }
+    }
+    while (Amx8x5_EventQueuePop(&q, &e) == Ok)
+    {
+        assertEqual((uint32_t)e.u32Timestamp, u32Consumed);
+        u32Consumed++;
+    }
+    assertEqual(u32Consumed, u32Produced);
+    assertMore(u32Produced, (uint32_t)256);
+    assertMore(u32Rejected, (uint32_t)0);
+    assertEqual((uint32_t)q.u8Dropped, (u32Rejected > 255) ? (uint32_t)255 : u32Rejected);
+}
+
+test(event_queue_dispatch_coalesces_events)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static stc_amx8x5_event_queue_t q;
+    stc_amx8x5_irq_dispatcher_t d;
+    Amx8x5_EventQueueInit(&q);
+    Amx8x5_IrqDispatcherInit(&d);
+    Amx8x5_IrqDispatcherRegister(&d, AMx8x5IrqTimer, irqRecord);
+    irqCalls = 0;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_TIM_MSK;
+    mockReadCalls = 0;
+
+    assertEqual((int)Amx8x5_EventQueueDispatch(&h, &q, &d, NULL, NULL), (int)ErrorNotReady);
+    assertEqual((int)mockReadCalls, 0);
+
+    Amx8x5_EventQueuePush(&q, 100, 1);
+    Amx8x5_EventQueuePush(&q, 200, 1);
+    Amx8x5_EventQueuePush(&q, 300, 2);
+
+    stc_amx8x5_event_t last;
+    uint8_t u8Serviced = 0;
+    assertEqual((int)Amx8x5_EventQueueDispatch(&h, &q, &d, &last, &u8Serviced), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((uint32_t)last.u32Timestamp, (uint32_t)300);
+    assertEqual((int)u8Serviced, 1 << AMx8x5IrqTimer);
+    assertEqual((int)irqCalls, 1 << AMx8x5IrqTimer);
+}
+
+// ---------------------------------------------------------------------------
+// 11. Software alarms
+// ---------------------------------------------------------------------------
+
+// Load the mock time registers (24-hour mode) with seconds since 2000
+static void mockSetSeconds(uint32_t u32Seconds)
+{
+    stc_amx8x5_time_t t;
+    Amx8x5_SecondsToTime(u32Seconds, &t);
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0;
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 1] = AMX8X5_DEC_TO_BCD(t.u8Second);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 2] = AMX8X5_DEC_TO_BCD(t.u8Minute);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 3] = AMX8X5_DEC_TO_BCD(t.u8Hour);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 4] = AMX8X5_DEC_TO_BCD(t.u8Date);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 5] = AMX8X5_DEC_TO_BCD(t.u8Month);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 6] = AMX8X5_DEC_TO_BCD(t.u8Year);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 7] = t.u8Weekday;
+}
+
+test(seconds_conversion_round_trip)
+{
+    stc_amx8x5_time_t t;
+    uint32_t u32Seconds;
+
+    memset(&t, 0, sizeof(t));
+    t.u8Date = 1; t.u8Month = 1; t.u8Mode = AMX8X5_24HR_MODE;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, (uint32_t)0);
+
+    // 2024-02-29 12:34:56 (leap day), 2000-01-01 was a Saturday
+    t.u8Year = 24; t.u8Month = 2; t.u8Date = 29; t.u8Hour = 12; t.u8Minute = 34; t.u8Second = 56;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, (uint32_t)762525296UL);
+    Amx8x5_SecondsToTime(0, &t);
+    assertEqual((int)t.u8Weekday, 6);
+
+    // Every 13th day of the century survives the round trip
+    for (uint32_t u32Day = 0; u32Day < 36525UL; u32Day += 13)
+    {
+        uint32_t u32In = u32Day * 86400UL + (u32Day % 86400UL);
+        assertEqual((int)Amx8x5_SecondsToTime(u32In, &t), (int)Ok);
+        assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+        assertEqual(u32Seconds, u32In);
+    }
+    assertEqual((int)Amx8x5_SecondsToTime(36525UL * 86400UL, &t), (int)ErrorInvalidParameter);
+}
+
+test(seconds_conversion_12_hour_mode)
+{
+    stc_amx8x5_time_t t;
+    uint32_t u32Seconds;
+    // 2024-02-29 00:00:00
+    const uint32_t u32Day = 762480000UL;
+
+    memset(&t, 0, sizeof(t));
+    t.u8Year = 24; t.u8Month = 2; t.u8Date = 29;
+    // 12 AM is midnight, 12 PM is noon
+    t.u8Hour = 12; t.u8Mode = 0;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, u32Day);
+    t.u8Mode = AMX8X5_12HR_MODE;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, u32Day + 12 * 3600UL);
+    t.u8Hour = 11; t.u8Mode = 0;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, u32Day + 11 * 3600UL);
+    t.u8Mode = AMX8X5_12HR_MODE;
+    assertEqual((int)Amx8x5_TimeToSeconds(&t, &u32Seconds), (int)Ok);
+    assertEqual(u32Seconds, u32Day + 23 * 3600UL);
+}
+
+static uint8_t swAlarmOrder[8];
+static uint8_t swAlarmFired;
+
+static void swAlarmRecord(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Id, uint32_t u32Deadline)
+{
+    if (swAlarmFired < sizeof(swAlarmOrder)) swAlarmOrder[swAlarmFired] = u8Id;
+    swAlarmFired++;
+}
+
+test(swalarm_arms_earliest_and_fires_in_order)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static stc_amx8x5_swalarm_t a;
+    const uint32_t u32Now = 762525296UL;
+    mockSetSeconds(u32Now);
+    Amx8x5_SwAlarmInit(&a, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq);
+    swAlarmFired = 0;
+
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 1, u32Now + 300, swAlarmRecord), (int)Ok);
+    assertEqual(a.u32Armed, u32Now + 300);
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 2, u32Now + 100, swAlarmRecord), (int)Ok);
+    assertEqual(a.u32Armed, u32Now + 100);
+    // 12:36:36 programmed into the alarm registers
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x36);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x36);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x12);
+
+    // Later deadline: no bus access at all
+    mockLogLen = 0;
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 3, u32Now + 200, swAlarmRecord), (int)Ok);
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 4, u32Now + 200, swAlarmRecord), (int)Ok);
+    assertEqual((int)(mockLogLen + mockReadCalls), 0);
+    assertEqual((int)Amx8x5_SwAlarmStop(&h, &a, 4), (int)Ok);
+    assertEqual((int)(mockLogLen + mockReadCalls), 0);
+    assertEqual((int)Amx8x5_SwAlarmStop(&h, &a, 4), (int)ErrorInvalidParameter);
+
+    // Late service: 2 and 3 expired, 1 is armed next
+    mockSetSeconds(u32Now + 250);
+    uint8_t u8Fired = 0;
+    assertEqual((int)Amx8x5_SwAlarmService(&h, &a, &u8Fired), (int)Ok);
+    assertEqual((int)u8Fired, 2);
+    assertEqual((int)swAlarmOrder[0], 2);
+    assertEqual((int)swAlarmOrder[1], 3);
+    assertEqual(a.u32Armed, u32Now + 300);
+
+    // Last alarm fired: hardware alarm disabled
+    mockSetSeconds(u32Now + 300);
+    assertEqual((int)Amx8x5_SwAlarmService(&h, &a, &u8Fired), (int)Ok);
+    assertEqual((int)u8Fired, 1);
+    assertEqual((int)swAlarmOrder[2], 1);
+    assertEqual((int)a.u8Count, 0);
+    assertEqual(a.u32Armed, (uint32_t)0);
+}
+
+test(swalarm_arms_hour_in_12_hour_mode)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static stc_amx8x5_swalarm_t a;
+    // 2024-02-29 12:00:00 AM
+    const uint32_t u32Now = 762480000UL;
+    mockSetSeconds(u32Now);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 3] = 0x12;
+    mockRegs[AMX8X5_REG_CONTROL_1] |= AMX8X5_REG_CONTROL_1_12_24_MSK;
+    Amx8x5_SwAlarmInit(&a, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq);
+
+    // 12:00:30 PM: PM bit and hour 12
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 1, u32Now + 12 * 3600UL + 30, swAlarmRecord), (int)Ok);
+    assertEqual(a.u32Armed, u32Now + 12 * 3600UL + 30);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x30);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x32);
+
+    // 12:01:40 AM: hour 12 without PM bit
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 2, u32Now + 100, swAlarmRecord), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x01);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x12);
+
+    // 1:00:00 PM
+    assertEqual((int)Amx8x5_SwAlarmStop(&h, &a, 1), (int)Ok);
+    assertEqual((int)Amx8x5_SwAlarmStop(&h, &a, 2), (int)Ok);
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 3, u32Now + 13 * 3600UL, swAlarmRecord), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x21);
+}
+
+test(swalarm_heap_keeps_deadline_order)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static stc_amx8x5_swalarm_t a;
+    mockSetSeconds(1000);
+    Amx8x5_SwAlarmInit(&a, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq);
+    swAlarmFired = 0;
+
+    // Deadlines 2000 + (i * 5) % 8, restart id 0 later than all others
+    for (uint8_t i = 0; i < AMX8X5_SWALARM_MAX; i++)
+    {
+        assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, i, 2000 + (i * 5) % 8, swAlarmRecord), (int)Ok);
+    }
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 0xFF, 3000, swAlarmRecord), (int)ErrorBufferFull);
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &a, 0, 2100, swAlarmRecord), (int)Ok);
+    assertEqual(a.u32Armed, (uint32_t)2001);
+
+    mockSetSeconds(2100);
+    uint8_t u8Fired = 0;
+    assertEqual((int)Amx8x5_SwAlarmService(&h, &a, &u8Fired), (int)Ok);
+    assertEqual((int)u8Fired, AMX8X5_SWALARM_MAX);
+    for (uint8_t i = 1; i < AMX8X5_SWALARM_MAX; i++)
+    {
+        // id 5 -> 2001, 2 -> 2002, 7 -> 2003, ...
+        assertEqual((int)swAlarmOrder[i - 1], (int)((i * 5) % 8));
+    }
+    assertEqual((int)swAlarmOrder[AMX8X5_SWALARM_MAX - 1], 0);
+}
+
+static stc_amx8x5_swalarm_t swAlarmRestart;
+
+static void swAlarmRestartSelf(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Id, uint32_t u32Deadline)
+{
+    swAlarmRecord(pstcHandle, u8Id, u32Deadline);
+    // Period 0 with id 1, stop id 2 from id 1: deadline already passed
+    Amx8x5_SwAlarmStart(pstcHandle, &swAlarmRestart, u8Id, u32Deadline, swAlarmRestartSelf);
+    if (u8Id == 1) Amx8x5_SwAlarmStop(pstcHandle, &swAlarmRestart, 2);
+}
+
+test(swalarm_restart_from_callback_fires_once_per_service)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    mockSetSeconds(1000);
+    Amx8x5_SwAlarmInit(&swAlarmRestart, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq);
+    swAlarmFired = 0;
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &swAlarmRestart, 1, 1010, swAlarmRestartSelf), (int)Ok);
+    assertEqual((int)Amx8x5_SwAlarmStart(&h, &swAlarmRestart, 2, 1020, swAlarmRestartSelf), (int)Ok);
+
+    // Both due, 1 restarts itself and stops 2: 1 fires once, 2 not at all
+    mockSetSeconds(1030);
+    mockReadCalls = 0;
+    uint8_t u8Fired = 0;
+    assertEqual((int)Amx8x5_SwAlarmService(&h, &swAlarmRestart, &u8Fired), (int)Ok);
+    assertEqual((int)u8Fired, 1);
+    assertEqual((int)swAlarmFired, 1);
+    assertEqual((int)swAlarmRestart.u8Count, 1);
+    assertFalse(swAlarmRestart.bServicing);
+    // Passed deadline armed once, one second ahead
+    assertEqual(swAlarmRestart.u32Armed, (uint32_t)1031);
+    uint32_t u32Reads = mockReadCalls;
+
+    // Next service fires it again, same bus cost
+    mockSetSeconds(1031);
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_SwAlarmService(&h, &swAlarmRestart, &u8Fired), (int)Ok);
+    assertEqual((int)u8Fired, 1);
+    assertEqual((int)swAlarmFired, 2);
+    assertEqual(mockReadCalls, u32Reads);
+}
+
+// ---------------------------------------------------------------------------
+// 12. Cron-like schedule
+// ---------------------------------------------------------------------------
+
+test(schedule_next_fire_time)
+{
+    stc_amx8x5_schedule_t sch;
+    uint32_t u32Next;
+    const uint32_t u32Now = 762525296UL; // Thu 2024-02-29 12:34:56
+
+    // Hourly at :45 -> 12:45 today
+    Amx8x5_ScheduleInit(&sch);
+    sch.u64Minute = 1ULL << 45;
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Now, &u32Next), (int)Ok);
+    assertEqual(u32Next, (uint32_t)762525900UL);
+
+    // Daily 02:30 -> Fri 2024-03-01 02:30
+    sch.u64Minute = 1ULL << 30;
+    sch.u32Hour = 1UL << 2;
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Now, &u32Next), (int)Ok);
+    assertEqual(u32Next, (uint32_t)762575400UL);
+
+    // Mondays 08:15 -> 2024-03-04 08:15
+    sch.u64Minute = 1ULL << 15;
+    sch.u32Hour = 1UL << 8;
+    sch.u8Weekday = 1 << 1;
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Now, &u32Next), (int)Ok);
+    assertEqual(u32Next, (uint32_t)762855300UL);
+
+    // 31st 00:00 -> 2024-03-31, then April is skipped -> 2024-05-31
+    Amx8x5_ScheduleInit(&sch);
+    sch.u64Minute = 1;
+    sch.u32Hour = 1;
+    sch.u32Date = 1UL << 31;
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Now, &u32Next), (int)Ok);
+    assertEqual(u32Next, (uint32_t)765158400UL);
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Next, &u32Next), (int)Ok);
+    assertEqual(u32Next, (uint32_t)770428800UL);
+
+    // February 30th never matches
+    sch.u32Date = 1UL << 30;
+    sch.u16Month = 1 << 2;
+    assertEqual((int)Amx8x5_ScheduleNext(&sch, u32Now, &u32Next), (int)ErrorInvalidParameter);
+}
+
+test(schedule_maps_to_hardware_repeat)
+{
+    stc_amx8x5_schedule_t sch;
+    stc_amx8x5_time_t alarm;
+    en_amx8x5_alarm_repeat_t enRepeat;
+
+    Amx8x5_ScheduleInit(&sch);
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmMinute);
+    sch.u64Minute = 1ULL << 45;
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmHour);
+    assertEqual((int)alarm.u8Minute, 45);
+    sch.u32Hour = 1UL << 2;
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmDay);
+    sch.u8Weekday = 1 << 3;
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmWeek);
+    assertEqual((int)alarm.u8Weekday, 3);
+    sch.u8Weekday = AMX8X5_SCHEDULE_WEEKDAY_ALL;
+    sch.u32Date = 1UL << 15;
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmMonth);
+    sch.u16Month = 1 << 6;
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)Ok);
+    assertEqual((int)enRepeat, (int)AMx8x5AlarmYear);
+    assertEqual((int)alarm.u8Month, 6);
+
+    // Two minutes per hour need the MCU
+    Amx8x5_ScheduleInit(&sch);
+    sch.u64Minute = (1ULL << 0) | (1ULL << 30);
+    assertEqual((int)Amx8x5_ScheduleToAlarm(&sch, &alarm, &enRepeat), (int)ErrorInvalidMode);
+}
+
+test(schedule_arm_daily_uses_hardware_repeat)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_schedule_t sch;
+    uint32_t u32Next = 0;
+    bool bRepeat = false;
+    mockSetSeconds(762525296UL);
+
+    Amx8x5_ScheduleInit(&sch);
+    sch.u64Minute = 1ULL << 30;
+    sch.u32Hour = 1UL << 2;
+    assertEqual((int)Amx8x5_ScheduleArm(&h, &sch, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq, &u32Next, &bRepeat), (int)Ok);
+    assertTrue(bRepeat);
+    assertEqual(u32Next, (uint32_t)762575400UL);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x30);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x02);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & 0x1C), AMx8x5AlarmDay << 2);
+
+    // Every 20 minutes: armed once for 12:40
+    sch.u64Minute = (1ULL << 0) | (1ULL << 20) | (1ULL << 40);
+    sch.u32Hour = AMX8X5_SCHEDULE_HOUR_ALL;
+    assertEqual((int)Amx8x5_ScheduleArm(&h, &sch, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq, &u32Next, &bRepeat), (int)Ok);
+    assertFalse(bRepeat);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x40);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & 0x1C), AMx8x5AlarmYear << 2);
+}
+
+// ---------------------------------------------------------------------------
+// 13. Tickless idle timebase
+// ---------------------------------------------------------------------------
+
+test(tickless_sleep_selects_finest_range)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_tickless_t tl;
+    uint32_t u32Planned;
+    assertEqual((int)Amx8x5_TicklessInit(&h, &tl, 1000, AMx8x5CountdownInterruptPinnTIRQLow), (int)Ok);
+    assertTrue((mockRegs[AMX8X5_REG_INT_MASK] & AMX8X5_REG_INT_MASK_TIE_MSK) != 0);
+
+    // 10 ms: 40 counts of 4096 Hz (9.77 ms)
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 10, &u32Planned), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 39);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_INITIAL], 39);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK | 0);
+    assertEqual(u32Planned, (uint32_t)9);
+
+    // 1 s: 64 counts of 64 Hz
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 1000, &u32Planned), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 63);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK | 1);
+    assertEqual(u32Planned, (uint32_t)1000);
+
+    // 100 s: 100 counts of 1 Hz
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 100000UL, &u32Planned), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 99);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK | 2);
+
+    // RC oscillator: 1 s is 128 counts of 128 Hz
+    mockRegs[AMX8X5_REG_OSC_STATUS] = AMX8X5_REG_OSC_STATUS_OMODE_MSK;
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 1000, &u32Planned), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 127);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK | 0);
+
+    // Shorter than one count
+    mockRegs[AMX8X5_REG_OSC_STATUS] = 0;
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 0, &u32Planned), (int)ErrorInvalidParameter);
+}
+
+// Fake OS tick: expired and early wakes must add up to the real elapsed time
+// without drift, even though 1 ms ticks are no multiple of 1/4096 s.
+test(tickless_fake_os_tick_no_drift)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_tickless_t tl;
+    uint32_t u32FakeTick = 0;
+    uint32_t u32Elapsed4096 = 0;
+    uint32_t u32Ticks;
+    Amx8x5_TicklessInit(&h, &tl, 1000, AMx8x5CountdownInterruptPinnTIRQLow);
+
+    assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)ErrorNotReady);
+
+    for (int i = 0; i < 200; i++)
+    {
+        assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 10, NULL), (int)Ok);
+        uint8_t u8Timer = mockRegs[AMX8X5_REG_TIMER];
+        if ((i % 7) == 3)
+        {
+            // Woken early by another source after 11 counts
+            mockRegs[AMX8X5_REG_TIMER] = u8Timer - 11;
+            u32Elapsed4096 += 11;
+            assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)Ok);
+            assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_TE_MSK), 0);
+        }
+        else
+        {
+            mockRegs[AMX8X5_REG_STATUS] |= AMX8X5_REG_STATUS_TIM_MSK;
+            u32Elapsed4096 += (uint32_t)u8Timer + 1;
+            assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)Ok);
+        }
+        u32FakeTick += u32Ticks;
+        assertEqual(u32FakeTick, (u32Elapsed4096 * 1000UL) / 4096);
+    }
+}
+
+// 1 Hz and 1/60 Hz count on the clock rollover: a sleep started mid-second
+// or mid-minute is measured against HUNDREDTHS / SECONDS, not in whole counts.
+test(tickless_coarse_range_unaligned_phase)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_tickless_t tl;
+    uint32_t u32Ticks;
+    Amx8x5_TicklessInit(&h, &tl, 1000, AMx8x5CountdownInterruptPinnTIRQLow);
+
+    // 100 s at 1 Hz started at .37: expired at the rollover 99.63 s later,
+    // woken at .02, the wake latency is not slept
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x37;
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 100000UL, NULL), (int)Ok);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & 0x03), 2);
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x02;
+    mockRegs[AMX8X5_REG_STATUS] |= AMX8X5_REG_STATUS_TIM_MSK;
+    assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)Ok);
+    assertEqual(u32Ticks, (uint32_t)99630UL);
+
+    // Early wake at .55 after 50 counts: 50.18 s
+    mockRegs[AMX8X5_REG_STATUS] = 0;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x37;
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 100000UL, NULL), (int)Ok);
+    mockRegs[AMX8X5_REG_TIMER] = 99 - 50;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x55;
+    assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)Ok);
+    assertEqual(u32Ticks, (uint32_t)50180UL);
+
+    // 120 min at 1/60 Hz started at :45.10, expired at :00.00, woken at
+    // :00.20: 119:14.90
+    mockRegs[AMX8X5_REG_SECONDS] = 0x45;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x10;
+    assertEqual((int)Amx8x5_TicklessSleep(&h, &tl, 7200000UL, NULL), (int)Ok);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & 0x03), 3);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 119);
+    mockRegs[AMX8X5_REG_SECONDS] = 0x00;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x20;
+    mockRegs[AMX8X5_REG_STATUS] |= AMX8X5_REG_STATUS_TIM_MSK;
+    assertEqual((int)Amx8x5_TicklessWake(&h, &tl, &u32Ticks), (int)Ok);
+    assertEqual(u32Ticks, (uint32_t)7154900UL);
+}
+
+// ---------------------------------------------------------------------------
+// 14. Prepared countdown
+// ---------------------------------------------------------------------------
+
+test(countdown_prepared_matches_set_countdown)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_countdown_t cd;
+    uint8_t au8Expected[3];
+
+    // Reference: 10 ms repeated short pulses via Amx8x5_SetCountdown()
+    Amx8x5_SetCountdown(&h, AMx8x5PeriodeUs, 10000, AMx8x5RepeatModeRepeatedPulseShort, AMx8x5CountdownInterruptPinnTIRQLow);
+    memcpy(au8Expected, &mockRegs[AMX8X5_REG_TIMER_CTRL], 3);
+
+    resetMock();
+    setValidId(AMx8x5Type1805);
+    assertEqual((int)Amx8x5_CountdownPrepare(&h, &cd, AMx8x5PeriodeUs, 10000, AMx8x5RepeatModeRepeatedPulseShort, AMx8x5CountdownInterruptPinnTIRQLow), (int)Ok);
+    assertEqual((int)cd.au8Timer[0], (int)au8Expected[1]);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_TE_MSK), 0);
+
+    // First start: TIMER/TIMER_INITIAL burst, then TIMER_CTRL, no read
+    mockLogLen = 0;
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_CountdownStart(&h, &cd), (int)Ok);
+    assertEqual((int)mockReadCalls, 0);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_TIMER);
+    assertEqual((int)mockLogReg[1], AMX8X5_REG_TIMER_CTRL);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], (int)au8Expected[0]);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], (int)au8Expected[1]);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_INITIAL], (int)au8Expected[2]);
+
+    // Rearm: one write
+    mockRegs[AMX8X5_REG_TIMER] = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_CountdownStart(&h, &cd), (int)Ok);
+    assertEqual((int)(mockLogLen + mockReadCalls), 1);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], (int)au8Expected[1]);
+
+    assertEqual((int)Amx8x5_CountdownStop(&h, &cd), (int)Ok);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_TE_MSK), 0);
+}
+
+test(countdown_prepare_rejects_period_out_of_range)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_countdown_t cd;
+    // 100 ms does not fit 256 counts of 4096 Hz
+    assertEqual((int)Amx8x5_CountdownPrepare(&h, &cd, AMx8x5PeriodeUs, 100000, AMx8x5RepeatModeSinglePulseShort, AMx8x5CountdownInterruptPinnTIRQLow), (int)ErrorInvalidParameter);
+    // but 128 Hz in RC mode
+    mockRegs[AMX8X5_REG_OSC_STATUS] = AMX8X5_REG_OSC_STATUS_OMODE_MSK;
+    assertEqual((int)Amx8x5_CountdownPrepare(&h, &cd, AMx8x5PeriodeUs, 100000, AMx8x5RepeatModeSinglePulseShort, AMx8x5CountdownInterruptPinnTIRQLow), (int)Ok);
+    // 12 counts of 128 Hz, TIMER holds counts - 1
+    assertEqual((int)cd.au8Timer[0], 11);
+}
+
+// ---------------------------------------------------------------------------
+// 15. Timer sequence
+// ---------------------------------------------------------------------------
+
+test(sequence_encode_4096hz)
+{
+    const uint32_t au32Us[4] = {1000, 244, 62500, 10000};
+    uint8_t au8Timer[4];
+    assertEqual((int)Amx8x5_SequenceEncode(au32Us, au8Timer, 4), (int)Ok);
+    assertEqual((int)au8Timer[0], 3);    // 4.096 counts
+    assertEqual((int)au8Timer[1], 0);    // 1 count
+    assertEqual((int)au8Timer[2], 255);  // 256 counts
+    assertEqual((int)au8Timer[3], 40);   // 40.96 counts
+
+    const uint32_t au32Bad[2] = {100, 70000};
+    assertEqual((int)Amx8x5_SequenceEncode(&au32Bad[0], au8Timer, 1), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_SequenceEncode(&au32Bad[1], au8Timer, 1), (int)ErrorInvalidParameter);
+}
+
+test(sequence_stages_next_interval_with_one_write)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static const uint8_t au8Timer[4] = {10, 20, 30, 40};
+    stc_amx8x5_sequence_t seq;
+    bool bDone = true;
+    Amx8x5_SequenceInit(&seq, au8Timer, 4);
+
+    assertEqual((int)Amx8x5_SequenceStart(&h, &seq, AMx8x5CountdownInterruptPinnTIRQLow), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER], 10);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_INITIAL], 20);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK | AMX8X5_REG_TIMER_CTRL_TRPT_MSK);
+
+    // Interval 0 ended, 1 reloaded by the RTC: stage 2
+    mockLogLen = 0;
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_SequenceService(&h, &seq, &bDone), (int)Ok);
+    assertFalse(bDone);
+    assertEqual((int)(mockLogLen + mockReadCalls), 1);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_INITIAL], 30);
+    Amx8x5_SequenceService(&h, &seq, &bDone);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_INITIAL], 40);
+
+    // Last interval running: repeat off
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SequenceService(&h, &seq, &bDone), (int)Ok);
+    assertFalse(bDone);
+    assertEqual((int)mockLogLen, 1);
+    assertEqual((int)mockRegs[AMX8X5_REG_TIMER_CTRL], AMX8X5_REG_TIMER_CTRL_TE_MSK);
+
+    // Last interval ended
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SequenceService(&h, &seq, &bDone), (int)Ok);
+    assertTrue(bDone);
+    assertEqual((int)mockLogLen, 0);
+
+    // 4096 Hz is not available with the RC oscillator
+    mockRegs[AMX8X5_REG_OSC_STATUS] = AMX8X5_REG_OSC_STATUS_OMODE_MSK;
+    assertEqual((int)Amx8x5_SequenceStart(&h, &seq, AMx8x5CountdownInterruptPinnTIRQLow), (int)ErrorInvalidMode);
+}
+
+// ---------------------------------------------------------------------------
+// 16. Precise time
+// ---------------------------------------------------------------------------
+
+static uint32_t fakeMicrosNow;
+static uint32_t fakeMicrosStep;
+static uint32_t fakeMicros(void)
+{
+    fakeMicrosNow += fakeMicrosStep;
+    return fakeMicrosNow;
+}
+
+static uint8_t edgeControl1;
+static uint8_t edgeHundredths;
+static uint32_t edgeLogLen;
+static void edgeRecord(stc_amx8x5_handle_t* pstcHandle)
+{
+    edgeControl1 = mockRegs[AMX8X5_REG_CONTROL_1];
+    edgeHundredths = mockRegs[AMX8X5_REG_HUNDREDTHS];
+    edgeLogLen = mockLogLen;
+}
+
+test(set_time_precise_releases_stop_after_edge)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_time_t t;
+    uint32_t u32Latency = 0;
+    Amx8x5_SecondsToTime(86400UL * 100, &t);
+    t.u8Second = 42;
+    fakeMicrosStep = 300;
+    mockLogLen = 0;
+
+    assertEqual((int)Amx8x5_SetTimePrecise(&h, &t, true, edgeRecord, fakeMicros, &u32Latency), (int)Ok);
+    assertEqual(u32Latency, (uint32_t)300);
+
+    // Counters held and written before the edge, nothing written after it
+    // except the single release
+    assertTrue((edgeControl1 & AMX8X5_REG_CONTROL_1_STOP_MSK) != 0);
+    assertEqual((int)edgeHundredths, 0);
+    assertEqual((int)mockRegs[AMX8X5_REG_HUNDREDTHS + 1], 0x42);
+    assertEqual(mockLogLen, edgeLogLen + 1);
+    assertEqual((int)mockLogReg[edgeLogLen], AMX8X5_REG_CONTROL_1);
+    assertEqual((int)(mockRegs[AMX8X5_REG_CONTROL_1] & (AMX8X5_REG_CONTROL_1_STOP_MSK | AMX8X5_REG_CONTROL_1_WRTC_MSK)), 0);
+
+    // A slow bus is compensated in whole hundredths
+    fakeMicrosStep = 12000;
+    assertEqual((int)Amx8x5_SetTimePrecise(&h, &t, false, edgeRecord, fakeMicros, NULL), (int)Ok);
+    assertEqual((int)edgeHundredths, 0x01);
+    assertEqual((int)mockRegs[AMX8X5_REG_CONTROL_1] & AMX8X5_REG_CONTROL_1_WRTC_MSK, AMX8X5_REG_CONTROL_1_WRTC_MSK);
+
+    assertEqual((int)Amx8x5_SetTimePrecise(&h, &t, true, NULL, fakeMicros, NULL), (int)ErrorInvalidParameter);
+}
+
+// Host clock that also drives the mock hundredths, the RTC shows hundredth
+// n exactly from host time n * 10000 us on
+static uint32_t tickingMicros(void)
+{
+    fakeMicrosNow += fakeMicrosStep;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = AMX8X5_DEC_TO_BCD((fakeMicrosNow / 10000) % 100);
+    return fakeMicrosNow;
+}
+
+test(get_time_precise_brackets_the_latch)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_time_precise_t p;
+    fakeMicrosStep = 300;
+
+    // Single burst: hundredth 0 was reached at host time 0
+    fakeMicrosNow = 7700;
+    tickingMicros();
+    assertEqual((int)Amx8x5_GetTimePrecise(&h, &p, tickingMicros, false), (int)Ok);
+    assertEqual((int)p.stcTime.u8Hundredth, 0);
+    assertTrue(p.u32UncertaintyUs >= 5000);
+    assertLess((int32_t)p.u32HostUs - (int32_t)p.u32UncertaintyUs, (int32_t)1);
+    assertMore((int32_t)(p.u32HostUs + p.u32UncertaintyUs), (int32_t)-1);
+
+    // Waiting for the edge: hundredth 1 at host time 10000, bound ~1 transfer
+    fakeMicrosNow = 7700;
+    tickingMicros();
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_GetTimePrecise(&h, &p, tickingMicros, true), (int)Ok);
+    assertEqual((int)p.stcTime.u8Hundredth, 1);
+    assertTrue(p.u32UncertaintyUs <= 300);
+    assertTrue(p.u32HostUs - p.u32UncertaintyUs <= 10000);
+    assertTrue(p.u32HostUs + p.u32UncertaintyUs >= 10000);
+
+    // Stopped RTC: the hundredths never change
+    fakeMicrosStep = 1000;
+    assertEqual((int)Amx8x5_GetTimePrecise(&h, &p, fakeMicros, true), (int)ErrorTimeout);
+    assertEqual((int)Amx8x5_GetTimePrecise(&h, &p, NULL, false), (int)ErrorInvalidParameter);
+}
+
+// ---------------------------------------------------------------------------
+// 17. Drift estimation
+// ---------------------------------------------------------------------------
+
+// Deterministic noise in [-u32Range, u32Range]
+static uint32_t noiseState = 12345;
+static int32_t noise(uint32_t u32Range)
+{
+    noiseState = noiseState * 1103515245UL + 12345;
+    return (int32_t)((noiseState >> 8) % (2 * u32Range + 1)) - (int32_t)u32Range;
+}
+
+test(drift_fit_applies_correction_and_rejects_outliers)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_drift_t d;
+    bool bApplied = false;
+    int32_t i32Applied = -1;
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateXT, 0, AMX8X5_RAM_DRIFT);
+
+    // Synthetic RTC running 7.3 ppm fast, +/-2 ms reading noise, hourly
+    // samples, one 0.5 s outlier
+    for (uint32_t i = 0; (i < 48) && !bApplied; i++)
+    {
+        uint32_t u32Ref = 1000000 + i * 3600;
+        int32_t i32Offset = 250000 + (int32_t)(i * 3600 * 73 / 10) + noise(2000);
+        if (i == 3) i32Offset += 500000;
+        assertEqual((int)Amx8x5_DriftAddSample(&h, &d, u32Ref, i32Offset, &bApplied), (int)Ok);
+        if (i == 3) assertEqual((int)d.u8Rejected, 1);
+        if (bApplied) i32Applied = (int32_t)i;
+    }
+    assertTrue(bApplied);
+    assertLess(i32Applied, (int32_t)12);
+    assertEqual(d.i32AppliedPpm, (int32_t)-7);
+    // CAL_XT written (-7 ppm = -4 steps, CMDX 0), value persisted
+    assertEqual((int)mockRegs[AMX8X5_REG_CAL_XT], 0x7C);
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateXT, 0, AMX8X5_RAM_DRIFT);
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)Ok);
+    assertEqual(d.i32AppliedPpm, (int32_t)-7);
+}
+
+test(drift_time_step_restarts_fit)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_drift_t d;
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateXT, 0, AMX8X5_RAM_DRIFT);
+    for (uint32_t i = 0; i < 4; i++)
+        Amx8x5_DriftAddSample(&h, &d, i * 3600, (int32_t)(i * 36), NULL);
+    assertEqual((int)d.u8Count, 4);
+
+    // RTC set 2 s ahead: three rejects in a row start a new fit
+    for (uint32_t i = 4; i < 7; i++)
+        Amx8x5_DriftAddSample(&h, &d, i * 3600, 2000000 + (int32_t)(i * 36), NULL);
+    assertEqual((int)d.u8Count, 1);
+    assertEqual(d.u32X0, (uint32_t)(6 * 3600));
+
+    // Empty RAM (cleared or erased) holds no record
+    memset(&mockRegs[0x40], 0x00, 0x40);
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)ErrorNotReady);
+    memset(&mockRegs[0x40], 0xFF, 0x40);
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)ErrorNotReady);
+}
+
+test(drift_record_written_in_one_burst)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_drift_t d;
+    bool bApplied = false;
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateRC, 0, AMX8X5_RAM_DRIFT);
+    assertEqual((int)Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateRC, 0, 0x3E), (int)ErrorInvalidParameter);
+
+    // RTC 1000 ppm slow on RC: +1000 ppm persisted with bank select + one burst
+    for (uint32_t i = 0; (i < 8) && !bApplied; i++)
+    {
+        mockLogLen = 0;
+        Amx8x5_DriftAddSample(&h, &d, i * 600, -(int32_t)(i * 600000UL), &bApplied);
+    }
+    assertTrue(bApplied);
+    assertEqual(d.i32AppliedPpm, (int32_t)1000);
+    assertEqual((int)mockLogReg[mockLogLen - 2], AMX8X5_REG_EXTENDED_ADDR);
+    assertEqual((int)mockLogReg[mockLogLen - 1], 0x40 | (AMX8X5_RAM_DRIFT & 0x3F));
+
+    // Restored with one bank read and write and one burst read
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateRC, 0, AMX8X5_RAM_DRIFT);
+    mockLogLen = 0;
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)Ok);
+    assertEqual(d.i32AppliedPpm, (int32_t)1000);
+    assertEqual((int)(mockLogLen + mockReadCalls), 3);
+
+    // Corrupt record
+    mockRegs[0x40 | (AMX8X5_RAM_DRIFT & 0x3F)] ^= 0x01;
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)ErrorNotReady);
+}
+
+// ---------------------------------------------------------------------------
+// 18. Temperature compensation
+// ---------------------------------------------------------------------------
+
+static int16_t fakeTemperature;
+static en_result_t readFakeTemperature(stc_amx8x5_handle_t* pstcHandle, int16_t* pi16Temperature)
+{
+    *pi16Temperature = fakeTemperature;
+    return Ok;
+}
+
+test(tempcomp_interpolates_and_writes_on_step_change)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    // -0.034 ppm/degC^2 parabola, 1/16 ppm, -15..85 degC in 10 degC steps
+    static const int16_t ai16Xt[] = {-870, -490, -218, -54, 0, -54, -218, -490, -870, -1360, -1958};
+    stc_amx8x5_tempcomp_t tc;
+    bool bWritten = false;
+    assertEqual((int)Amx8x5_TempCompInit(&tc, ai16Xt, 11, -15, 10, readFakeTemperature), (int)Ok);
+
+    // Table points, interpolation, clamping
+    assertEqual(Amx8x5_TempCompDeviation(&tc, 25 * 16), (int32_t)0);
+    assertEqual(Amx8x5_TempCompDeviation(&tc, 30 * 16), (int32_t)-27);
+    assertEqual(Amx8x5_TempCompDeviation(&tc, -40 * 16), (int32_t)-870);
+    assertEqual(Amx8x5_TempCompDeviation(&tc, 100 * 16), (int32_t)-1958);
+
+    // 25 degC: step 0 written once
+    fakeTemperature = 25 * 16;
+    assertEqual((int)Amx8x5_TempCompService(&h, &tc, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    mockLogLen = 0;
+    fakeTemperature = 27 * 16;    // -0.3 ppm, same step
+    Amx8x5_TempCompService(&h, &tc, &bWritten);
+    assertFalse(bWritten);
+    assertEqual((int)mockLogLen, 0);
+
+    // 65 degC: crystal -54.4 ppm slow, +54.4 ppm = +29 steps
+    fakeTemperature = 65 * 16;
+    Amx8x5_TempCompService(&h, &tc, &bWritten);
+    assertTrue(bWritten);
+    assertEqual((int)tc.i16Steps, 29);
+    assertEqual((int)mockRegs[AMX8X5_REG_CAL_XT], 29);
+}
+
+// Drift fitted on top of the temperature compensation: the correction goes to
+// its offset and only the compensation writes CAL_XT.
+test(tempcomp_takes_drift_correction)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    static const int16_t ai16Flat[] = {0};
+    stc_amx8x5_tempcomp_t tc;
+    stc_amx8x5_drift_t d;
+    bool bApplied = false;
+    bool bWritten = false;
+    Amx8x5_TempCompInit(&tc, ai16Flat, 1, 25, 1, readFakeTemperature);
+    fakeTemperature = 25 * 16;
+    Amx8x5_TempCompService(&h, &tc, NULL);
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateXT, 0, AMX8X5_RAM_DRIFT);
+    d.pstcTempComp = &tc;
+
+    // RTC 7.3 ppm fast: offset -7.3125 ppm, CAL_XT untouched until the service
+    for (uint32_t i = 0; (i < 48) && !bApplied; i++)
+    {
+        Amx8x5_DriftAddSample(&h, &d, 1000000 + i * 3600, (int32_t)(i * 3600 * 73 / 10), &bApplied);
+    }
+    assertTrue(bApplied);
+    assertEqual(tc.i32OffsetPpm16, (int32_t)-117);
+    assertFalse(tc.bWritten);
+    assertEqual((int)mockRegs[AMX8X5_REG_CAL_XT], 0);
+    assertEqual((int)Amx8x5_TempCompService(&h, &tc, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    assertEqual((int)mockRegs[AMX8X5_REG_CAL_XT], 0x7C);
+
+    // Restored into the compensation after a reset
+    stc_amx8x5_tempcomp_t tc2;
+    Amx8x5_TempCompInit(&tc2, ai16Flat, 1, 25, 1, readFakeTemperature);
+    Amx8x5_DriftInit(&d, AMx8x5ModeCalibrateXT, 0, AMX8X5_RAM_DRIFT);
+    d.pstcTempComp = &tc2;
+    assertEqual((int)Amx8x5_DriftRestore(&h, &d), (int)Ok);
+    assertEqual(tc2.i32OffsetPpm16, (int32_t)-117);
+
+    // The compensation only corrects the XT oscillator
+    d.enMode = AMx8x5ModeCalibrateRC;
+    assertEqual((int)Amx8x5_DriftAddSample(&h, &d, 0, 0, NULL), (int)ErrorInvalidParameter);
+}
+
+// ---------------------------------------------------------------------------
+// 19. Calibration codec
+// ---------------------------------------------------------------------------
+
+// The exhaustive comparison against a double precision reference runs on
+// the host, see tests/host/calibration-codec.cpp.
+test(calibration_codec_limits)
+{
+    uint8_t au8Reg[2];
+    assertEqual((int)Amx8x5_CalibrationEncode(AMx8x5ModeCalibrateXT, 242, au8Reg), (int)Ok);
+    assertEqual((int)Amx8x5_CalibrationEncode(AMx8x5ModeCalibrateXT, 243, au8Reg), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_CalibrationEncode(AMx8x5ModeCalibrateXT, -611, au8Reg), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_CalibrationEncode(AMx8x5ModeCalibrateRC, 65521, au8Reg), (int)ErrorInvalidParameter);
+}
+
+test(calibration_read_back_single_burst)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    int32_t i32Ppb = 0;
+    assertEqual((int)Amx8x5_SetCalibrationValue(&h, AMx8x5ModeCalibrateXT, -300), (int)Ok);
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_GetCalibrationValue(&h, AMx8x5ModeCalibrateXT, &i32Ppb), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual(i32Ppb, (int32_t)(-157 * 1907));
+
+    // 20975 steps, stored in units of 4 (CMDR = 2)
+    assertEqual((int)Amx8x5_SetCalibrationValue(&h, AMx8x5ModeCalibrateRC, 40000), (int)Ok);
+    assertEqual((int)Amx8x5_GetCalibrationValue(&h, AMx8x5ModeCalibrateRC, &i32Ppb), (int)Ok);
+    assertEqual(i32Ppb, (int32_t)(20972 * 1907));
+}
+
+// ---------------------------------------------------------------------------
+// 20. Oscillator health
+// ---------------------------------------------------------------------------
+
+static uint8_t healthAlerts;
+static void healthAlert(stc_amx8x5_handle_t* pstcHandle, uint8_t u8Failures)
+{
+    healthAlerts |= u8Failures;
+}
+
+test(osc_health_dispatch_single_burst)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_irq_dispatcher_t d;
+    stc_amx8x5_osc_health_t health;
+    Amx8x5_IrqDispatcherInit(&d);
+    assertEqual((int)Amx8x5_OscHealthInit(&health, AMx8x5OscHealthPolicyAlert, 0, healthAlert, fakeMicros), (int)Ok);
+    d.pstcOscHealth = &health;
+    healthAlerts = 0;
+    fakeMicrosNow = 1000;
+    fakeMicrosStep = 0;
+    mockRegs[AMX8X5_REG_OSC_STATUS] = 0x40 | AMX8X5_REG_OSC_STATUS_ACF_MSK;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+
+    assertEqual((int)Amx8x5_IrqDispatch(&h, &d, NULL), (int)Ok);
+    // STATUS and OSC_STATUS in one read, ACF cleared, XTCAL kept
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 1);
+    assertEqual((int)mockRegs[AMX8X5_REG_OSC_STATUS], 0x40 | AMX8X5_REG_OSC_STATUS_OF_MSK);
+    assertEqual((int)health.u16AcfCount, 1);
+    assertEqual((int)health.u16OfCount, 0);
+    assertEqual(health.u32LastAcf, (uint32_t)1000);
+    assertEqual((int)healthAlerts, AMX8X5_REG_OSC_STATUS_ACF_MSK);
+
+    // Nothing changed: the burst is the only access
+    mockRegs[AMX8X5_REG_OSC_STATUS] = 0x40;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_IrqDispatch(&h, &d, NULL), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 0);
+    assertEqual((int)health.u16AcfCount, 1);
+}
+
+test(osc_health_policy_executed_once)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_osc_health_t health;
+    uint8_t u8Failures = 0;
+    assertEqual((int)Amx8x5_OscHealthInit(&health, AMx8x5OscHealthPolicyShortenAutocal, 2, NULL, NULL), (int)Ok);
+
+    // A flag still set in the next sample is the same failure
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_OscHealthSample(&h, &health, AMX8X5_REG_OSC_STATUS_ACF_MSK, &u8Failures), (int)Ok);
+    assertEqual((int)u8Failures, AMX8X5_REG_OSC_STATUS_ACF_MSK);
+    assertEqual((int)Amx8x5_OscHealthSample(&h, &health, AMX8X5_REG_OSC_STATUS_ACF_MSK, &u8Failures), (int)Ok);
+    assertEqual((int)u8Failures, 0);
+    assertEqual((int)health.u16AcfCount, 1);
+    assertEqual((int)mockLogLen, 0);
+
+    // Second failure reaches the threshold: autocalibration every 512 s
+    Amx8x5_OscHealthSample(&h, &health, 0, NULL);
+    assertEqual((int)Amx8x5_OscHealthSample(&h, &health, AMX8X5_REG_OSC_STATUS_ACF_MSK, NULL), (int)Ok);
+    assertEqual((int)health.u16AcfCount, 2);
+    assertTrue(health.bPolicyApplied);
+    assertEqual((int)(mockRegs[AMX8X5_REG_OSC_CONTROL] & 0x60), 0x60);
+    assertTrue(mockLogFind(AMX8X5_REG_OSC_CONTROL) >= 0);
+
+    mockLogLen = 0;
+    Amx8x5_OscHealthSample(&h, &health, 0, NULL);
+    assertEqual((int)Amx8x5_OscHealthSample(&h, &health, AMX8X5_REG_OSC_STATUS_ACF_MSK | AMX8X5_REG_OSC_STATUS_OF_MSK, NULL), (int)Ok);
+    assertEqual((int)health.u16AcfCount, 3);
+    assertEqual((int)health.u16OfCount, 1);
+    assertEqual((int)mockLogLen, 0);
+}
+
+// ---------------------------------------------------------------------------
+// 21. Battery estimation
+// ---------------------------------------------------------------------------
+
+test(battery_estimate_binary_search_restores_bref)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    uint8_t u8Level = 0xFF;
+    uint16_t u16Min = 0, u16Max = 0;
+    mockRegs[AMX8X5_REG_BREF_CTRL] = 0x70;
+    mockVbatMv = 2000;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+
+    assertEqual((int)Amx8x5_BatteryEstimate(&h, &u8Level, &u16Min, &u16Max), (int)Ok);
+    assertEqual((int)u8Level, 2);
+    assertEqual((int)u16Min, 1800);
+    assertEqual((int)u16Max, 2500);
+    // Current threshold first without a write, then 2 probes, then restore
+    assertEqual((int)mockReadCalls, 3);
+    assertEqual((int)mockLogLen, 6);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_CONFIG_KEY);
+    assertEqual((int)mockLogVal[0], AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+    assertEqual((int)mockRegs[AMX8X5_REG_BREF_CTRL], 0x70);
+
+    mockRegs[AMX8X5_REG_BREF_CTRL] = 0xD0;
+    mockVbatMv = 3300;
+    assertEqual((int)Amx8x5_BatteryEstimate(&h, &u8Level, &u16Min, &u16Max), (int)Ok);
+    assertEqual((int)u8Level, 4);
+    assertEqual((int)u16Min, 2500);
+    assertEqual((int)u16Max, AMX8X5_BATTERY_UNKNOWN_MV);
+    assertEqual((int)mockRegs[AMX8X5_REG_BREF_CTRL], 0xD0);
+}
+
+test(battery_service_schedule_and_hysteresis)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_battery_t b;
+    bool bChanged = false;
+    assertEqual((int)Amx8x5_BatteryInit(&b, 60), (int)Ok);
+    mockRegs[AMX8X5_REG_BREF_CTRL] = 0xB0;
+    mockVbatMv = 2300;
+
+    assertEqual((int)Amx8x5_BatteryService(&h, &b, 1000, &bChanged), (int)Ok);
+    assertTrue(bChanged);
+    assertEqual((int)b.u8Level, 3);
+
+    // Period not elapsed: no bus access
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_BatteryService(&h, &b, 1059, &bChanged), (int)Ok);
+    assertFalse(bChanged);
+    assertEqual((int)mockReadCalls, 0);
+
+    // New level reported after AMX8X5_BATTERY_CONFIRM measurements
+    mockVbatMv = 1700;
+    assertEqual((int)Amx8x5_BatteryService(&h, &b, 1060, &bChanged), (int)Ok);
+    assertFalse(bChanged);
+    assertEqual((int)b.u8Level, 3);
+    assertEqual((int)Amx8x5_BatteryService(&h, &b, 1120, &bChanged), (int)Ok);
+    assertTrue(bChanged);
+    assertEqual((int)b.u8Level, 1);
+    assertEqual((int)b.u16MinMv, 1400);
+    assertEqual((int)b.u16MaxMv, 2200);
+}
+
+// ---------------------------------------------------------------------------
+// 22. Trickle charger policy
+// ---------------------------------------------------------------------------
+
+test(trickle_encode_resistor_field)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    assertEqual((int)Amx8x5_EnableTrickleCharger(&h, AMx8x5TrickleDiodeNormal, AMx8x5TrickleResistor11K, true), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], 0xA0 | (2 << AMX8X5_REG_TRICKLE_DIODE_POS) | (3 << AMX8X5_REG_TRICKLE_ROUT_POS));
+}
+
+test(trickle_policy_writes_on_change_only)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_trickle_policy_t p;
+    bool bWritten = false;
+    const uint8_t u8Boost = 0xA0 | (1 << AMX8X5_REG_TRICKLE_DIODE_POS) | (1 << AMX8X5_REG_TRICKLE_ROUT_POS);
+    const uint8_t u8Taper = 0xA0 | (1 << AMX8X5_REG_TRICKLE_DIODE_POS) | (3 << AMX8X5_REG_TRICKLE_ROUT_POS);
+    assertEqual((int)Amx8x5_TrickleInit(&p, 4, 600), (int)Ok);
+
+    // Empty: boost, key first
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 1, 1000, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_CONFIG_KEY);
+    assertEqual((int)mockLogVal[0], AMX8X5_REG_CONFIG_KEY_VAL_OTHER);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], u8Boost);
+
+    // Same setting: no bus access
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 2, 1300, &bWritten), (int)Ok);
+    assertFalse(bWritten);
+    assertEqual((int)mockLogLen, 0);
+
+    // Boost time elapsed: taper
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 2, 1600, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], u8Taper);
+
+    // Full: off, charging restarts with a new boost period
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 4, 2000, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], 0);
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 2, 5000, &bWritten), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], u8Boost);
+
+    // One level below full: taper within the boost time
+    assertEqual((int)Amx8x5_TrickleService(&h, &p, 3, 5010, &bWritten), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_TRICKLE], u8Taper);
+}
+
+// ---------------------------------------------------------------------------
+// 23. Sleep orchestration
+// ---------------------------------------------------------------------------
+
+test(sleep_until_single_burst)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_time_t t;
+    uint32_t u32Deadline = 800000000UL;
+    Amx8x5_SecondsToTime(u32Deadline, &t);
+    mockSetSeconds(u32Deadline - 3600);
+    mockRegs[AMX8X5_REG_ALARM_SECONDS] = 0x80;               // GP14 kept
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_CB_MSK | AMX8X5_REG_STATUS_ALM_MSK;
+    mockRegs[AMX8X5_REG_INT_MASK] = 0xE0 | AMX8X5_REG_INT_MASK_TIE_MSK;
+    mockRegs[AMX8X5_REG_SLEEP_CTRL] = AMX8X5_REG_SLEEP_CTRL_EX1P_MSK;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Deadline, 1 << AMx8x5IrqEx1, 3, AMx8x5PswIrq2HighInSleep), (int)Ok);
+    // One read, one burst from the first changed register (hundredths stay 0)
+    // to TIMER_CTRL, SLEEP_CTRL last, one read back
+    assertEqual((int)mockReadCalls, 2);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_ALARM_SECONDS);
+    assertEqual((int)mockLogReg[1], AMX8X5_REG_SLEEP_CTRL);
+    assertEqual((int)mockLogVal[1], AMX8X5_REG_SLEEP_CTRL_SLP_MSK | AMX8X5_REG_SLEEP_CTRL_EX1P_MSK | 3);
+
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x80 | AMX8X5_DEC_TO_BCD(t.u8Second));
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], AMX8X5_DEC_TO_BCD(t.u8Hour));
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MONTH], AMX8X5_DEC_TO_BCD(t.u8Month));
+    assertEqual((int)mockRegs[AMX8X5_REG_STATUS], AMX8X5_REG_STATUS_CB_MSK);
+    assertEqual((int)mockRegs[AMX8X5_REG_INT_MASK], 0xE0 | AMX8X5_REG_INT_MASK_AIE_MSK | AMX8X5_REG_INT_MASK_EX1E_MSK);
+    assertEqual((int)(mockRegs[AMX8X5_REG_CONTROL_2] & AMX8X5_REG_CONTROL_2_OUT2S_MSK), AMx8x5Out2Sleep << AMX8X5_REG_CONTROL_2_OUT2S_POS);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmYear << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+}
+
+test(sleep_until_deadline_window_and_12_hour_mode)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    // 2024-02-29 11:00:00 PM in 12-hour mode
+    const uint32_t u32Now = 762480000UL + 23 * 3600UL;
+    mockSetSeconds(u32Now);
+    mockRegs[AMX8X5_REG_HUNDREDTHS + 3] = 0x20 | 0x11;
+    mockRegs[AMX8X5_REG_CONTROL_1] |= AMX8X5_REG_CONTROL_1_12_24_MSK;
+
+    // Past, now and more than the yearly alarm can tell apart: no write
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now - 1, 0, 0, AMx8x5nRstLowInSleep), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now, 0, 0, AMx8x5nRstLowInSleep), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now + AMX8X5_SWALARM_MAX_ARM + 1, 0, 0, AMx8x5nRstLowInSleep), (int)ErrorInvalidParameter);
+    assertEqual((int)mockLogLen, 0);
+
+    // 12:30:00 AM next day: hour 12 without PM bit
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now + 5400, 0, 0, AMx8x5nRstLowInSleep), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x30);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x12);
+
+    // 12:00:00 PM next day
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now + 13 * 3600UL, 0, 0, AMx8x5nRstLowInSleep), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x20 | 0x12);
+    assertEqual((int)Amx8x5_SleepUntil(&h, u32Now + AMX8X5_SWALARM_MAX_ARM, 0, 0, AMx8x5nRstLowInSleep), (int)Ok);
+}
+
+test(sleep_until_only_changed_span_and_no_source)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SleepUntil(&h, 0, 0, 0, AMx8x5nRstLowInSleep), (int)ErrorInvalidMode);
+    assertEqual((int)mockLogLen, 0);
+
+    // Only INT_MASK changes: single register burst
+    assertEqual((int)Amx8x5_SleepUntil(&h, 0, 1 << AMx8x5IrqEx2, 0, AMx8x5nRstLowInSleep), (int)Ok);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_INT_MASK);
+    assertEqual((int)mockLogVal[1], AMX8X5_REG_SLEEP_CTRL_SLP_MSK | AMX8X5_REG_SLEEP_CTRL_SLRES_MSK);
+}
+
+test(wake_reason_single_read)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_wake_reason_t r;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_BAT_MSK | AMX8X5_REG_STATUS_ALM_MSK;
+    mockRegs[AMX8X5_REG_SLEEP_CTRL] = AMX8X5_REG_SLEEP_CTRL_SLST_MSK;
+    mockReadCalls = 0;
+    assertEqual((int)Amx8x5_WakeReason(&h, &r), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)r.u8Sources, 1 << AMx8x5IrqAlarm);
+    assertTrue(r.bSlept);
+    assertTrue(r.bBattery);
+}
+
+// ---------------------------------------------------------------------------
+// 24. Power-fail recording
+// ---------------------------------------------------------------------------
+
+test(powerfail_record_single_burst_and_recover)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_powerfail_t pf;
+    stc_amx8x5_outage_t o;
+    uint8_t u8Window = (AMX8X5_RAM_POWERFAIL & 0x3F) | 0x40;
+
+    assertEqual((int)Amx8x5_PowerFailInit(&pf, AMX8X5_RAM_POWERFAIL), (int)Ok);
+    assertEqual((int)Amx8x5_PowerFailRecord(&h, &pf), (int)ErrorNotReady);
+
+    // Empty RAM is replaced by an empty record
+    assertEqual((int)Amx8x5_PowerFailRecover(&h, &pf, &o), (int)Ok);
+    assertFalse(o.bNew);
+    assertEqual((int)o.u16Count, 0);
+    assertEqual((int)Amx8x5_PowerFailArm(&h, &pf, AMx8x5BatReferenceFalling25V_Rising30V), (int)Ok);
+    assertTrue((mockRegs[AMX8X5_REG_INT_MASK] & AMX8X5_REG_INT_MASK_BLIE_MSK) != 0);
+
+    // Interrupt: one read of the time, bank select and one record burst
+    mockSetSeconds(700000000UL);
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_PowerFailRecord(&h, &pf), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_EXTENDED_ADDR);
+    assertEqual((int)mockLogReg[1], (int)u8Window);
+
+    // A bouncing supply is recorded once
+    assertEqual((int)Amx8x5_PowerFailRecord(&h, &pf), (int)Ok);
+    assertEqual((int)mockLogLen, 2);
+
+    // Power back after 5 minutes, MCU restarted
+    mockSetSeconds(700000300UL);
+    assertEqual((int)Amx8x5_PowerFailInit(&pf, AMX8X5_RAM_POWERFAIL), (int)Ok);
+    assertEqual((int)Amx8x5_PowerFailRecover(&h, &pf, &o), (int)Ok);
+    assertTrue(o.bNew);
+    assertEqual((uint32_t)o.u32Start, (uint32_t)700000000UL);
+    assertEqual((uint32_t)o.u32Duration, (uint32_t)300);
+    assertEqual((int)o.u16Count, 1);
+
+    // Closed outage is reported again, not as new
+    assertEqual((int)Amx8x5_PowerFailRecover(&h, &pf, &o), (int)Ok);
+    assertFalse(o.bNew);
+    assertEqual((uint32_t)o.u32Duration, (uint32_t)300);
+
+    // Corrupt record starts over
+    mockRegs[u8Window + 12] ^= 0x01;
+    assertEqual((int)Amx8x5_PowerFailRecover(&h, &pf, &o), (int)Ok);
+    assertEqual((int)o.u16Count, 0);
+    assertEqual((uint32_t)o.u32Start, (uint32_t)0);
+}
+
+// ---------------------------------------------------------------------------
+// 25. Heartbeat
+// ---------------------------------------------------------------------------
+
+test(heartbeat_rate_limited_and_shutdown_info)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_heartbeat_t hb;
+    stc_amx8x5_shutdown_info_t info;
+    uint8_t u8Window = (AMX8X5_RAM_HEARTBEAT & 0x3F) | 0x40;
+
+    assertEqual((int)Amx8x5_HeartbeatInit(&hb, AMX8X5_RAM_HEARTBEAT, 60), (int)Ok);
+    assertEqual((int)Amx8x5_HeartbeatService(&h, &hb, 100, NULL), (int)ErrorNotReady);
+
+    // First boot: no previous run
+    mockSetSeconds(600000000UL);
+    assertEqual((int)Amx8x5_LastShutdownInfo(&h, &hb, &info), (int)Ok);
+    assertFalse(info.bValid);
+
+    // Coalesced: no bus access within the interval, then one 5 byte burst
+    bool bWritten;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    for (uint32_t i = 1; i < 60; i++)
+    {
+        assertEqual((int)Amx8x5_HeartbeatService(&h, &hb, 600000000UL + i, &bWritten), (int)Ok);
+        assertFalse(bWritten);
+    }
+    assertEqual((int)mockLogLen, 0);
+    assertEqual((int)Amx8x5_HeartbeatService(&h, &hb, 600000060UL, &bWritten), (int)Ok);
+    assertTrue(bWritten);
+    assertEqual((int)mockReadCalls, 0);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_EXTENDED_ADDR);
+    assertEqual((int)mockLogReg[1], u8Window + 4);
+    assertEqual((int)Amx8x5_HeartbeatService(&h, &hb, 600003600UL, NULL), (int)Ok);
+
+    // Reboot two hours later
+    mockSetSeconds(600010800UL);
+    assertEqual((int)Amx8x5_HeartbeatInit(&hb, AMX8X5_RAM_HEARTBEAT, 60), (int)Ok);
+    assertEqual((int)Amx8x5_LastShutdownInfo(&h, &hb, &info), (int)Ok);
+    assertTrue(info.bValid);
+    assertEqual((uint32_t)info.u32Boot, (uint32_t)600000000UL);
+    assertEqual((uint32_t)info.u32Uptime, (uint32_t)3600);
+    assertEqual((uint32_t)info.u32Downtime, (uint32_t)7200);
+
+    // New run started at the reboot
+    assertEqual((int)Amx8x5_LastShutdownInfo(&h, &hb, &info), (int)Ok);
+    assertTrue(info.bValid);
+    assertEqual((uint32_t)info.u32Uptime, (uint32_t)0);
+    assertEqual((uint32_t)info.u32Downtime, (uint32_t)0);
+}
+
+// ---------------------------------------------------------------------------
+// 26. Watchdog
+// ---------------------------------------------------------------------------
+
+// SetWatchdog cleared the bits of the new value in WDT instead of writing it
+test(set_watchdog_writes_wdt)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    assertEqual((int)Amx8x5_SetWatchdog(&h, 2000, AMx8x5WatchdogInterruptPinnRST), (int)Ok);
+    // 4 Hz, 8 cycles, reset
+    assertEqual((int)mockRegs[AMX8X5_REG_WDT], AMX8X5_REG_WDT_WDS_MSK | (8 << AMX8X5_REG_WDT_BMB_POS) | 1);
+}
+
+test(watchdog_kick_single_byte_write)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_watchdog_t w;
+    assertEqual((int)Amx8x5_WatchdogPrepare(&h, &w, 10, AMx8x5WatchdogInterruptPinnRST), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_WatchdogPrepare(&h, &w, 2000, AMx8x5WatchdogInterruptPinDisable), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_WatchdogPrepare(&h, &w, 1000000, AMx8x5WatchdogInterruptPinFOUTnIRQ), (int)Ok);
+    // Clamped to the longest period: 1/4 Hz, 31 cycles
+    assertEqual((int)mockRegs[AMX8X5_REG_WDT], (31 << AMX8X5_REG_WDT_BMB_POS) | 3);
+
+    assertEqual((int)Amx8x5_WatchdogPrepare(&h, &w, 2000, AMx8x5WatchdogInterruptPinnRST), (int)Ok);
+    mockRegs[AMX8X5_REG_WDT] = 0;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_WatchdogKick(&h, &w), (int)Ok);
+    assertEqual((int)mockReadCalls, 0);
+    assertEqual((int)mockLogLen, 1);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_WDT);
+    assertEqual((int)mockRegs[AMX8X5_REG_WDT], AMX8X5_REG_WDT_WDS_MSK | (8 << AMX8X5_REG_WDT_BMB_POS) | 1);
+}
+
+test(task_watchdog_kicks_while_alive_and_records_culprit)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_taskwdt_t tw;
+    uint8_t u8Culprit;
+    uint8_t u8Window = (AMX8X5_RAM_TASKWDT & 0x3F) | 0x40;
+
+    fakeMicrosNow = 0;
+    fakeMicrosStep = 0;
+    assertEqual((int)Amx8x5_TaskWdtInit(&tw, AMX8X5_RAM_TASKWDT, fakeMicros), (int)Ok);
+    assertEqual((int)Amx8x5_TaskWdtRegister(&tw, 0, 100), (int)Ok);
+    assertEqual((int)Amx8x5_TaskWdtRegister(&tw, 3, 1000), (int)Ok);
+    assertEqual((int)Amx8x5_TaskWdtRegister(&tw, AMX8X5_TASKWDT_MAX, 1000), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_TaskWdtStart(&h, &tw, 2000, 500), (int)Ok);
+
+    // Fast task checks in every 50, slow task every 900: kick every 500 only
+    uint32_t u32Kicks = 0;
+    for (fakeMicrosNow = 50; fakeMicrosNow <= 3000; fakeMicrosNow += 50)
+    {
+        Amx8x5_TaskWdtCheckIn(&tw, 0);
+        if ((fakeMicrosNow % 900) == 0) Amx8x5_TaskWdtCheckIn(&tw, 3);
+        mockLogLen = 0;
+        assertEqual((int)Amx8x5_TaskWdtService(&h, &tw, &u8Culprit), (int)Ok);
+        assertEqual((int)u8Culprit, AMX8X5_TASKWDT_NONE);
+        if (mockLogLen != 0)
+        {
+            assertEqual((int)mockLogLen, 1);
+            assertEqual((int)mockLogReg[0], AMX8X5_REG_WDT);
+            u32Kicks++;
+        }
+    }
+    assertEqual((int)u32Kicks, 6);
+
+    // Slow task starves: culprit recorded once, no further kicks
+    fakeMicrosNow = 3000 + 1001;
+    Amx8x5_TaskWdtCheckIn(&tw, 0);
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_TaskWdtService(&h, &tw, &u8Culprit), (int)Ok);
+    assertEqual((int)u8Culprit, 3);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[1], u8Window);
+    fakeMicrosNow += 1000;
+    Amx8x5_TaskWdtCheckIn(&tw, 3);
+    assertEqual((int)Amx8x5_TaskWdtService(&h, &tw, &u8Culprit), (int)Ok);
+    assertEqual((int)mockLogLen, 2);
+
+    // After the reset
+    assertEqual((int)Amx8x5_TaskWdtCulprit(&h, AMX8X5_RAM_TASKWDT, &u8Culprit), (int)Ok);
+    assertEqual((int)u8Culprit, 3);
+    assertEqual((int)Amx8x5_TaskWdtCulprit(&h, AMX8X5_RAM_TASKWDT, &u8Culprit), (int)Ok);
+    assertEqual((int)u8Culprit, AMX8X5_TASKWDT_NONE);
+}
+
+// ---------------------------------------------------------------------------
+// 27. Sub-second alarms
+// ---------------------------------------------------------------------------
+
+test(subsecond_alarm_hardware_patterns)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_subsecond_alarm_t a;
+    bool bRearmed;
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x37;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x12;
+
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, 0, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, AMX8X5_SUBSECOND_MAX + 1, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)ErrorInvalidParameter);
+
+    // Every hundredth
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, 1, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0xFF);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmSecond << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+
+    // Every tenth, on the digit of the first match (.47)
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, 10, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0xF7);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmSecond << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+
+    // Every second at .37
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, 100, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x37);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmSecond << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+
+    // Repeated by the RTC: no bus access
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertFalse(bRearmed);
+    assertEqual((int)mockReadCalls, 0);
+    assertEqual((int)mockLogLen, 0);
+}
+
+test(subsecond_alarm_software_rearm_single_burst)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_subsecond_alarm_t a;
+    bool bRearmed;
+
+    // 59.90 + 0.25 wraps to 00.15, matched once per minute
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x90;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x59;
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, 25, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x15);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x00);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmMinute << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+
+    // Serviced before the match: read only
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x95;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x59;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertFalse(bRearmed);
+    assertEqual((int)mockLogLen, 0);
+
+    // Right after the match: one read, one burst
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x16;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x00;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertTrue(bRearmed);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 1);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_ALARM_HUNDRS);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x40);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x00);
+
+    // Late by more than a period: missed matches skipped, grid kept
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x00;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x01;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x15);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x01);
+
+    // Next match closer than the guard: one more period
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x39;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x65);
+
+    // Above half a minute a late call would look like one before the match
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, AMX8X5_SUBSECOND_SOFTWARE_MAX + 1, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)ErrorInvalidParameter);
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, AMX8X5_SUBSECOND_MAX - 1, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)ErrorInvalidParameter);
+
+    // 30 s period from 01.39: match at 31.39, serviced 29.90 s late
+    assertEqual((int)Amx8x5_SubSecondAlarmStart(&h, &a, AMX8X5_SUBSECOND_SOFTWARE_MAX, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x31);
+    mockRegs[AMX8X5_REG_HUNDREDTHS] = 0x29;
+    mockRegs[AMX8X5_REG_SECONDS] = 0x01;
+    assertEqual((int)Amx8x5_SubSecondAlarmService(&h, &a, &bRearmed), (int)Ok);
+    assertTrue(bRearmed);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HUNDRS], 0x39);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x01);
+}
+
+// ---------------------------------------------------------------------------
+// 28. Alarm rearm
+// ---------------------------------------------------------------------------
+
+// SetAlarm rejected the level interrupt mode and the internal pin
+test(set_alarm_level_mode_internal_pin)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_time_t t;
+    memset(&t, 0, sizeof(t));
+    t.u8Second = 30;
+    t.u8Mode = AMX8X5_24HR_MODE;
+    mockRegs[AMX8X5_REG_INT_MASK] = 0x60;
+    assertEqual((int)Amx8x5_SetAlarm(&h, &t, AMx8x5AlarmMinute, AMx8x5InterruptModeLevel, AMx8x5InterruptPinInternal), (int)Ok);
+    assertEqual((int)(mockRegs[AMX8X5_REG_INT_MASK] & AMX8X5_REG_INT_MASK_IM_MSK), 0);
+    assertTrue((mockRegs[AMX8X5_REG_INT_MASK] & AMX8X5_REG_INT_MASK_AIE_MSK) != 0);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_SECONDS], 0x30);
+}
+
+test(alarm_rearm_single_burst_and_change_detection)
+{
+    stc_amx8x5_handle_t h = initedHandle();
+    stc_amx8x5_alarm_config_t c;
+    stc_amx8x5_time_t t;
+    memset(&t, 0, sizeof(t));
+    t.u8Second = 10;
+    t.u8Minute = 5;
+    t.u8Hour = 7;
+    t.u8Mode = AMX8X5_24HR_MODE;
+
+    assertEqual((int)Amx8x5_AlarmInit(&c), (int)Ok);
+    assertEqual((int)Amx8x5_AlarmRearm(&h, &c, &t, AMx8x5AlarmDay, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertTrue(c.bValid);
+    assertEqual((int)(mockRegs[AMX8X5_REG_TIMER_CTRL] & AMX8X5_REG_TIMER_CTRL_RPT_MSK), AMx8x5AlarmDay << AMX8X5_REG_TIMER_CTRL_RPT_POS);
+
+    // Only the time changed: ALM cleared, alarm registers in one burst
+    t.u8Minute = 6;
+    mockRegs[AMX8X5_REG_STATUS] = AMX8X5_REG_STATUS_CB_MSK | AMX8X5_REG_STATUS_ALM_MSK;
+    mockReadCalls = 0;
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_AlarmRearm(&h, &c, &t, AMx8x5AlarmDay, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq), (int)Ok);
+    assertEqual((int)mockReadCalls, 1);
+    assertEqual((int)mockLogLen, 2);
+    assertEqual((int)mockLogReg[0], AMX8X5_REG_STATUS);
+    assertEqual((int)mockLogReg[1], AMX8X5_REG_ALARM_HUNDRS);
+    assertEqual((int)mockRegs[AMX8X5_REG_STATUS], AMX8X5_REG_STATUS_CB_MSK);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_MINUTES], 0x06);
+    assertEqual((int)mockRegs[AMX8X5_REG_ALARM_HOURS], 0x07);
+
+    // Pin changed: full SetAlarm
+    mockLogLen = 0;
+    assertEqual((int)Amx8x5_AlarmRearm(&h, &c, &t, AMx8x5AlarmDay, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq2), (int)Ok);
+    assertTrue(mockLogLen > 2);
+    assertEqual((int)c.enModePin, (int)AMx8x5InterruptIrq2);
+
+    // Disabled is not remembered
+    assertEqual((int)Amx8x5_AlarmRearm(&h, &c, &t, AMx8x5AlarmDisabled, AMx8x5InterruptModePulseShort, AMx8x5InterruptIrq2), (int)Ok);
+    assertFalse(c.bValid);
+}
+
 // ---------------------------------------------------------------------------
 // Arduino entry points
 // ---------------------------------------------------------------------------